@@ -165,6 +165,16 @@ var opts = {
 		default: null,
 		map: 'numThreads'
 	},
+	'hybrid': {
+		type: 'enum',
+		enum: ['auto','on','off'],
+		map: 'cpuHybridSplit',
+		default: 'auto',
+		fn: function(v) {
+			v = v.toLowerCase();
+			return v == 'auto' ? v : v == 'on';
+		}
+	},
 	'min-chunk-size': {
 		type: 'size0',
 		map: 'minChunkSize'
@@ -177,6 +187,20 @@ var opts = {
 		type: 'int',
 		map: 'chunkReadThreads'
 	},
+	'read-method': {
+		type: 'enum',
+		enum: ['auto','pread','io_uring','mmap','node'],
+		map: 'readMethod'
+	},
+	'read-direct': {
+		type: 'bool',
+		map: 'readDirect'
+	},
+	'write-method': {
+		type: 'enum',
+		enum: ['auto','pwrite','io_uring','node'],
+		map: 'writeMethod'
+	},
 	'read-buffers': {
 		type: 'int',
 		map: 'readBuffers'
@@ -237,9 +261,34 @@ var opts = {
 	'opencl-grouping': {
 		type: 'int'
 	},
+	'opencl-workgroup': {
+		type: 'int'
+	},
+	'opencl-tune': {
+		type: 'string',
+		ifSetDefault: 'true'
+	},
 	'opencl-minchunk': {
 		type: 'size0'
 	},
+	'opencl-recovery': {
+		type: 'int'
+	},
+	'opencl-max-alloc': {
+		type: 'size0'
+	},
+	'opencl-zero-copy': {
+		type: 'string',
+		ifSetDefault: 'true'
+	},
+	'opencl-cache': {
+		type: 'string',
+		map: 'openclCacheDir'
+	},
+	'opencl-trace': {
+		type: 'string',
+		map: 'openclTrace'
+	},
 	'opencl-list': {
 		type: 'string',
 		ifSetDefault: 'gpu'
@@ -269,6 +318,9 @@ var opts = {
 		type: 'string',
 		default: 'utf8'
 	},
+	'stream-name': {
+		type: 'string'
+	},
 	'help': {
 		alias: '?',
 		type: 'bool'
@@ -482,6 +534,10 @@ var inputFiles = argv._;
 	} else cb();
 })(function() {
 	if(!inputFiles.length) error('At least one input file must be supplied');
+	// a lone `-` streams the input data from stdin
+	var streamInput = inputFiles.length == 1 && inputFiles[0] == '-';
+	if(streamInput && !argv['stream-name'])
+		error('A file name for the data read from stdin must be given via `--stream-name`');
 
 	var ppo = {
 		outputBase: argv.out,
@@ -611,7 +667,9 @@ var inputFiles = argv._;
 	var openclDevicesSelected = {}; // used to try distinguish multiple devices of the same name
 	var openclMap = function(data) {
 		var ret = {};
-		if(data.process) {
+		if(data.process == 'dynamic') {
+			ret.dynamic = true;
+		} else if(data.process) {
 			ret.ratio = parseFloat(data.process);
 			if(data.process.substr(-1) == '%')
 				ret.ratio /= 100;
@@ -655,8 +713,18 @@ var inputFiles = argv._;
 			ret.target_iters = data['iter-count']|0;
 		if(data['grouping'])
 			ret.target_grouping = data['grouping']|0;
+		if(data.workgroup)
+			ret.target_workgroup = data.workgroup|0;
+		if(data.tune && !/^(0|false|no)$/i.test(data.tune))
+			ret.tune = (data.tune.toLowerCase() == 'force') ? 'force' : true;
 		if(data.minchunk)
 			ret.minChunkSize = arg_parser.parseSize(data.minchunk);
+		if(data.recovery)
+			ret.recovery = data.recovery|0;
+		if(data['max-alloc'])
+			ret.max_alloc = typeof data['max-alloc'] == 'number' ? data['max-alloc'] : arg_parser.parseSize(data['max-alloc']);
+		if(data['zero-copy'] && !/^(0|false|no)$/i.test(data['zero-copy']))
+			ret.zero_copy = true;
 		
 		return ret;
 	};
@@ -675,7 +743,7 @@ var inputFiles = argv._;
 			});
 			return require('../lib/par2.js')._extend({}, openclOpts, openclMap(opts));
 		});
-	} else if('ratio' in openclOpts) {
+	} else if('ratio' in openclOpts || openclOpts.dynamic || openclOpts.recovery) {
 		ppo.openclDevices = [openclOpts];
 	}
 	
@@ -688,7 +756,9 @@ var inputFiles = argv._;
 
 	// TODO: sigint not respected?
 
-	ParPar.fileInfo(inputFiles, argv.recurse, argv['skip-symlinks'], function(err, info) {
+	(streamInput ? function(cb) {
+		cb(null, [{displayName: argv['stream-name']}]);
+	} : ParPar.fileInfo.bind(ParPar, inputFiles, argv.recurse, argv['skip-symlinks']))(function(err, info) {
 		if(!err && info.length == 0)
 			err = 'No input files found.';
 		if(err) {
@@ -698,7 +768,10 @@ var inputFiles = argv._;
 		
 		var g;
 		try {
-			g = new ParPar.PAR2Gen(info, inputSliceCount, ppo);
+			if(streamInput)
+				g = new ParPar.PAR2GenStream(process.stdin, argv['stream-name'], inputSliceCount, ppo);
+			else
+				g = new ParPar.PAR2Gen(info, inputSliceCount, ppo);
 		} catch(x) {
 			error(x.message);
 		}
@@ -751,7 +824,10 @@ var inputFiles = argv._;
 					process.stderr.write(cliFormat('33', 'Warning') + ': selected slice size (' + friendlySize(g.opts.sliceSize) + ') may be too large to be compatible with QuickPar\n');
 				}
 				
-				process.stderr.write('Input data        : ' + sizeDisp(g.totalSize) + ' (' + pluralDisp(g.inputSlices, 'slice') + ' from ' + pluralDisp(info.length, 'file') + ')\n');
+				if(streamInput)
+					process.stderr.write('Input data        : streamed from stdin\n');
+				else
+					process.stderr.write('Input data        : ' + sizeDisp(g.totalSize) + ' (' + pluralDisp(g.inputSlices, 'slice') + ' from ' + pluralDisp(info.length, 'file') + ')\n');
 				if(g.opts.recoverySlices) {
 					process.stderr.write('Recovery data     : ' + sizeDisp(g.opts.recoverySlices*g.opts.sliceSize) + ' (' + pluralDisp(g.opts.recoverySlices, '* ' + sizeDisp(g.opts.sliceSize) + ' slice') + ')\n');
 					process.stderr.write('Input pass(es)    : ' + cliFormat('1', g.chunks * g.passes) + ', processing ' + pluralDisp(g.slicesPerPass, '* ' + sizeDisp(g._chunkSize) + ' chunk') + ' per pass\n');
@@ -759,7 +835,7 @@ var inputFiles = argv._;
 				process.stderr.write('Read buffer size  : ' + sizeDisp(g.readSize) + ' * max ' + pluralDisp(g.opts.readBuffers, 'buffer') + '\n');
 			}
 		}
-		if(argv.progress != 'none') {
+		if(argv.progress != 'none' && !streamInput) { // total can't be known when streaming
 			// progress is based off:
 			// - the number of input slices and how many passes we need to go over them
 			// - the number of output slices and how many times they need to be written to; as this is expected to be faster than main processing, scale it down
@@ -807,6 +883,20 @@ var inputFiles = argv._;
 							},
 							opencl: []
 						};
+						if(process_info.cpu_backends) {
+							// slice_size and batches above are totals; these give the split
+							info.cpu.backends = process_info.cpu_backends.map(function(cpuBe) {
+								return {
+									threads: cpuBe.threads,
+									method: cpuBe.method_desc,
+									tile_size: cpuBe.chunk_size,
+									batch_slices: cpuBe.staging_size,
+									batches: cpuBe.staging_count,
+									slice_size: cpuBe.slice_mem,
+									cpus: cpuBe.cpus
+								};
+							});
+						}
 						if(process_info.opencl_devices) process_info.opencl_devices.forEach(function(oclDev) {
 							info.opencl.push({
 								device_name: oclDev.device_name.trim(),
@@ -817,6 +907,10 @@ var inputFiles = argv._;
 								batches: oclDev.staging_count,
 								slice_size: oclDev.slice_mem,
 								recovery_slices: oclDev.num_output_slices,
+								zero_copy: oclDev.zero_copy,
+								output_buffers: oclDev.output_buffers,
+								kernel_build_time: oclDev.kernel_build_time,
+								kernel_cached: oclDev.kernel_cached,
 							});
 						});
 						print_json('compute_info', info);
@@ -825,8 +919,17 @@ var inputFiles = argv._;
 							var cpuName = require('os').cpus()[0].model.trim();
 							if(cpuName == 'unknown') cpuName = 'CPU';
 							process.stderr.write('\n' + cliFormat('4', cpuName) + '\n')
-							process.stderr.write('  Multiply method : ' + cliFormat('1', process_info.method_desc) + ' with ' + sizeDisp(process_info.chunk_size) + ' loop tiling, ' + pluralDisp(process_info.threads, 'thread') + '\n');
-							process.stderr.write('  Input batching  : ' + pluralDisp(process_info.staging_size, 'chunk') + ', ' + pluralDisp(process_info.staging_count, 'batch', 'es') + '\n');
+							if(process_info.cpu_backends) process_info.cpu_backends.forEach(function(cpuBe) {
+								process.stderr.write('  Multiply method : ' + cliFormat('1', cpuBe.method_desc) + ' with ' + sizeDisp(cpuBe.chunk_size) + ' loop tiling, ' + pluralDisp(cpuBe.threads, 'thread') + (cpuBe.cpus ? ' on CPUs ' + cpuBe.cpus.join(',') : '') + '\n');
+							});
+							else
+								process.stderr.write('  Multiply method : ' + cliFormat('1', process_info.method_desc) + ' with ' + sizeDisp(process_info.chunk_size) + ' loop tiling, ' + pluralDisp(process_info.threads, 'thread') + '\n');
+							if(process_info.cpu_backends)
+								process.stderr.write('  Input batching  : ' + process_info.cpu_backends.map(function(cpuBe) {
+									return pluralDisp(cpuBe.staging_size, 'chunk') + ', ' + pluralDisp(cpuBe.staging_count, 'batch', 'es');
+								}).join('; ') + '\n');
+							else
+								process.stderr.write('  Input batching  : ' + pluralDisp(process_info.staging_size, 'chunk') + ', ' + pluralDisp(process_info.staging_count, 'batch', 'es') + '\n');
 							var transMem = Math.max(g.opts.recDataSize * g._chunkSize, process_info.slice_mem * g.procInStagingBufferCount);
 							process.stderr.write('  Memory Usage    : ' + sizeDisp(process_info.slice_mem * process_info.num_output_slices + transMem) + ' (' + pluralDisp(process_info.num_output_slices, '* ' + sizeDisp(process_info.slice_mem) + ' chunk') + ' + ' + sizeDisp(transMem) + ' transfer buffer)\n');
 						} else {
@@ -837,7 +940,7 @@ var inputFiles = argv._;
 							process.stderr.write('\n' + cliFormat('4', oclDev.device_name.trim()) + '\n')
 							process.stderr.write('  Multiply method : ' + cliFormat('1', oclDev.method_desc) + ', split into ' + cliFormat('1', oclDev.output_chunks) + ' * ' + sizeDisp(oclDev.chunk_size) + ' workgroups\n');
 							process.stderr.write('  Input batching  : ' + pluralDisp(oclDev.staging_size, 'chunk') + ', ' + pluralDisp(oclDev.staging_count, 'batch', 'es') + '\n');
-							process.stderr.write('  Memory Usage    : ' + sizeDisp(oclDev.slice_mem * oclDev.num_output_slices) + ' (' + pluralDisp(oclDev.num_output_slices, '* ' + sizeDisp(oclDev.slice_mem) + ' chunk') + ')\n');
+							process.stderr.write('  Memory Usage    : ' + sizeDisp(oclDev.slice_mem * oclDev.num_output_slices) + ' (' + pluralDisp(oclDev.num_output_slices, '* ' + sizeDisp(oclDev.slice_mem) + ' chunk') + (oclDev.output_buffers > 1 ? ', split across ' + oclDev.output_buffers + ' buffers' : '') + (oclDev.zero_copy ? ', shared with host' : '') + ')\n');
 						});
 						process.stderr.write('\n');
 					}
@@ -874,8 +977,16 @@ var inputFiles = argv._;
 			if(argv.json) {
 				if(event == 'begin_chunk_pass')
 					print_json('begin_subpass', {pass: arg1, subpass: arg2});
-				if(event == 'chunk_pass_complete')
-					print_json('end_subpass', {pass: arg1, subpass: arg2});
+				if(event == 'chunk_pass_complete') {
+					var subpassInfo = {pass: arg1, subpass: arg2};
+					var gfInfo = g.gf_info();
+					if(gfInfo && 'code_cache_hits' in gfInfo) {
+						// totals since processing started
+						subpassInfo.code_cache_hits = gfInfo.code_cache_hits;
+						subpassInfo.code_cache_misses = gfInfo.code_cache_misses;
+					}
+					print_json('end_subpass', subpassInfo);
+				}
 				if(event == 'chunk_pass_write')
 					print_json('subpass_write', {pass: arg1, subpass: arg2});
 				if(event == 'pass_write')
@@ -886,7 +997,13 @@ var inputFiles = argv._;
 					print_json('closing_files', {});
 			}
 		}, function(err) {
-			if(err) throw err;
+			if(err) {
+				if(progressInterval) clearInterval(progressInterval);
+				// nothing being piped in is a usage problem, rather than a failure
+				if(streamInput && !g.totalSize)
+					error(err.message);
+				throw err;
+			}
 			
 			if(argv.progress != 'none') {
 				if(progressInterval) clearInterval(progressInterval);
@@ -898,8 +1015,11 @@ var inputFiles = argv._;
 				var timeTaken = ((endTime - startTime)/1000);
 				if(argv.json)
 					print_json('process_complete', {duration_seconds: timeTaken});
-				else
+				else {
+					if(streamInput)
+						process.stderr.write('\nInput data        : ' + sizeDisp(g.totalSize) + ' (' + pluralDisp(g.inputSlices, 'slice') + ')');
 					process.stderr.write('\nProcessing time   : ' + cliFormat('1', timeTaken + ' s') + '\n');
+				}
 			}
 		});
 		
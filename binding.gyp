@@ -36,10 +36,10 @@
     {
       "target_name": "parpar_gf",
       "dependencies": [
-        "parpar_gf_c", "gf16", "gf16_generic", "gf16_sse2", "gf16_ssse3", "gf16_avx", "gf16_avx2", "gf16_avx512", "gf16_vbmi", "gf16_gfni", "gf16_gfni_avx2", "gf16_gfni_avx512", "gf16_neon", "gf16_sve", "gf16_sve2",
+        "parpar_gf_c", "gf16", "gf16_generic", "gf16_sse2", "gf16_ssse3", "gf16_avx", "gf16_avx2", "gf16_avx512", "gf16_vbmi", "gf16_gfni", "gf16_gfni_avx2", "gf16_gfni_avx512", "gf16_clmul_avx2", "gf16_clmul_avx512", "gf16_neon", "gf16_sve", "gf16_sve2", "gf16_vec",
         "hasher", "hasher_sse2", "hasher_clmul", "hasher_xop", "hasher_bmi1", "hasher_avx2", "hasher_avx512", "hasher_avx512vl", "hasher_armcrc", "hasher_neon", "hasher_neoncrc", "hasher_sve2"
       ],
-      "sources": ["src/gf.cc", "gf16/controller.cpp", "gf16/controller_cpu.cpp", "gf16/controller_ocl.cpp", "gf16/controller_ocl_init.cpp"],
+      "sources": ["src/gf.cc", "src/file_reader.cpp", "gf16/controller.cpp", "gf16/controller_cpu.cpp", "gf16/controller_ocl.cpp", "gf16/controller_ocl_init.cpp", "gf16/controller_ocl_tune.cpp"],
       "include_dirs": ["gf16", "gf16/opencl-include"],
       "cflags!": ["-fno-exceptions"],
       "cxxflags!": ["-fno-exceptions"],
@@ -454,6 +454,35 @@
       "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
       "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}}
     },
+    {
+      "target_name": "gf16_vec",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_shuffle_vec.c"
+      ],
+      "cflags": ["-Wno-unused-function", "-std=gnu99"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch=="riscv64" and OS!="win"', {
+          "variables": {"supports_rvv%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_shuffle_vec.c -march=rv64gcv 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_rvv!=""', {
+              "cflags!": ["-march=native"],
+              "cflags": ["-march=rv64gcv"]
+            }]
+          ]
+        }],
+        ['target_arch in "ppc ppc64" and OS!="win"', {
+          "cflags": ["-mvsx"]
+        }]
+      ]
+    },
     {
       "target_name": "gf16_sse2",
       "type": "static_library",
@@ -515,7 +544,8 @@
       "type": "static_library",
       "defines": ["NDEBUG"],
       "sources": [
-        "gf16/gf16_shuffle_avx.c"
+        "gf16/gf16_shuffle_avx.c",
+        "gf16/gf16_xor_avx.c"
       ],
       "cflags": ["-Wno-unused-function", "-std=gnu99"],
       "xcode_settings": {
@@ -761,6 +791,74 @@
         }]
       ]
     },
+    {
+      "target_name": "gf16_clmul_avx2",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_clmul_avx2.c"
+      ],
+      "cflags": ["-Wno-unused-function", "-std=gnu99"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_vpclmul_avx2%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_clmul_avx2.c -mvpclmulqdq -mavx2 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_vpclmul_avx2!=""', {
+              "cflags": ["-mvpclmulqdq", "-mavx2"],
+              "cxxflags": ["-mvpclmulqdq", "-mavx2"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mvpclmulqdq", "-mavx2"],
+                "OTHER_CXXFLAGS": ["-mvpclmulqdq", "-mavx2"],
+              }
+            }]
+          ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {"VCCLCompilerTool": {"EnableEnhancedInstructionSet": "3"}}
+        }]
+      ]
+    },
+    {
+      "target_name": "gf16_clmul_avx512",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_clmul_avx512.c"
+      ],
+      "cflags": ["-Wno-unused-function", "-std=gnu99"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_vpclmul_avx512%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_clmul_avx512.c -mvpclmulqdq -mavx512vl -mavx512bw 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_vpclmul_avx512!=""', {
+              "cflags": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              "cxxflags": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+                "OTHER_CXXFLAGS": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              }
+            }]
+          ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {
+            "VCCLCompilerTool": {"AdditionalOptions": ["/arch:AVX512"], "EnableEnhancedInstructionSet": "0"}
+          }
+        }]
+      ]
+    },
     {
       "target_name": "gf16_neon",
       "type": "static_library",
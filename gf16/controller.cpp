@@ -18,6 +18,7 @@ bool PAR2Proc::init(size_t sliceSize, const std::vector<struct PAR2ProcBackendAl
 	hasAdded = false;
 	
 	currentSliceSize = sliceSize;
+	numRecoverySlices = 0;
 	
 	// TODO: better distribution
 	backends.resize(_backends.size());
@@ -27,6 +28,10 @@ bool PAR2Proc::init(size_t sliceSize, const std::vector<struct PAR2ProcBackendAl
 		backend.currentSliceSize = size;
 		backend.allocSliceSize = size;
 		backend.currentOffset = _backends[i].offset;
+		backend.allocRecOffset = _backends[i].recOffset;
+		backend.allocRecCount = _backends[i].recCount;
+		backend.recOffset = backend.allocRecOffset;
+		backend.recCount = 0;
 		backend.be = _backends[i].be;
 		backend.be->setSliceSize(size);
 		
@@ -40,18 +45,70 @@ bool PAR2Proc::init(size_t sliceSize, const std::vector<struct PAR2ProcBackendAl
 }
 
 bool PAR2Proc::checkBackendAllocation() {
-	// check ranges of backends (could maybe make this more optimal with a heap, but I expect few devices, so good enough for now)
-	// determine if we're covering the full slice, and whether there are overlaps (overlap = dynamic scheduling)
-	size_t start = backends[0].currentOffset, end = backends[0].currentOffset+backends[0].currentSliceSize;
+	// group up backends with identical ranges; these share the work dynamically
+	backendGroups.clear();
+	for(unsigned i=0; i<backends.size(); i++) {
+		const auto& backend = backends[i];
+		bool grouped = false;
+		if(backend.currentSliceSize) for(auto& group : backendGroups) {
+			const auto& leader = backends[group[0]];
+			if(leader.currentOffset == backend.currentOffset && leader.currentSliceSize == backend.currentSliceSize
+			&& leader.allocRecOffset == backend.allocRecOffset && leader.allocRecCount == backend.allocRecCount) {
+				group.push_back(i);
+				grouped = true;
+				break;
+			}
+		}
+		if(!grouped) backendGroups.push_back({i});
+	}
+	
+	// partition groups by the recovery they compute
+	recoveryPartitions.clear();
+	for(unsigned i=0; i<backendGroups.size(); i++) {
+		const auto& backend = backends[backendGroups[i][0]];
+		bool found = false;
+		for(auto& partition : recoveryPartitions) {
+			const auto& leader = backends[backendGroups[partition[0]][0]];
+			if(leader.allocRecOffset == backend.allocRecOffset && leader.allocRecCount == backend.allocRecCount) {
+				partition.push_back(i);
+				found = true;
+				break;
+			}
+		}
+		if(!found) recoveryPartitions.push_back({i});
+	}
+	std::sort(recoveryPartitions.begin(), recoveryPartitions.end(), [this](const std::vector<unsigned>& a, const std::vector<unsigned>& b) {
+		return backends[backendGroups[a[0]][0]].allocRecOffset < backends[backendGroups[b[0]][0]].allocRecOffset;
+	});
+	
+	// partitions must be contiguous from the first recovery slice, and only the last can be open-ended
+	unsigned recEnd = 0;
+	for(unsigned i=0; i<recoveryPartitions.size(); i++) {
+		const auto& leader = backends[backendGroups[recoveryPartitions[i][0]][0]];
+		if(leader.allocRecOffset != recEnd) return false;
+		if(leader.allocRecCount == 0 && i+1 != recoveryPartitions.size()) return false;
+		recEnd += leader.allocRecCount;
+	}
+	
+	for(const auto& partition : recoveryPartitions)
+		if(!checkSliceCoverage(partition)) return false;
+	return true;
+}
+
+bool PAR2Proc::checkSliceCoverage(const std::vector<unsigned>& groups) const {
+	// check ranges of groups (could maybe make this more optimal with a heap, but I expect few devices, so good enough for now)
+	// determine if we're covering the full slice, and whether there are overlaps
+	const auto& first = backends[backendGroups[groups[0]][0]];
+	size_t start = first.currentOffset, end = first.currentOffset+first.currentSliceSize;
 	bool hasOverlap = false;
-	std::vector<bool> beChecked(backends.size());
-	int beUnchecked = backends.size()-1;
+	std::vector<bool> beChecked(groups.size());
+	int beUnchecked = groups.size()-1;
 	beChecked[0] = true;
 	while(beUnchecked) {
 		bool beFound = false;
-		for(unsigned i=1; i<backends.size(); i++) {
+		for(unsigned i=1; i<groups.size(); i++) {
 			if(beChecked[i]) continue;
-			const auto& backend = backends[i];
+			const auto& backend = backends[backendGroups[groups[i]][0]];
 			size_t currentEnd = backend.currentOffset + backend.currentSliceSize;
 			if(backend.currentOffset <= start && currentEnd >= start) {
 				if(currentEnd > start) hasOverlap = true;
@@ -79,10 +136,23 @@ bool PAR2Proc::checkBackendAllocation() {
 		}
 		if(!beFound) return false;
 	}
-	if(hasOverlap) return false; // TODO: eventually support overlapping
+	if(hasOverlap) return false; // partially overlapping ranges aren't supported; backends sharing work must have identical ranges
 	return (start == 0 && end == currentSliceSize); // fail if backends don't cover the entire slice
 }
 
+// pick the member of a group to send the next input to: prefer an idle backend, otherwise any which can still accept input
+IPAR2ProcBackend* PAR2Proc::selectBackend(const std::vector<unsigned>& group) const {
+	IPAR2ProcBackend* target = nullptr;
+	for(unsigned idx : group) {
+		auto state = backends[idx].be->canAdd();
+		if(state == PROC_ADD_OK)
+			return backends[idx].be;
+		if(state == PROC_ADD_OK_BUSY && !target)
+			target = backends[idx].be;
+	}
+	return target;
+}
+
 // this just reduces the size without resizing backends; TODO: this should be removed
 bool PAR2Proc::setCurrentSliceSize(size_t newSliceSize) {
 	if(backends.size() == 1) {
@@ -96,20 +166,29 @@ bool PAR2Proc::setCurrentSliceSize(size_t newSliceSize) {
 	
 	if(newSliceSize > currentSliceSize) {
 		// check if requested amount exceeds initial allocation
-		size_t totalAlloc = 0;
-		for(const auto& backend : backends)
-			totalAlloc += backend.allocSliceSize;
-		if(newSliceSize > totalAlloc) return false; // backends support upsizing, but we don't know how to reallocate the split, so don't allow it for now
+		for(const auto& partition : recoveryPartitions) {
+			size_t totalAlloc = 0;
+			for(unsigned groupIdx : partition)
+				totalAlloc += backends[backendGroups[groupIdx][0]].allocSliceSize;
+			if(newSliceSize > totalAlloc) return false; // backends support upsizing, but we don't know how to reallocate the split, so don't allow it for now
+		}
 	}
 	currentSliceSize = newSliceSize;
 	
 	bool success = true;
-	size_t pos = 0;
-	for(auto& backend : backends) {
-		backend.currentSliceSize = (std::min)(currentSliceSize-pos, backend.allocSliceSize);
-		backend.currentOffset = pos;
-		success = success && backend.be->setCurrentSliceSize(backend.currentSliceSize);
-		pos += backend.currentSliceSize;
+	for(const auto& partition : recoveryPartitions) {
+		size_t pos = 0;
+		for(unsigned groupIdx : partition) {
+			const auto& group = backendGroups[groupIdx];
+			size_t size = (std::min)(currentSliceSize-pos, backends[group[0]].allocSliceSize);
+			for(unsigned idx : group) {
+				auto& backend = backends[idx];
+				backend.currentSliceSize = size;
+				backend.currentOffset = pos;
+				success = success && backend.be->setCurrentSliceSize(size);
+			}
+			pos += size;
+		}
 	}
 	return success;
 }
@@ -132,18 +211,35 @@ bool PAR2Proc::setCurrentSliceSize(size_t newSliceSize, const std::vector<std::p
 bool PAR2Proc::setRecoverySlices(unsigned numSlices, const uint16_t* exponents) {
 	// TODO: consider throwing if numSlices > previously set, or some mechanism to resize buffer
 	
-	// TODO: may eventually consider splitting by recovery, but for now, just pass through
-	// - though we may still need a way to allocate different recovery to different backends (don't want to split slices to finely)
+	// the last partition must reach the final recovery slice
+	const auto& last = backends[backendGroups[recoveryPartitions.back()[0]][0]];
+	if(last.allocRecCount && last.allocRecOffset + last.allocRecCount < numSlices) return false;
+	numRecoverySlices = numSlices;
+	
 	bool success = true;
-	for(auto& backend : backends)
-		success = success && backend.be->setRecoverySlices(numSlices, exponents);
+	for(auto& backend : backends) {
+		unsigned end = backend.allocRecCount ? backend.allocRecOffset + backend.allocRecCount : numSlices;
+		backend.recOffset = (std::min)(backend.allocRecOffset, numSlices);
+		backend.recCount = (std::min)(end, numSlices) - backend.recOffset;
+		success = success && backend.be->setRecoverySlices(backend.recCount, exponents ? exponents + backend.recOffset : nullptr);
+	}
 	return success;
 }
 
 PAR2ProcBackendAddResult PAR2Proc::canAdd() const {
 	bool hasEmpty = false, hasBusy = false, hasFull = false;
-	for(const auto& backend : backends) {
-		auto state = backend.be->canAdd();
+	for(const auto& group : backendGroups) {
+		// members of a group share the work, so the group can accept input as long as one member can (see selectBackend)
+		PAR2ProcBackendAddResult state = PROC_ADD_FULL;
+		for(unsigned idx : group) {
+			auto memberState = backends[idx].be->canAdd();
+			if(memberState == PROC_ADD_OK) {
+				state = PROC_ADD_OK;
+				break;
+			}
+			if(memberState == PROC_ADD_OK_BUSY)
+				state = PROC_ADD_OK_BUSY;
+		}
 		if(state == PROC_ADD_OK)
 			hasEmpty = true;
 		if(state == PROC_ADD_OK_BUSY)
@@ -167,6 +263,14 @@ void PAR2Proc::waitForAdd() {
 }
 #endif
 
+// if coefficients are supplied, each backend only gets those for the recovery slices it computes
+static inline uint16_t recoveryCoeffs(uint16_t inputNum, unsigned) {
+	return inputNum;
+}
+static inline const uint16_t* recoveryCoeffs(const uint16_t* coeffs, unsigned recOffset) {
+	return coeffs + recOffset;
+}
+
 #ifdef USE_LIBUV
 template<typename T>
 bool PAR2Proc::_addInput(const void* buffer, size_t size, uint16_t inputRef, T inputNumOrCoeffs, bool flush, const PAR2ProcPlainCb& cb) {
@@ -177,7 +281,7 @@ bool PAR2Proc::_addInput(const void* buffer, size_t size, uint16_t inputRef, T i
 		cbRef->second.cb = cb;
 	} else {
 		cbRef = addCbRefs.emplace(std::make_pair(inputRef, PAR2ProcAddCbRef{
-			(int)backends.size(), cb,
+			(int)backendGroups.size(), cb,
 			[this, inputRef]() {
 				auto& ref = addCbRefs[inputRef];
 				if(--ref.backendsActive == 0) {
@@ -187,9 +291,10 @@ bool PAR2Proc::_addInput(const void* buffer, size_t size, uint16_t inputRef, T i
 				}
 			}
 		})).first;
-		for(auto& backend : backends) {
+		for(const auto& group : backendGroups) {
+			const auto& backend = backends[group[0]];
 			size_t amount = (std::min)(size-backend.currentOffset, backend.currentSliceSize);
-			if(backend.currentOffset >= size || amount == 0)
+			if(backend.currentOffset >= size || amount == 0 || backend.recCount == 0)
 				cbRef->second.backendsActive--;
 		}
 	}
@@ -197,16 +302,18 @@ bool PAR2Proc::_addInput(const void* buffer, size_t size, uint16_t inputRef, T i
 	// if the last add was unsuccessful, we assume that failed add is now being resent
 	// TODO: consider some better system - e.g. it may be worthwhile allowing accepting backends to continue to get new buffers? or perhaps use this as an opportunity to size up the size?
 	bool success = true;
-	for(auto& backend : backends) {
+	for(const auto& group : backendGroups) {
+		auto& backend = backends[group[0]]; // the first member tracks adds for the group
 		if(backend.currentOffset >= size) continue;
 		size_t amount = (std::min)(size-backend.currentOffset, backend.currentSliceSize);
-		if(amount == 0) continue;
+		if(amount == 0 || backend.recCount == 0) continue;
 		if(backend.added.find(inputRef) == backend.added.end()) {
-			bool canAdd = backend.be->canAdd() != PROC_ADD_FULL;
-			if(canAdd)
-				backend.be->addInput(static_cast<const char*>(buffer) + backend.currentOffset, amount, inputNumOrCoeffs, flush, cbRef->second.backendCb);
-			success = success && canAdd;
-			if(canAdd) backend.added.insert(inputRef);
+			IPAR2ProcBackend* target = selectBackend(group);
+			if(target) {
+				target->addInput(static_cast<const char*>(buffer) + backend.currentOffset, amount, recoveryCoeffs(inputNumOrCoeffs, backend.recOffset), flush, cbRef->second.backendCb);
+				backend.added.insert(inputRef);
+			} else
+				success = false;
 		}
 	}
 	if(success) {
@@ -243,13 +350,17 @@ static std::future<bool> combine_futures_and(std::vector<std::future<bool>>&& fu
 template<typename T>
 std::future<void> PAR2Proc::_addInput(const void* buffer, size_t size, T inputNumOfCoeffs, bool flush) {
 	std::vector<std::future<void>> addFutures;
-	addFutures.reserve(backends.size());
+	addFutures.reserve(backendGroups.size());
 	
-	for(auto& backend : backends) {
+	for(const auto& group : backendGroups) {
+		const auto& backend = backends[group[0]];
 		if(backend.currentOffset >= size) continue;
 		size_t amount = (std::min)(size-backend.currentOffset, backend.currentSliceSize);
-		if(amount == 0) continue;
-		addFutures.push_back(backend.be->addInput(static_cast<const char*>(buffer) + backend.currentOffset, amount, inputNumOfCoeffs, flush));
+		if(amount == 0 || backend.recCount == 0) continue;
+		// if all members are full, wait on the first one
+		IPAR2ProcBackend* target = selectBackend(group);
+		if(!target) target = backend.be;
+		addFutures.push_back(target->addInput(static_cast<const char*>(buffer) + backend.currentOffset, amount, recoveryCoeffs(inputNumOfCoeffs, backend.recOffset), flush));
 	}
 	hasAdded = true;
 	return combine_futures(std::move(addFutures));
@@ -267,14 +378,16 @@ bool PAR2Proc::dummyInput(size_t size, uint16_t inputNum, bool flush) {
 	IF_LIBUV(assert(!endSignalled));
 	
 	bool success = true;
-	for(auto& backend : backends) {
-		if(backend.currentOffset >= size || backend.currentSliceSize == 0) continue;
+	for(const auto& group : backendGroups) {
+		auto& backend = backends[group[0]];
+		if(backend.currentOffset >= size || !backend.isUsed()) continue;
 		if(backend.added.find(inputNum) == backend.added.end()) {
-			bool canAdd = backend.be->canAdd() != PROC_ADD_FULL;
-			if(canAdd)
-				backend.be->dummyInput(inputNum, flush);
-			success = success && canAdd;
-			if(canAdd) backend.added.insert(inputNum);
+			IPAR2ProcBackend* target = selectBackend(group);
+			if(target) {
+				target->dummyInput(inputNum, flush);
+				backend.added.insert(inputNum);
+			} else
+				success = false;
 		}
 	}
 	if(success) {
@@ -289,7 +402,7 @@ bool PAR2Proc::fillInput(const void* buffer, size_t size) {
 	IF_LIBUV(assert(!endSignalled));
 	bool finished = true;
 	for(auto& backend : backends) {
-		if(backend.currentOffset >= size || backend.currentSliceSize == 0) continue;
+		if(backend.currentOffset >= size || !backend.isUsed()) continue;
 		if(backend.added.find(-1) == backend.added.end()) {
 			bool fillSuccessful = backend.be->fillInput(static_cast<const char*>(buffer) + backend.currentOffset);
 			finished = finished && fillSuccessful;
@@ -303,7 +416,7 @@ bool PAR2Proc::fillInput(const void* buffer, size_t size) {
 
 void PAR2Proc::flush() {
 	for(auto& backend : backends)
-		if(backend.currentSliceSize > 0)
+		if(backend.isUsed())
 			backend.be->flush();
 }
 
@@ -314,7 +427,7 @@ FUTURE_RETURN_T PAR2Proc::endInput(IF_LIBUV(const PAR2ProcPlainCb& _finishCb)) {
 	finishCb = _finishCb;
 	bool allIsEmpty = true;
 	for(auto& backend : backends) {
-		if(backend.currentSliceSize == 0) continue;
+		if(!backend.isUsed()) continue;
 		backend.be->endInput();
 		allIsEmpty = allIsEmpty && backend.be->isEmpty();
 	}
@@ -325,13 +438,44 @@ FUTURE_RETURN_T PAR2Proc::endInput(IF_LIBUV(const PAR2ProcPlainCb& _finishCb)) {
 	flush();
 	std::vector<std::future<void>> futures;
 	for(auto& backend : backends) {
-		if(backend.currentSliceSize == 0) continue;
+		if(!backend.isUsed()) continue;
 		futures.push_back(backend.be->endInput()); // this will also call processing_finished when appropriate
 	}
 	return combine_futures(std::move(futures));
 #endif
 }
 
+// for grouped backends, all but the first member's output is retrieved into a temporary buffer, then xor'd into the output
+struct PAR2ProcOutputMerge {
+	char* dst;
+	char* src;
+	size_t len;
+};
+static void merge_outputs(const std::vector<struct PAR2ProcOutputMerge>& merges) {
+	for(const auto& merge : merges) {
+		size_t pos = 0;
+		for(; pos + sizeof(uintptr_t) <= merge.len; pos += sizeof(uintptr_t)) {
+			uintptr_t a, b;
+			memcpy(&a, merge.dst + pos, sizeof(a));
+			memcpy(&b, merge.src + pos, sizeof(b));
+			a ^= b;
+			memcpy(merge.dst + pos, &a, sizeof(a));
+		}
+		for(; pos < merge.len; pos++)
+			merge.dst[pos] ^= merge.src[pos];
+		free(merge.src);
+	}
+}
+
+#ifdef USE_LIBUV
+struct PAR2ProcOutputCbRef {
+	int pending;
+	bool allValid;
+	std::vector<struct PAR2ProcOutputMerge> merges;
+	PAR2ProcOutputCb cb;
+};
+#endif
+
 FUTURE_RETURN_BOOL_T PAR2Proc::getOutput(unsigned index, void* output  IF_LIBUV(, const PAR2ProcOutputCb& cb)) const {
 #ifdef USE_LIBUV
 	if(!hasAdded) {
@@ -341,35 +485,37 @@ FUTURE_RETURN_BOOL_T PAR2Proc::getOutput(unsigned index, void* output  IF_LIBUV(
 		return;
 	}
 	
-	auto* cbRef = new int(backends.size());
-	for(const auto& backend : backends) {
-		if(backend.currentSliceSize == 0)
-			(*cbRef)--;
-	}
-	auto* allValid = new bool(true);
-	for(auto& backend : backends) {
-		if(backend.currentSliceSize == 0) continue;
-		auto outputPtr = static_cast<char*>(output) + backend.currentOffset;
-		if(!backend.be->_hasAdded()) {
-			// no computation done on backend -> zero fill part
-			memset(outputPtr, 0, backend.currentSliceSize);
-			if(--(*cbRef) == 0) {
-				delete cbRef;
-				cb(*allValid);
-				delete allValid;
+	auto* cbRef = new PAR2ProcOutputCbRef{1, true, {}, cb}; // hold a reference until all requests are sent
+	auto onOutput = [cbRef](bool valid) {
+		cbRef->allValid = cbRef->allValid && valid;
+		if(--cbRef->pending == 0) {
+			merge_outputs(cbRef->merges);
+			cbRef->cb(cbRef->allValid);
+			delete cbRef;
+		}
+	};
+	for(const auto& group : backendGroups) {
+		const auto& leader = backends[group[0]];
+		// only groups computing this recovery slice are relevant
+		if(leader.currentSliceSize == 0 || index < leader.recOffset || index >= leader.recOffset + leader.recCount) continue;
+		auto outputPtr = static_cast<char*>(output) + leader.currentOffset;
+		bool hasOutput = false;
+		for(unsigned idx : group) {
+			const auto& backend = backends[idx];
+			if(!backend.be->_hasAdded()) continue; // no computation done on backend
+			char* dst = outputPtr;
+			if(hasOutput) {
+				dst = static_cast<char*>(malloc(leader.currentSliceSize));
+				cbRef->merges.push_back({outputPtr, dst, leader.currentSliceSize});
 			}
-		} else {
-			// TODO: for overlapping regions, need to do a xor-merge pass
-			backend.be->getOutput(index, outputPtr, [cbRef, allValid, cb](bool valid) {
-				*allValid = *allValid && valid;
-				if(--(*cbRef) == 0) {
-					delete cbRef;
-					cb(*allValid);
-					delete allValid;
-				}
-			});
+			hasOutput = true;
+			cbRef->pending++;
+			backend.be->getOutput(index - leader.recOffset, dst, onOutput);
 		}
+		if(!hasOutput) // no computation done on any backend -> zero fill part
+			memset(outputPtr, 0, leader.currentSliceSize);
 	}
+	onOutput(true);
 	
 #else
 	
@@ -382,19 +528,40 @@ FUTURE_RETURN_BOOL_T PAR2Proc::getOutput(unsigned index, void* output  IF_LIBUV(
 	}
 	
 	std::vector<std::future<bool>> outFutures;
+	std::vector<struct PAR2ProcOutputMerge> merges;
 	outFutures.reserve(backends.size());
 	
-	for(auto& backend : backends) {
-		if(backend.currentSliceSize == 0) continue;
-		auto outputPtr = static_cast<char*>(output) + backend.currentOffset;
-		if(!backend.be->_hasAdded()) {
-			// no computation done on backend -> zero fill part
-			memset(outputPtr, 0, backend.currentSliceSize);
-		} else {
-			outFutures.push_back(backend.be->getOutput(index, outputPtr));
+	for(const auto& group : backendGroups) {
+		const auto& leader = backends[group[0]];
+		// only groups computing this recovery slice are relevant
+		if(leader.currentSliceSize == 0 || index < leader.recOffset || index >= leader.recOffset + leader.recCount) continue;
+		auto outputPtr = static_cast<char*>(output) + leader.currentOffset;
+		bool hasOutput = false;
+		for(unsigned idx : group) {
+			const auto& backend = backends[idx];
+			if(!backend.be->_hasAdded()) continue;
+			char* dst = outputPtr;
+			if(hasOutput) {
+				dst = static_cast<char*>(malloc(leader.currentSliceSize));
+				merges.push_back({outputPtr, dst, leader.currentSliceSize});
+			}
+			hasOutput = true;
+			outFutures.push_back(backend.be->getOutput(index - leader.recOffset, dst));
 		}
+		if(!hasOutput) // no computation done on backend -> zero fill part
+			memset(outputPtr, 0, leader.currentSliceSize);
 	}
-	return combine_futures_and(std::move(outFutures));
+	if(merges.empty())
+		return combine_futures_and(std::move(outFutures));
+	return std::async(std::launch::async, [](std::vector<std::future<bool>>&& futures, std::vector<struct PAR2ProcOutputMerge>&& merges) -> bool {
+		bool result = true;
+		for(auto& f : futures) {
+			bool valid = f.get(); // all outputs must be retrieved before merging
+			result = result && valid;
+		}
+		merge_outputs(merges);
+		return result;
+	}, std::move(outFutures), std::move(merges));
 #endif
 }
 
@@ -419,7 +586,7 @@ void PAR2Proc::processing_finished() {
 	endSignalled = false;
 	
 	for(auto& backend : backends)
-		if(backend.currentSliceSize > 0)
+		if(backend.isUsed())
 			backend.be->processing_finished();
 	
 	if(finishCb) finishCb();
@@ -229,7 +229,13 @@ struct Backend {
 	size_t currentOffset;
 	size_t currentSliceSize;
 	size_t allocSliceSize;
+	unsigned allocRecOffset, allocRecCount; // range of recovery slices handled by this backend; a count of 0 means all remaining slices
+	unsigned recOffset, recCount; // the above, clamped to the recovery slices currently set
 	std::unordered_set<int> added;
+	
+	inline bool isUsed() const {
+		return currentSliceSize > 0 && recCount > 0;
+	}
 };
 
 #ifdef USE_LIBUV
@@ -243,6 +249,7 @@ struct PAR2ProcAddCbRef {
 struct PAR2ProcBackendAlloc {
 	IPAR2ProcBackend* be;
 	size_t offset, size;
+	unsigned recOffset, recCount; // if unset, the backend computes all recovery slices
 };
 
 class PAR2Proc {
@@ -255,8 +262,15 @@ private:
 	template<typename T> std::future<void> _addInput(const void* buffer, size_t size, T inputNumOfCoeffs, bool flush);
 #endif
 	std::vector<struct Backend> backends;
+	// backends allocated identical ranges form a group; each input is only sent to one member of the group (whichever is free), and their outputs get xor-merged
+	std::vector<std::vector<unsigned>> backendGroups;
+	// groups which compute the same recovery slices form a partition; each partition must cover the entire slice, and every partition receives every input
+	std::vector<std::vector<unsigned>> recoveryPartitions;
+	unsigned numRecoverySlices;
 	
 	bool checkBackendAllocation();
+	bool checkSliceCoverage(const std::vector<unsigned>& groups) const;
+	IPAR2ProcBackend* selectBackend(const std::vector<unsigned>& group) const;
 	
 	size_t currentSliceSize; // current slice chunk size (<=sliceSize)
 	
@@ -287,8 +301,7 @@ public:
 		return setRecoverySlices(exponents.size(), exponents.data());
 	}
 	inline int getNumRecoverySlices() const {
-		// TODO: need proper number if splitting recovery blocks; for now, just use the first backend as all are the same
-		return backends[0].be->getNumRecoverySlices();
+		return numRecoverySlices;
 	}
 	
 	PAR2ProcBackendAddResult canAdd() const;
@@ -8,6 +8,8 @@
 #endif
 #define CEIL_DIV(a, b) (((a) + (b)-1) / (b))
 #define ROUND_DIV(a, b) (((a) + ((b)>>1)) / (b))
+// minimum number of outputs per input before output-blocked kernels are considered
+#define CPU_OUTPUT_BLOCKED_RATIO 4
 
 PAR2ProcCPUStaging::~PAR2ProcCPUStaging() {
 	if(src) ALIGN_FREE(src);
@@ -15,7 +17,7 @@ PAR2ProcCPUStaging::~PAR2ProcCPUStaging() {
 
 /** initialization **/
 PAR2ProcCPU::PAR2ProcCPU(IF_LIBUV(uv_loop_t* _loop,) int stagingAreas)
-: IPAR2ProcBackend(IF_LIBUV(_loop)), sliceSize(0), numThreads(0), gf(NULL), staging(stagingAreas), memProcessing(NULL), transferThread(PAR2ProcCPU::transfer_slice) {
+: IPAR2ProcBackend(IF_LIBUV(_loop)), sliceSize(0), numThreads(0), gf(NULL), staging(stagingAreas), stagingNT(false), memProcessing(NULL), processingNT(false), transferThread(PAR2ProcCPU::transfer_slice) {
 	
 	// default number of threads = number of CPUs available
 	setNumThreads(-1);
@@ -49,9 +51,26 @@ void PAR2ProcCPU::freeGf() {
 	gf = NULL;
 }
 
+bool PAR2ProcCPU::getCodeCacheStats(uint64_t& hits, uint64_t& misses) const {
+	hits = misses = 0;
+	if(!gf) return false;
+	bool hasStats = false;
+	for(void* scratch : gfScratch) {
+		uint64_t h, m;
+		// counters are updated by the worker threads without synchronisation, so may be slightly stale
+		if(gf->mutScratch_cache_stats(scratch, h, m)) {
+			hits += h;
+			misses += m;
+			hasStats = true;
+		}
+	}
+	return hasStats;
+}
+
 void PAR2ProcCPU::setNumThreads(int threads) {
 	if(threads < 0) {
-		threads = hardware_concurrency();
+		// default to one thread per CPU we're allowed to run on
+		threads = cpuAffinity.empty() ? hardware_concurrency() : (int)cpuAffinity.size();
 	}
 	numThreads = threads;
 	if(!gf) return;
@@ -70,12 +89,20 @@ void PAR2ProcCPU::setNumThreads(int threads) {
 		gfScratch[i] = gf->mutScratch_alloc();
 		thWorkers[i].lowPrio = true;
 		thWorkers[i].name = "gf_worker";
+		thWorkers[i].affinity = cpuAffinity;
 		thWorkers[i].setCallback(PAR2ProcCPU::compute_worker);
 	}
 	
 	if(alignedCurrentSliceSize) calcChunkSize();
 }
 
+// takes effect when worker threads are next started, so should be set before processing begins
+void PAR2ProcCPU::setAffinity(const std::vector<int>& cpus) {
+	cpuAffinity = cpus;
+	for(auto& worker : thWorkers)
+		worker.affinity = cpus;
+}
+
 bool PAR2ProcCPU::init(Galois16Methods method, unsigned _inputGrouping, size_t _chunkLen) {
 	freeGf();
 	bool ret = true;
@@ -121,6 +148,10 @@ bool PAR2ProcCPU::reallocMemInput() {
 		ALIGN_ALLOC(area.src, inputBatchSize * alignedSliceSize, alignment);
 		if(!area.src) ret = false;
 	}
+	
+	// if the staging areas can't fit in the LLC, inputs will be evicted before they're processed anyway, so avoid the read-for-ownership and cache pollution of regular stores
+	size_t ntThreshold = gf->info().nonTemporalThreshold;
+	stagingNT = ntThreshold && staging.size() * inputBatchSize * alignedSliceSize > ntThreshold;
 	return ret;
 }
 
@@ -159,6 +190,7 @@ bool PAR2ProcCPU::setCurrentSliceSize(size_t newSliceSize) {
 			if(!outputExponents.empty()) {
 				ALIGN_ALLOC(memProcessing, outputExponents.size() * alignedSliceSize, alignment);
 				if(!memProcessing) ret = false;
+				setProcessingNT();
 			}
 		}
 	}
@@ -186,10 +218,16 @@ bool PAR2ProcCPU::setRecoverySlices(unsigned numSlices, const uint16_t* exponent
 		// (investigate mmap or just use calloc and align ourself)
 		// (will need to be careful with discard_output)
 		ALIGN_ALLOC(memProcessing, numSlices * alignedSliceSize, alignment);
+		setProcessingNT();
 	}
 	return memProcessing != nullptr;
 }
 
+// if recovery can't fit in the LLC, writing it out to the output buffer would just evict it, so use non-temporal stores instead
+void PAR2ProcCPU::setProcessingNT() {
+	size_t ntThreshold = gf->info().nonTemporalThreshold;
+	processingNT = ntThreshold && outputExponents.size() * alignedSliceSize > ntThreshold;
+}
 void PAR2ProcCPU::freeProcessingMem() {
 	if(memProcessing) {
 		ALIGN_FREE(memProcessing);
@@ -238,11 +276,11 @@ void PAR2ProcCPU::transfer_slice(ThreadMessageQueue<void*>& q) {
 	struct transfer_data* data;
 	while((data = static_cast<struct transfer_data*>(q.pop())) != NULL) {
 		if(data->finish) {
-			data->cksumSuccess = data->gf->finish_packed_cksum(data->dst, data->src, data->size, data->numBufs, data->index, data->chunkLen);
+			data->cksumSuccess = (data->parent->processingNT ? data->gf->finish_packed_cksum_nt : data->gf->finish_packed_cksum)(data->dst, data->src, data->size, data->numBufs, data->index, data->chunkLen);
 			NOTIFY_DONE(data, _queueRecv, data->promOut, data->cksumSuccess);
 		} else {
 			if(data->src)
-				data->gf->prepare_packed_cksum(data->dst, data->src, data->size, data->dstLen, data->numBufs, data->index, data->chunkLen);
+				(data->parent->stagingNT ? data->gf->prepare_packed_cksum_nt : data->gf->prepare_packed_cksum)(data->dst, data->src, data->size, data->dstLen, data->numBufs, data->index, data->chunkLen);
 			if(data->submitInBufs) {
 				// queue async compute
 				data->parent->run_kernel(data->inBufId, data->submitInBufs);
@@ -358,7 +396,7 @@ bool PAR2ProcCPU::fillInput(const void* buffer) {
 	IF_LIBUV(assert(!endSignalled));
 	if(!staging[0].src) reallocMemInput();
 	
-	gf->prepare_packed_cksum(staging[currentStagingArea].src, buffer, currentSliceSize, alignedCurrentSliceSize - stride, inputBatchSize, currentStagingInputs, chunkLen);
+	(stagingNT ? gf->prepare_packed_cksum_nt : gf->prepare_packed_cksum)(staging[currentStagingArea].src, buffer, currentSliceSize, alignedCurrentSliceSize - stride, inputBatchSize, currentStagingInputs, chunkLen);
 	if(++currentStagingInputs == inputBatchSize) {
 		currentStagingInputs = 0;
 		if(++currentStagingArea == staging.size()) {
@@ -485,9 +523,29 @@ void PAR2ProcCPU::compute_worker(ThreadMessageQueue<void*>& q) {
 			}
 		}
 		
+		// the default kernels are input-blocked: several inputs are multiplied into a single output, which means the inputs are re-read, and the output read+written, for each output
+		// if there are few inputs relative to outputs (e.g. a small final batch), this overhead dominates, so switch to output-blocked kernels which read each input once per group of outputs
+		// output-blocked kernels can't hold coefficients in registers, so only use them if the input-blocked kernel would be less than half utilised
+		bool outputBlocked = gfInfo.idealOutputMultiple && req->gf->hasMultiOutPacked()
+			&& req->numOutputs >= gfInfo.idealOutputMultiple
+			&& req->numInputs * CPU_OUTPUT_BLOCKED_RATIO <= req->numOutputs
+			&& req->numInputs*2 < gfInfo.idealInputMultiple;
+		
+		// each coefficient is used once per chunk round, in up to two variants (with prefetch, and without, for the last round)
+		if(!outputBlocked)
+			req->gf->mutScratch_hint_reuse(req->mutScratch, req->numOutputs*req->numInputs*2, req->numChunks);
+		
 		for(size_t round = 0; round < req->numChunks; round++) {
 			size_t procSize = MIN(req->len-round*req->chunkSize, req->chunkSize);
 			const char* srcPtr = static_cast<const char*>(req->input) + round*req->chunkSize*req->inputGrouping;
+			if(outputBlocked) {
+				// outputs are laid out consecutively within a round, so can be handed over in one go
+				// this path doesn't prefetch, since each call already covers all outputs
+				char* dstPtr = static_cast<char*>(req->output) + round*req->numOutputs*req->chunkSize;
+				if(!req->add) memset(dstPtr, 0, procSize*req->numOutputs);
+				req->gf->mul_add_multiout_packed(req->inputGrouping, req->numInputs, req->numOutputs, dstPtr, srcPtr, procSize, req->coeffs, req->mutScratch);
+				continue;
+			}
 			for(unsigned out = 0; out < req->numOutputs; out++) {
 				const uint16_t* vals = req->coeffs + out*req->inputGrouping;
 				
@@ -499,9 +557,10 @@ void PAR2ProcCPU::compute_worker(ThreadMessageQueue<void*>& q) {
 							req->gf->mul_add_multi_packpf(req->inputGrouping, req->numInputs, dstPtr, srcPtr, procSize, vals, req->mutScratch, NULL, dstPtr+procSize);
 						else
 							req->gf->add_multi_packpf(req->inputGrouping, req->numInputs, dstPtr, srcPtr, procSize, NULL, dstPtr+procSize);
-					} else
-						// TODO: this could also be a 0 output, so consider add_multi optimisation?
+					} else if(req->outNonZero[out])
 						req->gf->mul_add_multi_packed(req->inputGrouping, req->numInputs, dstPtr, srcPtr, procSize, vals, req->mutScratch);
+					else
+						req->gf->add_multi_packed(req->inputGrouping, req->numInputs, dstPtr, srcPtr, procSize);
 				} else {
 					const char* pfInput = out >= inputPrefetchOutOffset ? static_cast<const char*>(req->input) + (round+1)*req->chunkSize*req->inputGrouping + ((inputsPrefetchedPerInvok*(out-inputPrefetchOutOffset)*procSize)>>MAX_PF_FACTOR) : NULL;
 					// procSize input prefetch may be wrong for final round, but it's the closest we've got; TODO: perhaps consider skipping out of prefetching, if the final round has a different region size
@@ -25,6 +25,7 @@ private:
 	size_t alignedCurrentSliceSize; // memory used for current slice chunk (<=alignedSliceSize)
 	
 	int numThreads;
+	std::vector<int> cpuAffinity; // logical CPUs the workers are pinned to (empty = unrestricted)
 	std::vector<MessageThread> thWorkers; // main processing worker threads
 	std::vector<void*> gfScratch; // scratch memory for each thread
 	
@@ -38,7 +39,10 @@ private:
 	// staging area from which processing is performed
 	std::vector<PAR2ProcCPUStaging> staging;
 	bool reallocMemInput();
+	void setProcessingNT();
+	bool stagingNT; // use non-temporal stores when filling the staging area, as it's too large to remain cached
 	void* memProcessing; // TODO: break this into chunks, to avoid massive single allocation
+	bool processingNT; // use non-temporal stores when writing outputs, as the processing buffer is too large to remain cached
 	
 	void calcChunkSize();
 	
@@ -88,6 +92,13 @@ public:
 	inline int getNumThreads() const {
 		return numThreads;
 	}
+	void setAffinity(const std::vector<int>& cpus);
+	inline const std::vector<int>& getAffinity() const {
+		return cpuAffinity;
+	}
+	inline void setTransferAffinity(const std::vector<int>& cpus) {
+		transferThread.affinity = cpus;
+	}
 	inline const char* getMethodName() const {
 		return gf->info().name;
 	}
@@ -106,6 +117,8 @@ public:
 	inline size_t getAllocSliceSize() const {
 		return alignedSliceSize;
 	}
+	// totals across all threads; only available for methods which cache generated code
+	bool getCodeCacheStats(uint64_t& hits, uint64_t& misses) const;
 	
 	PAR2ProcBackendAddResult canAdd() const override;
 	FUTURE_RETURN_T addInput(const void* buffer, size_t size, uint16_t inputNum, bool flush  IF_LIBUV(, const PAR2ProcPlainCb& cb)) override;
@@ -3,6 +3,8 @@
 #include <stdlib.h> // free / calloc
 #include <cassert>
 #include "controller_ocl.h"
+#include "../src/platform.h"
+#include <chrono>
 
 std::vector<cl::Platform> PAR2ProcOCL::platforms;
 
@@ -25,7 +27,7 @@ int PAR2ProcOCL::load_runtime() {
 
 
 PAR2ProcOCL::PAR2ProcOCL(IF_LIBUV(uv_loop_t* _loop,) int platformId, int deviceId, int stagingAreas)
-: IPAR2ProcBackend(IF_LIBUV(_loop)), staging(stagingAreas), allocatedSliceSize(0), transferThread(PAR2ProcOCL::transfer_slice) {
+: IPAR2ProcBackend(IF_LIBUV(_loop)), staging(stagingAreas), outputsPerShard(0), maxAllocLimit(0), zeroCopy(false), unifiedMemory(false), hostAlignment(4096), allocatedSliceSize(0), transferThread(PAR2ProcOCL::transfer_slice), tracing(false), buildTime(0), buildCached(false) {
 	_initSuccess = false;
 	transferThread.name = "ocl_transfer";
 	
@@ -45,7 +47,11 @@ PAR2ProcOCL::PAR2ProcOCL(IF_LIBUV(uv_loop_t* _loop,) int platformId, int deviceI
 	if(device.getInfo<CL_DEVICE_ENDIAN_LITTLE>() != CL_TRUE) ERROR_EXIT
 	
 	try {
-		queue = cl::CommandQueue(context, device, 0);
+		create_queues();
+		// integrated GPUs and CPU runtimes (e.g. pocl) can use host memory directly
+		unifiedMemory = device.getInfo<CL_DEVICE_HOST_UNIFIED_MEMORY>() == CL_TRUE;
+		size_t baseAlign = device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8; // reported in bits
+		if(baseAlign > hostAlignment) hostAlignment = baseAlign;
 		_initSuccess = true;
 	} catch(cl::Error const& err) {
 #ifndef GF16OCL_NO_OUTPUT
@@ -60,6 +66,93 @@ PAR2ProcOCL::PAR2ProcOCL(IF_LIBUV(uv_loop_t* _loop,) int platformId, int deviceI
 
 PAR2ProcOCL::~PAR2ProcOCL() {
 	deinit();
+	free_host_buffers();
+}
+
+void PAR2ProcOCL::create_queues() {
+	cl_command_queue_properties props = tracing ? CL_QUEUE_PROFILING_ENABLE : 0;
+	queue = cl::CommandQueue(context, device, props);
+	transferQueue = cl::CommandQueue(context, device, props);
+}
+
+// must be called before init()
+bool PAR2ProcOCL::setTrace(bool enable) {
+	if(!_initSuccess) return false;
+	if(enable == tracing) return true;
+	try {
+		tracing = enable;
+		create_queues();
+	} catch(cl::Error const& err) {
+#ifndef GF16OCL_NO_OUTPUT
+		std::cerr << "OpenCL Error: " << err.what() << "(" << err.err() << ")" << std::endl;
+#endif
+		tracing = false;
+		return false;
+	}
+	return true;
+}
+
+static inline uint64_t trace_now() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+void PAR2ProcOCL::trace_event(const char* stage, const cl::Event& event) {
+	if(!tracing) return;
+	std::lock_guard<std::mutex> lock(traceMutex);
+	traceEntries.push_back({stage, event, trace_now()});
+}
+std::vector<PAR2ProcOCLTraceSpan> PAR2ProcOCL::getTrace() {
+	std::vector<TraceEntry> entries;
+	{
+		std::lock_guard<std::mutex> lock(traceMutex);
+		entries.swap(traceEntries);
+	}
+	
+	std::vector<PAR2ProcOCLTraceSpan> spans;
+	spans.reserve(entries.size());
+	for(const auto& entry : entries) {
+		cl_ulong queued, start, end;
+		try {
+			queued = entry.event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+			start = entry.event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+			end = entry.event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+		} catch(cl::Error const&) {
+			continue; // command never completed
+		}
+		if(start < queued || end < start) continue;
+		// profiling times are in nanoseconds on the device's clock, so are placed relative to when the command was enqueued on the host
+		spans.push_back({entry.stage, entry.hostQueued + (start-queued)/1000, entry.hostQueued + (end-queued)/1000});
+	}
+	return spans;
+}
+
+// releases everything referencing host allocations before freeing them, as the device may access them up until then
+void PAR2ProcOCL::free_host_buffers() {
+	bool hasHost = false;
+	for(const auto& area : staging)
+		if(area.host || area.mapped) hasHost = true;
+	for(const auto& shard : shards)
+		if(shard.outputHost) hasHost = true;
+	if(!hasHost) return;
+	
+	for(auto& area : staging) {
+		if(area.mapped) {
+			queue.enqueueUnmapMemObject(area.host ? area.input : area.pinned, area.mapped);
+			area.mapped = nullptr;
+		}
+	}
+	queue.finish();
+	for(auto& area : staging) {
+		area.pinned = cl::Buffer();
+		if(!area.host) continue;
+		area.input = cl::Buffer();
+		ALIGN_FREE(area.host);
+		area.host = nullptr;
+	}
+	for(auto& shard : shards) {
+		void* outputHost = shard.outputHost;
+		shard = PAR2ProcOCLShard(); // drops the kernels too, which reference the buffer
+		if(outputHost) ALIGN_FREE(outputHost);
+	}
 }
 
 
@@ -69,7 +162,7 @@ void PAR2ProcOCL::setSliceSize(size_t _sliceSize) {
 	if(gf)
 		sliceSizeCksum = _sliceSize + gf->info().cksumSize;
 }
-bool PAR2ProcOCL::init(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, Galois16Methods cksumMethod) {
+bool PAR2ProcOCL::init(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, Galois16Methods cksumMethod, unsigned targetWorkGroup) {
 	if(!_initSuccess) return false;
 	outputExponents.clear();
 	
@@ -78,6 +171,7 @@ bool PAR2ProcOCL::init(Galois16OCLMethods method, unsigned targetInputBatch, uns
 	_setupTargetInputBatch = targetInputBatch;
 	_setupTargetIters = targetIters;
 	_setupTargetGrouping = targetGrouping;
+	_setupTargetWorkGroup = targetWorkGroup;
 	
 	reset_state();
 	coeffType = GF16OCL_COEFF_NORMAL;
@@ -113,7 +207,7 @@ bool PAR2ProcOCL::setRecoverySlices(unsigned _numOutputs, const uint16_t* output
 	if(_numOutputs != outputExponents.size() || (coeffType == GF16OCL_COEFF_LOG_SEQ && !coeffIsSeq)) {
 		// need to re-init as the code assumes a fixed number of outputs
 		outputExponents = std::vector<uint16_t>(_numOutputs);
-		if(!setup_kernels(_setupMethod, _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping, coeffIsSeq))
+		if(!setup_kernels(_setupMethod, _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping, _setupTargetWorkGroup, coeffIsSeq))
 			return false;
 	}
 	
@@ -122,16 +216,23 @@ bool PAR2ProcOCL::setRecoverySlices(unsigned _numOutputs, const uint16_t* output
 	if(outputExp)
 		memcpy(outputExponents.data(), outputExp, outputExponents.size()*sizeof(uint16_t));
 	if(coeffType == GF16OCL_COEFF_LOG) {
-		cl::Event writeEvent;
-		queue.enqueueWriteBuffer(buffer_outExp, CL_FALSE, 0, outputExponents.size()*sizeof(uint16_t), outputExponents.data(), &queueEvents, &writeEvent);
-		queueEvents.clear();
-		queueEvents.reserve(2);
-		queueEvents.push_back(writeEvent);
+		// padding outputs in the last shard are left with whatever exponents are there; their results are never read
+		std::vector<cl::Event> writeEvents(shards.size());
+		for(unsigned s=0; s<shards.size(); s++) {
+			unsigned first = s*outputsPerShard;
+			unsigned count = std::min(outputsPerShard, (unsigned)outputExponents.size() - first);
+			queue.enqueueWriteBuffer(shards[s].outExp, CL_FALSE, 0, count*sizeof(uint16_t), outputExponents.data() + first, &queueEvents, &writeEvents[s]);
+		}
+		queueEvents = std::move(writeEvents);
 	} else if(coeffType == GF16OCL_COEFF_LOG_SEQ) {
-		kernelMul.setArg<cl_ushort>(3, outputExponents[0]);
-		kernelMulAdd.setArg<cl_ushort>(3, outputExponents[0]);
-		kernelMulLast.setArg<cl_ushort>(4, outputExponents[0]);
-		kernelMulAddLast.setArg<cl_ushort>(4, outputExponents[0]);
+		for(unsigned s=0; s<shards.size(); s++) {
+			auto& shard = shards[s];
+			cl_ushort base = outputExponents[0] + s*outputsPerShard;
+			shard.kernelMul.setArg<cl_ushort>(3, base);
+			shard.kernelMulAdd.setArg<cl_ushort>(3, base);
+			shard.kernelMulLast.setArg<cl_ushort>(4, base);
+			shard.kernelMulAddLast.setArg<cl_ushort>(4, base);
+		}
 	}
 	return true;
 }
@@ -148,6 +249,7 @@ void PAR2ProcOCL::reset_state() {
 }
 
 void PAR2ProcOCL::_deinit() {
+	transferQueue.finish();
 	queue.finish();
 	queueEvents.clear();
 }
@@ -165,6 +267,10 @@ std::vector<Galois16OCLMethods> PAR2ProcOCL::availableMethods(int platformId, in
 		ret.push_back(GF16OCL_LOOKUP_HALF);
 		ret.push_back(GF16OCL_LOOKUP_NOCACHE);
 		ret.push_back(GF16OCL_LOOKUP_HALF_NOCACHE);
+		ret.push_back(GF16OCL_LOOKUP_WIDE);
+		ret.push_back(GF16OCL_LOOKUP_HALF_WIDE);
+		ret.push_back(GF16OCL_LOOKUP_ASYNC);
+		ret.push_back(GF16OCL_LOOKUP_HALF_ASYNC);
 		/* log methods are known to fail on some platforms, so disable for now
 		TODO: debug these and enable
 		ret.push_back(GF16OCL_LOG);
@@ -173,6 +279,8 @@ std::vector<Galois16OCLMethods> PAR2ProcOCL::availableMethods(int platformId, in
 		ret.push_back(GF16OCL_LOG_TINY);
 		ret.push_back(GF16OCL_LOG_SMALL_LMEM);
 		ret.push_back(GF16OCL_LOG_TINY_LMEM);
+		ret.push_back(GF16OCL_LOG_WIDE);
+		ret.push_back(GF16OCL_LOG_ASYNC);
 		*/
 		//ret.push_back(GF16OCL_SHUFFLE);
 		ret.push_back(GF16OCL_BY2);
@@ -189,6 +297,10 @@ std::vector<Galois16OCLMethods> PAR2ProcOCL::availableMethods(int platformId, in
 		ret.push_back(GF16OCL_LOOKUP_HALF);
 		ret.push_back(GF16OCL_LOOKUP_NOCACHE);
 		ret.push_back(GF16OCL_LOOKUP_HALF_NOCACHE);
+		ret.push_back(GF16OCL_LOOKUP_WIDE);
+		ret.push_back(GF16OCL_LOOKUP_HALF_WIDE);
+		ret.push_back(GF16OCL_LOOKUP_ASYNC);
+		ret.push_back(GF16OCL_LOOKUP_HALF_ASYNC);
 		/* log methods are known to fail on some platforms, so disable for now
 		ret.push_back(GF16OCL_LOG);
 		ret.push_back(GF16OCL_LOG_SMALL);
@@ -196,6 +308,8 @@ std::vector<Galois16OCLMethods> PAR2ProcOCL::availableMethods(int platformId, in
 		ret.push_back(GF16OCL_LOG_TINY);
 		ret.push_back(GF16OCL_LOG_SMALL_LMEM);
 		ret.push_back(GF16OCL_LOG_TINY_LMEM);
+		ret.push_back(GF16OCL_LOG_WIDE);
+		ret.push_back(GF16OCL_LOG_ASYNC);
 		*/
 		ret.push_back(GF16OCL_BY2);
 	}
@@ -213,7 +327,7 @@ bool PAR2ProcOCL::setCurrentSliceSize(size_t newSliceSize) {
 	if(sliceSizeCksum > allocatedSliceSize) {
 		// need to re-init everything
 		auto outExp = outputExponents;
-		if(!init(_setupMethod, _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping))
+		if(!init(_setupMethod, _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping, gfMethod, _setupTargetWorkGroup))
 			return false;
 		if(!outExp.empty()) {
 			if(!setRecoverySlices(outExp.size(), outExp.data()))
@@ -235,6 +349,7 @@ struct transfer_data_ocl {
 	void* local;
 	cl::Buffer* remote;
 	size_t remoteOffset;
+	void* remoteMapped; // if set, the remote is already mapped here, so can be written directly
 	size_t sliceLen, totalLen;
 	Galois16Mul* gf;
 	
@@ -277,12 +392,16 @@ void PAR2ProcOCL::transfer_slice(ThreadMessageQueue<void*>& q) {
 	while((data = static_cast<struct transfer_data_ocl*>(q.pop())) != NULL) {
 		// TODO: consider doing a single mapping for the entire slice (if not, consider async mapping)
 		if(data->finish) {
-			void* remote = data->parent->queue.enqueueMapBuffer(*(data->remote), CL_TRUE, CL_MAP_READ, data->remoteOffset, data->totalLen);
+			cl::Event mapEvent;
+			void* remote = data->parent->queue.enqueueMapBuffer(*(data->remote), CL_TRUE, CL_MAP_READ, data->remoteOffset, data->totalLen, NULL, &mapEvent);
+			data->parent->trace_event("download", mapEvent);
 			data->cksumSuccess = data->gf->copy_cksum_check(data->local, remote, data->sliceLen);
 			data->parent->queue.enqueueUnmapMemObject(*(data->remote), remote);
 			NOTIFY_DONE(data, _queueRecv, data->promOut, data->cksumSuccess);
 		} else {
-			if(data->local) {
+			if(data->local && data->remoteMapped) {
+				data->gf->copy_cksum(data->remoteMapped, data->local, data->srcLen, data->sliceLen);
+			} else if(data->local) {
 				void* remote = data->parent->queue.enqueueMapBuffer(*(data->remote), CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, data->remoteOffset, data->totalLen);
 				data->gf->copy_cksum(remote, data->local, data->srcLen, data->sliceLen);
 				data->parent->queue.enqueueUnmapMemObject(*(data->remote), remote);
@@ -321,6 +440,7 @@ FUTURE_RETURN_T PAR2ProcOCL::_addInput(const void* buffer, size_t size, T inputN
 	data->parent = this;
 	data->remote = &area.input;
 	data->remoteOffset = currentStagingInputs * sliceSizeAligned;
+	data->remoteMapped = area.mapped ? static_cast<char*>(area.mapped) + data->remoteOffset : nullptr;
 	data->sliceLen = sliceSize;
 	data->totalLen = sliceSizeCksum;
 	data->gf = gf.get();
@@ -370,9 +490,14 @@ void PAR2ProcOCL::dummyInput(uint16_t inputNum, bool flush) {
 }
 
 bool PAR2ProcOCL::fillInput(const void* buffer) {
-	void* remote = queue.enqueueMapBuffer(staging[currentStagingArea].input, CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, currentStagingInputs * sliceSizeAligned, sliceSizeAligned);
-	gf->copy_cksum(remote, buffer, sliceSize, sliceSize);
-	queue.enqueueUnmapMemObject(staging[currentStagingArea].input, remote);
+	auto& area = staging[currentStagingArea];
+	if(area.mapped) {
+		gf->copy_cksum(static_cast<char*>(area.mapped) + currentStagingInputs * sliceSizeAligned, buffer, sliceSize, sliceSize);
+	} else {
+		void* remote = queue.enqueueMapBuffer(area.input, CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, currentStagingInputs * sliceSizeAligned, sliceSizeAligned);
+		gf->copy_cksum(remote, buffer, sliceSize, sliceSize);
+		queue.enqueueUnmapMemObject(area.input, remote);
+	}
 	
 	if(++currentStagingInputs == inputBatchSize) {
 		currentStagingInputs = 0;
@@ -446,8 +571,9 @@ FUTURE_RETURN_BOOL_T PAR2ProcOCL::getOutput(unsigned index, void* output  IF_LIB
 	struct transfer_data_ocl* data = new struct transfer_data_ocl;
 	data->finish = true;
 	data->parent = this;
-	data->remote = &buffer_output;
-	data->remoteOffset = index*sliceSizeAligned;
+	data->remote = &shards[index / outputsPerShard].output;
+	data->remoteOffset = (index % outputsPerShard)*sliceSizeAligned;
+	data->remoteMapped = nullptr; // for zero-copy, mapping the output doesn't involve a transfer
 	data->sliceLen = sliceSize;
 	data->totalLen = sliceSizeAligned;
 	data->gf = gf.get();
@@ -493,28 +619,62 @@ static void CL_CALLBACK kernel_event_callback(cl_event, cl_int, void* _req) {
 #endif
 }
 
-void PAR2ProcOCL::run_kernel(unsigned buf, unsigned numInputs) {
+// queues up processing of a staging area; area.event is set to signal its completion
+void PAR2ProcOCL::enqueue_batch(unsigned buf, unsigned numInputs) {
 	auto& area = staging[buf];
-	// transfer coefficient list
-	cl::Event coeffEvent;
-	queue.enqueueWriteBuffer(area.coeffs, CL_FALSE, 0, inputBatchSize * (coeffType!=GF16OCL_COEFF_NORMAL ? 1 : outputExponents.size()) * sizeof(uint16_t), area.procCoeffs.data(), NULL, &coeffEvent);
-	queueEvents.push_back(coeffEvent);
-	
-	// invoke kernel
-	cl::Kernel* kernel;
-	if(numInputs == inputBatchSize) {
-		kernel = processingAdd ? &kernelMulAdd : &kernelMul;
-	} else { // incomplete kernel -> need to pass in number of inputs to read from
-		kernel = processingAdd ? &kernelMulAddLast : &kernelMulLast;
-		kernel->setArg<cl_ushort>(3, numInputs);
+	// transfer coefficient list(s)
+	size_t coeffsPerBuffer = inputBatchSize * (coeffType!=GF16OCL_COEFF_NORMAL ? 1 : outputsPerShard);
+	for(unsigned i=0; i<area.coeffs.size(); i++) {
+		cl::Event coeffEvent;
+		queue.enqueueWriteBuffer(area.coeffs[i], CL_FALSE, 0, coeffsPerBuffer * sizeof(uint16_t), area.procCoeffs.data() + i*coeffsPerBuffer, NULL, &coeffEvent);
+		queueEvents.push_back(coeffEvent);
+	}
+	if(area.host && area.mapped) {
+		// hand the (zero-copy) input over to the device
+		cl::Event unmapEvent;
+		queue.enqueueUnmapMemObject(area.input, area.mapped, NULL, &unmapEvent);
+		trace_event("upload", unmapEvent);
+		queueEvents.push_back(unmapEvent);
+		area.mapped = nullptr;
+	} else if(area.mapped) {
+		// copy inputs from the pinned buffer on the transfer queue, so that this overlaps with any kernel still running; the kernel waits on it
+		// the pinned buffer isn't written to again until this area is released, which only happens after the kernel completes
+		cl::Event uploadEvent;
+		transferQueue.enqueueWriteBuffer(area.input, CL_FALSE, 0, numInputs*sliceSizeAligned, area.mapped, NULL, &uploadEvent);
+		transferQueue.flush();
+		trace_event("upload", uploadEvent);
+		queueEvents.push_back(uploadEvent);
 	}
 	
+	// invoke kernel on each output shard; as the queue is in-order, the last kernel's event marks completion of all of them
+	for(unsigned s=0; s<shards.size(); s++) {
+		auto& shard = shards[s];
+		cl::Kernel* kernel;
+		if(numInputs == inputBatchSize) {
+			kernel = processingAdd ? &shard.kernelMulAdd : &shard.kernelMul;
+		} else { // incomplete kernel -> need to pass in number of inputs to read from
+			kernel = processingAdd ? &shard.kernelMulAddLast : &shard.kernelMulLast;
+			kernel->setArg<cl_ushort>(3, numInputs);
+		}
+		
+		kernel->setArg(1, area.input);
+		kernel->setArg(2, area.coeffs[coeffType!=GF16OCL_COEFF_NORMAL ? 0 : s]);
+		// TODO: try-catch to detect errors (e.g. out of resources)
+		queue.enqueueNDRangeKernel(*kernel, cl::NullRange, processRange, workGroupRange, &queueEvents, &area.event);
+		trace_event("compute", area.event);
+		queueEvents.clear(); // for coeffType!=GF16OCL_COEFF_NORMAL, assume that the outputs are transferred by the time we enqueue the next kernel
+	}
 	processingAdd = true;
-	kernel->setArg(1, area.input);
-	kernel->setArg(2, area.coeffs);
-	// TODO: try-catch to detect errors (e.g. out of resources)
-	queue.enqueueNDRangeKernel(*kernel, cl::NullRange, processRange, workGroupRange, &queueEvents, &area.event);
-	queueEvents.clear(); // for coeffType!=GF16OCL_COEFF_NORMAL, assume that the outputs are transferred by the time we enqueue the next kernel
+	if(area.host) {
+		// map the input back once the kernel is done with it; the area is only released when this completes, so that the mapping is ready to be written to
+		std::vector<cl::Event> kernelEvent(1, area.event);
+		area.mapped = queue.enqueueMapBuffer(area.input, CL_FALSE, CL_MAP_WRITE_INVALIDATE_REGION, 0, inputBatchSize*sliceSizeAligned, &kernelEvent, &area.event);
+	}
+}
+
+void PAR2ProcOCL::run_kernel(unsigned buf, unsigned numInputs) {
+	auto& area = staging[buf];
+	enqueue_batch(buf, numInputs);
 	
 	// when kernel finishes
 	auto* req = new compute_req;
@@ -608,6 +768,7 @@ size_t GF16OCL_DeviceInfo::getWGSize(const cl::Context& context, const cl::Devic
 GF16OCL_DeviceInfo::GF16OCL_DeviceInfo(int _id, const cl::Device& device) {
 	id = _id;
 	name = device.getInfo<CL_DEVICE_NAME>();
+	driverVersion = device.getInfo<CL_DRIVER_VERSION>();
 	vendorId = device.getInfo<CL_DEVICE_VENDOR_ID>();
 	type = device.getInfo<CL_DEVICE_TYPE>();
 	available = device.getInfo<CL_DEVICE_AVAILABLE>() && device.getInfo<CL_DEVICE_COMPILER_AVAILABLE>();
@@ -10,6 +10,7 @@
 #include <CL/cl.hpp>
 #include "gf16mul.h"
 #include <memory>
+#include <mutex>
 
 
 enum Galois16OCLMethods {
@@ -26,6 +27,12 @@ enum Galois16OCLMethods {
 	GF16OCL_LOG_TINY,
 	GF16OCL_LOG_SMALL_LMEM,
 	GF16OCL_LOG_TINY_LMEM,
+	GF16OCL_LOOKUP_WIDE,
+	GF16OCL_LOOKUP_HALF_WIDE,
+	GF16OCL_LOOKUP_ASYNC,
+	GF16OCL_LOOKUP_HALF_ASYNC,
+	GF16OCL_LOG_WIDE,
+	GF16OCL_LOG_ASYNC,
 	GF16OCL_BY2 // reference; will remove
 	//GF16OCL_SPLITMUL
 };
@@ -43,6 +50,12 @@ static const char* Galois16OCLMethodsText[] = {
 	"Log-TinyExp",
 	"Log-SmallExp (Local)",
 	"Log-TinyExp (Local)",
+	"Lookup (Wide)",
+	"Lookup Half (Wide)",
+	"Lookup (Async)",
+	"Lookup Half (Async)",
+	"Log (Wide)",
+	"Log (Async)",
 	"ByTwo"
 };
 
@@ -56,6 +69,7 @@ class GF16OCL_DeviceInfo {
 public:
 	int id;
 	std::string name;
+	std::string driverVersion;
 	unsigned vendorId;
 	cl_device_type type;
 	bool available;
@@ -88,14 +102,48 @@ typedef struct {
 	bool usesOutGrouping;
 } GF16OCL_MethodInfo;
 
+// a configuration tried by the autotuner; zero parameters mean the method's default
+typedef struct {
+	Galois16OCLMethods method;
+	unsigned inputBatch, iters, grouping, workGroup;
+	double time; // seconds per input slice, per output, on the probe
+	bool valid; // false if it failed to build/run, or gave incorrect results
+} GF16OCL_TuneResult;
+
 
 class PAR2ProcOCLStaging : public IPAR2ProcStaging {
 public:
 	cl::Buffer input;
-	cl::Buffer coeffs;
+	std::vector<cl::Buffer> coeffs; // one per output shard for normal coefficients, otherwise a single input log list shared by all shards
 	cl::Event event;
+	// zero-copy: host allocation backing `input`, and its mapping, which is held whenever a kernel isn't using it
+	void* host;
+	// otherwise: pinned host buffer that inputs are written into, which stays mapped; it's copied to `input` asynchronously before the kernel is run
+	cl::Buffer pinned;
+	void* mapped;
+	
+	PAR2ProcOCLStaging() : IPAR2ProcStaging(), host(nullptr), mapped(nullptr) {}
+};
+
+
+// a single allocation can't exceed CL_DEVICE_MAX_MEM_ALLOC_SIZE, so outputs are split across several buffers, each with its own set of kernels
+struct PAR2ProcOCLShard {
+	cl::Buffer output;
+	cl::Buffer outExp;
+	cl::Kernel kernelMulAdd;
+	cl::Kernel kernelMulAddLast;
+	cl::Kernel kernelMul;
+	cl::Kernel kernelMulLast;
+	void* outputHost; // zero-copy only
 	
-	PAR2ProcOCLStaging() : IPAR2ProcStaging() {}
+	PAR2ProcOCLShard() : outputHost(nullptr) {}
+};
+
+
+// a completed command, for showing how transfers overlap with compute; times are in microseconds, on the host's steady clock
+struct PAR2ProcOCLTraceSpan {
+	const char* stage; // "upload", "compute" or "download"
+	uint64_t start, end;
 };
 
 
@@ -108,19 +156,22 @@ class PAR2ProcOCL : public IPAR2ProcBackend {
 	cl::Device device;
 	int _deviceId;
 	cl::CommandQueue queue;
+	cl::CommandQueue transferQueue; // input uploads are issued on a separate queue, so that they can run whilst the previous batch is being computed
 	std::vector<cl::Event> queueEvents;
 	cl::NDRange processRange;
 	cl::NDRange workGroupRange;
-	cl::Kernel kernelMulAdd;
-	cl::Kernel kernelMulAddLast;
-	cl::Kernel kernelMul;
-	cl::Kernel kernelMulLast;
 	std::vector<PAR2ProcOCLStaging> staging;
 	// buffers
-	cl::Buffer buffer_outExp;
 	Galois16OCLCoeffType coeffType;
-	cl::Buffer buffer_output;
+	std::vector<PAR2ProcOCLShard> shards;
+	unsigned outputsPerShard; // the last shard is padded to this many outputs
+	size_t maxAllocLimit; // if non-zero, overrides the device's maximum allocation size, if lower
 	std::vector<cl::Buffer> extra_buffers;
+	// for devices which share memory with the host, buffers can be backed by host allocations, avoiding transfers
+	bool zeroCopy;
+	bool unifiedMemory;
+	size_t hostAlignment;
+	void free_host_buffers();
 	// to enable slice size adjustments
 	size_t allocatedSliceSize;
 	size_t bytesPerGroup;
@@ -133,16 +184,36 @@ class PAR2ProcOCL : public IPAR2ProcBackend {
 	static void transfer_slice(ThreadMessageQueue<void*>& q);
 	
 	
+	// timeline tracing; requires the queues to have profiling enabled
+	bool tracing;
+	std::mutex traceMutex;
+	struct TraceEntry {
+		const char* stage;
+		cl::Event event;
+		uint64_t hostQueued;
+	};
+	std::vector<TraceEntry> traceEntries;
+	void create_queues();
+	void trace_event(const char* stage, const cl::Event& event);
+	
+	// compiled programs are cached here, if set
+	std::string cacheDir;
+	std::string cache_key(Galois16OCLMethods method, const char* params, const std::string& source) const;
+	double buildTime; // seconds taken to compile (or load) the last program
+	bool buildCached;
+	
 	// remembered setup params
 	Galois16OCLMethods _setupMethod;
-	unsigned _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping;
+	unsigned _setupTargetInputBatch, _setupTargetIters, _setupTargetGrouping, _setupTargetWorkGroup;
 	
 	void set_coeffs(PAR2ProcOCLStaging& area, unsigned idx, uint16_t inputNum);
 	void set_coeffs(PAR2ProcOCLStaging& area, unsigned idx, const uint16_t* inputCoeffs);
 	template<typename T> FUTURE_RETURN_T _addInput(const void* buffer, size_t size, T inputNumOrCoeffs, bool flush  IF_LIBUV(, const PAR2ProcPlainCb& cb));
 	
-	bool setup_kernels(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, bool outputSequential);
+	bool setup_kernels(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, unsigned targetWorkGroup, bool outputSequential);
+	void enqueue_batch(unsigned buf, unsigned numInputs);
 	void run_kernel(unsigned buf, unsigned numInputs) override;
+	double probe(unsigned iterations);
 	
 	
 	cl::Context context;
@@ -188,7 +259,7 @@ public:
 	explicit PAR2ProcOCL(IF_LIBUV(uv_loop_t* _loop,) int platformId = -1, int deviceId = -1, int stagingAreas = 2);
 	~PAR2ProcOCL();
 	void setSliceSize(size_t _sliceSize) override;
-	bool init(Galois16OCLMethods method = GF16OCL_AUTO, unsigned targetInputBatch=0, unsigned targetIters=0, unsigned targetGrouping=0, Galois16Methods cksumMethod = GF16_AUTO);
+	bool init(Galois16OCLMethods method = GF16OCL_AUTO, unsigned targetInputBatch=0, unsigned targetIters=0, unsigned targetGrouping=0, Galois16Methods cksumMethod = GF16_AUTO, unsigned targetWorkGroup=0);
 	PAR2ProcBackendAddResult canAdd() const override;
 	FUTURE_RETURN_T addInput(const void* buffer, size_t size, uint16_t inputNum, bool flush  IF_LIBUV(, const PAR2ProcPlainCb& cb)) override;
 	FUTURE_RETURN_T addInput(const void* buffer, size_t size, const uint16_t* coeffs, bool flush  IF_LIBUV(, const PAR2ProcPlainCb& cb)) override;
@@ -208,6 +279,31 @@ public:
 	inline unsigned getOutputGrouping() const {
 		return outputsPerGroup;
 	}
+	inline bool isZeroCopy() const {
+		return zeroCopy;
+	}
+	inline unsigned getOutputBuffers() const {
+		return shards.size();
+	}
+	// must be called before init(); mostly useful for testing output sharding on devices with a large allocation limit
+	inline void setMaxAllocation(size_t limit) {
+		maxAllocLimit = limit;
+	}
+	// must be called before init(); backs buffers with host memory if the device shares it with the host, instead of allocating them on the device
+	inline void enableZeroCopy() {
+		zeroCopy = unifiedMemory;
+	}
+	bool setTrace(bool enable);
+	std::vector<PAR2ProcOCLTraceSpan> getTrace(); // returns (and clears) all traced commands; only call once they've completed
+	inline void setCacheDir(const std::string& dir) {
+		cacheDir = dir;
+	}
+	inline double getBuildTime() const {
+		return buildTime;
+	}
+	inline bool isBuildCached() const {
+		return buildCached;
+	}
 	
 	void _deinit() override;
 	void freeProcessingMem() override {}
@@ -242,6 +338,8 @@ public:
 	
 	Galois16OCLMethods default_method() const;
 	static std::vector<Galois16OCLMethods> availableMethods(int platformId = -1, int deviceId = -1);
+	// tries various configurations on a device, returning those tried, fastest valid first; blocks until done
+	static std::vector<GF16OCL_TuneResult> autotune(int platformId, int deviceId, const std::string& cacheDir = "", size_t probeSize = 1048576, unsigned probeOutputs = 32);
 	static inline const char* methodToText(Galois16OCLMethods m) {
 		return Galois16OCLMethodsText[(int)m];
 	}
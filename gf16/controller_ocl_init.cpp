@@ -5,6 +5,15 @@
 #include <sstream> // std::stringstream
 #include "controller_ocl.h"
 #include "gf16_global.h" // GF16_POLYNOMIAL
+#include "../src/platform.h" // ALIGN_ALLOC
+#include <chrono>
+#include <atomic>
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+# include <process.h> // _getpid
+# define getpid _getpid
+#else
+# include <unistd.h> // getpid
+#endif
 
 // for viewing compiled code, uncomment
 //#define DUMP_ASM
@@ -594,6 +603,24 @@ STRINGIFY(
 "	                                                                                             \n"\
 "	val_t result[OUTPUT_GROUPING][COL_GROUP_ITERS];                                              \n"\
 "	val_t val[COL_GROUP_ITERS];                                                                  \n"\
+"	#ifdef NOLUT_WIDE                                                                            \n"\
+"	#pragma unroll                                                                               \n"\
+"	for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter+=WIDE_WORDS) {                               \n"\
+"		wide_val_t w;                                                                            \n"\
+"		#ifdef DO_CACHE                                                                          \n"\
+"			w.v = VLOAD_WIDE(0, srcBase + iter);                                                 \n"\
+"			#pragma unroll                                                                       \n"\
+"			for(nat_uint x=0; x<WIDE_WORDS; x++)                                                 \n"\
+"				w.s[x] = val[iter+x] = READ_SRC(w.s, x);                                         \n"\
+"			if(DO_CACHE == 1) VSTORE_WIDE(w.v, 0, cache + col+iter);                             \n"\
+"		#else                                                                                    \n"\
+"			w.v = VLOAD_WIDE(0, cache + col+iter);                                               \n"\
+"			#pragma unroll                                                                       \n"\
+"			for(nat_uint x=0; x<WIDE_WORDS; x++)                                                 \n"\
+"				val[iter+x] = w.s[x];                                                            \n"\
+"		#endif                                                                                   \n"\
+"	}                                                                                            \n"\
+"	#else                                                                                        \n"\
 "	#pragma unroll                                                                               \n"\
 "	for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter++) {                                         \n"\
 "		#ifdef DO_CACHE                                                                          \n"\
@@ -603,6 +630,7 @@ STRINGIFY(
 "			val[iter] = cache[col+iter];                                                         \n"\
 "		#endif                                                                                   \n"\
 "	}                                                                                            \n"\
+"	#endif                                                                                       \n"\
 "	                                                                                             \n"\
 "	nat_uint curCoeff;                                                                           \n"\
 "	#ifdef GFMAT_COEFF_SEQUENTIAL                                                                \n"\
@@ -628,6 +656,24 @@ STRINGIFY(
 "	                                                                                             \n"\
 "	for (nat_uint i = 1; i < _numInputs; i++) {                                                  \n"\
 "		srcBase += len;                                                                          \n"\
+"		#ifdef NOLUT_WIDE                                                                        \n"\
+"		#pragma unroll                                                                           \n"\
+"		for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter+=WIDE_WORDS) {                           \n"\
+"			wide_val_t w;                                                                        \n"\
+"			#ifdef DO_CACHE                                                                      \n"\
+"				w.v = VLOAD_WIDE(0, srcBase + iter);                                             \n"\
+"				#pragma unroll                                                                   \n"\
+"				for(nat_uint x=0; x<WIDE_WORDS; x++)                                             \n"\
+"					w.s[x] = val[iter+x] = READ_SRC(w.s, x);                                     \n"\
+"				if(DO_CACHE == 1) VSTORE_WIDE(w.v, 0, cache + i*COL_GROUP_SIZE*COL_GROUP_ITERS + col+iter);\n"\
+"			#else                                                                                \n"\
+"				w.v = VLOAD_WIDE(0, cache + i*COL_GROUP_SIZE*COL_GROUP_ITERS + col+iter);        \n"\
+"				#pragma unroll                                                                   \n"\
+"				for(nat_uint x=0; x<WIDE_WORDS; x++)                                             \n"\
+"					val[iter+x] = w.s[x];                                                        \n"\
+"			#endif                                                                               \n"\
+"		}                                                                                        \n"\
+"		#else                                                                                    \n"\
 "		#pragma unroll                                                                           \n"\
 "		for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter++) {                                     \n"\
 "			#ifdef DO_CACHE                                                                      \n"\
@@ -637,6 +683,7 @@ STRINGIFY(
 "				val[iter] = cache[i*COL_GROUP_SIZE*COL_GROUP_ITERS + col+iter];                  \n"\
 "			#endif                                                                               \n"\
 "		}                                                                                        \n"\
+"		#endif                                                                                   \n"\
 "		                                                                                         \n"\
 "		#ifdef GFMAT_COEFF_SEQUENTIAL                                                            \n"\
 "			curCoeff = gfmat_calc_coeff_log(outExp+outBlk, coeff[i]);                            \n"\
@@ -662,10 +709,21 @@ STRINGIFY(
 "	__global val_t* dstBase = dst + WBUF_REF(outBlk, len, globalCol);                            \n"\
 "	#pragma unroll                                                                               \n"\
 "	for (nat_uint o = 0; o < numOutputs; o++) {                                                  \n"\
+"		#ifdef NOLUT_WIDE                                                                        \n"\
+"		#pragma unroll                                                                           \n"\
+"		for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter+=WIDE_WORDS) {                           \n"\
+"			wide_val_t w;                                                                        \n"\
+"			#pragma unroll                                                                       \n"\
+"			for(nat_uint x=0; x<WIDE_WORDS; x++)                                                 \n"\
+"				w.s[x] = result[o][iter+x];                                                      \n"\
+"			WRITE_DST_WIDE(dstBase + iter, w.v);                                                 \n"\
+"		}                                                                                        \n"\
+"		#else                                                                                    \n"\
 "		#pragma unroll                                                                           \n"\
 "		for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter++) {                                     \n"\
 "			WRITE_DST(dstBase, iter, result[o][iter]);                                           \n"\
 "		}                                                                                        \n"\
+"		#endif                                                                                   \n"\
 "		dstBase += len;                                                                          \n"\
 "	}                                                                                            \n"\
 "}                                                                                               \n"
@@ -684,6 +742,15 @@ const static char _ocl_kernel_nolut_funcs[] =
 "#else\n"
 " #define WRITE_DST(dst, idx, val) dst[idx] ^= val\n"
 "#endif\n"
+"#ifdef NOLUT_WIDE\n"
+" #ifdef WRITE_DST_OVERRIDE\n"
+"  #error Wide loads not supported with this method\n"
+" #elif defined(MUL_ONLY)\n"
+"  #define WRITE_DST_WIDE(dst, val) VSTORE_WIDE(val, 0, dst)\n"
+" #else\n"
+"  #define WRITE_DST_WIDE(dst, val) VSTORE_WIDE(VLOAD_WIDE(0, dst) ^ (val), 0, dst)\n"
+" #endif\n"
+"#endif\n"
 "#ifdef OCL_METHOD_LOG\n"
 " #define GET_COEFF(o, i) gfmat_calc_coeff_log(outExp[o], coeff[i])\n"
 "#else\n"
@@ -742,6 +809,36 @@ const static char _ocl_kernel_nolut[] = STRINGIFY({
 	) "\n#endif\n" STRINGIFY(
 	
 	__local val_t cache[SUBMIT_INPUTS*COL_GROUP_SIZE*COL_GROUP_ITERS];
+	) "\n#ifdef NOLUT_ASYNC\n" STRINGIFY(
+	// copy the workgroup's tile of every input into the cache up front, then convert each thread's words in place (e.g. into log form), so every output group reads from the cache
+	{
+		const memsize_t len = get_global_size(0)*COL_GROUP_ITERS;
+		__global const val_t* srcTile = src + get_group_id(0)*COL_GROUP_SIZE*COL_GROUP_ITERS;
+		event_t copyEvent = 0;
+		for(nat_uint input = 0; input < numInputs; input++) {
+			copyEvent = async_work_group_copy(cache + input*COL_GROUP_SIZE*COL_GROUP_ITERS, srcTile, COL_GROUP_SIZE*COL_GROUP_ITERS, copyEvent);
+			srcTile += len;
+		}
+		wait_group_events(1, &copyEvent);
+		barrier(CLK_LOCAL_MEM_FENCE);
+		
+		__local val_t* cacheCol = cache + get_local_id(0)*COL_GROUP_ITERS;
+		for(nat_uint input = 0; input < numInputs; input++) {
+			for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter++)
+				cacheCol[iter] = READ_SRC(cacheCol, iter);
+			cacheCol += COL_GROUP_SIZE*COL_GROUP_ITERS;
+		}
+	}
+	
+	) "\n#if NUM_OUTPUTS <= OUTPUTS_PER_THREAD\n" STRINGIFY(
+	const nat_uint outEnd = NUM_OUTPUTS;
+	) "\n#else\n" STRINGIFY(
+	const nat_uint outEnd = outBlk + (isPartialOutputsThread ? NUM_OUTPUTS % OUTPUTS_PER_THREAD : OUTPUTS_PER_THREAD);
+	) "\n#endif\n" STRINGIFY(
+	for(; outBlk < outEnd; outBlk += OUTPUT_GROUPING) {
+		KERNFN(mulgroup_read)(dst, src, lcoeff, outBlk, (outEnd - outBlk < OUTPUT_GROUPING ? outEnd - outBlk : OUTPUT_GROUPING), numInputs, cache  EX_TABLE_ARGS);
+	}
+	) "\n#else\n" STRINGIFY(
 	if(!isPartialOutputsThread) {
 		) "\n#if OUTPUTS_PER_THREAD > OUTPUT_GROUPING\n" STRINGIFY(
 		
@@ -784,7 +881,8 @@ const static char _ocl_kernel_nolut[] = STRINGIFY({
 		) "\n#endif\n" STRINGIFY(
 		
 	}
-}) "\n#undef WRITE_DST\n";
+	) "\n#endif\n" STRINGIFY(
+}) "\n#undef WRITE_DST\n#undef WRITE_DST_WIDE\n";
 // strategy which caches several inputs, uses dot-product operations to a single output, and a LUT per coefficient
 const static char _ocl_kernel_cachelut[] =
 "#ifdef WRITE_DST_OVERRIDE\n"
@@ -867,6 +965,165 @@ STRINGIFY({
 	}
 }) "\n#undef WRITE_DST\n";
 
+// as CACHELUT, but the workgroup's tile of every input is copied into the cache with async_work_group_copy up front, overlapping with LUT generation
+const static char _ocl_kernel_cachelut_async[] =
+"#ifdef MUL_ONLY\n"
+" #define WRITE_DST(dst, idx, val) dst[idx] = val\n"
+"#else\n"
+" #define WRITE_DST(dst, idx, val) dst[idx] ^= val\n"
+"#endif\n"
+STRINGIFY({
+	const uint colLocal = get_local_id(0);
+	const memsize_t groupCol = get_group_id(0)*COL_GROUP_SIZE*COL_GROUP_ITERS;
+	const memsize_t len = get_global_size(0) * COL_GROUP_ITERS;
+	
+	) "\n#if NUM_OUTPUTS <= OUTPUTS_PER_THREAD\n" STRINGIFY(
+		const nat_uint outputsThisThread = NUM_OUTPUTS;
+		const nat_uint outBase = 0;
+		__global val_t* dstBase = dst + groupCol + colLocal;
+	) "\n#else\n" STRINGIFY(
+		const nat_uint outBase = get_global_id(1) * OUTPUTS_PER_THREAD;
+		) "\n#if NUM_OUTPUTS % OUTPUTS_PER_THREAD == 0\n" STRINGIFY(
+		const nat_uint outputsThisThread = OUTPUTS_PER_THREAD;
+		) "\n#else\n" STRINGIFY(
+		const nat_uint outputsThisThread = (get_global_id(1)+1 == get_global_size(1) ? NUM_OUTPUTS % OUTPUTS_PER_THREAD : OUTPUTS_PER_THREAD);
+		) "\n#endif\n" STRINGIFY(
+		__global val_t* dstBase = dst + WBUF_REF(outBase, len, groupCol + colLocal);
+	) "\n#endif\n" STRINGIFY(
+	
+	__local val_t cache[SUBMIT_INPUTS][COL_GROUP_SIZE*COL_GROUP_ITERS];
+	event_t copyEvent = 0;
+	__global const val_t* srcTile = src + groupCol;
+	for (nat_uint input = 0; input < numInputs; input++) {
+		copyEvent = async_work_group_copy(cache[input], srcTile, COL_GROUP_SIZE*COL_GROUP_ITERS, copyEvent);
+		srcTile += len;
+	}
+	LUT_DECLARATION(lut_table, SUBMIT_INPUTS);
+	LUT_GENERATE(lut_table, coeff + COBUF_REF(outBase, 0u), numInputs);
+	wait_group_events(1, &copyEvent);
+	barrier(CLK_LOCAL_MEM_FENCE);
+	
+	for(nat_uint output=0; output<outputsThisThread; output++) {
+		if(output > 0)
+			LUT_GENERATE(lut_table, coeff + COBUF_REF(outBase+output, 0u), numInputs);
+		for(nat_uint iter=0; iter<COL_GROUP_ITERS; iter++) {
+			uint iterBase = iter*COL_GROUP_SIZE;
+			val_t result = LUT_MULTIPLY(LUT_REF(lut_table, 0u), cache[0][colLocal + iterBase]);
+			
+			) "\n#ifdef numInputs\n#pragma unroll\n#endif\n" STRINGIFY(
+			for (ushort input = 1; input < numInputs; input++) {
+				result ^= LUT_MULTIPLY(LUT_REF(lut_table, input), cache[input][colLocal + iterBase]);
+			}
+			WRITE_DST(dstBase, iterBase, result);
+		}
+		dstBase += len;
+	}
+}) "\n#undef WRITE_DST\n";
+
+// for CACHELUT_WIDE: inputs/outputs are accessed 16 bytes at a time
+const static char _ocl_wide_defines[] =
+"#if VECT_WIDTH == 1\n"
+" #define WIDE_WORDS 8\n"
+" #define wide_t ushort8\n"
+" #define VLOAD_WIDE vload8\n"
+" #define VSTORE_WIDE vstore8\n"
+"#elif VECT_WIDTH == 2\n"
+" #define WIDE_WORDS 4\n"
+" #define wide_t uint4\n"
+" #define VLOAD_WIDE vload4\n"
+" #define VSTORE_WIDE vstore4\n"
+"#elif VECT_WIDTH == 4\n"
+" #define WIDE_WORDS 2\n"
+" #define wide_t ulong2\n"
+" #define VLOAD_WIDE vload2\n"
+" #define VSTORE_WIDE vstore2\n"
+"#else\n"
+" #error Vector width not implemented\n"
+"#endif\n"
+"#if COL_GROUP_ITERS % WIDE_WORDS\n"
+" #error Iteration count must be a multiple of the wide load\n"
+"#endif\n"
+"typedef union { wide_t v; val_t s[WIDE_WORDS]; } wide_val_t;\n";
+
+// as CACHELUT, but each thread handles WIDE_WORDS consecutive words, so that they can be read/written with a single 16-byte access
+// the workgroup still covers a contiguous tile, so accesses stay coalesced; only the mapping of threads to words within it changes
+const static char _ocl_kernel_cachelut_wide[] =
+"#ifdef MUL_ONLY\n"
+" #define WRITE_DST_WIDE(dst, val) VSTORE_WIDE(val, 0, dst)\n"
+"#else\n"
+" #define WRITE_DST_WIDE(dst, val) VSTORE_WIDE(VLOAD_WIDE(0, dst) ^ (val), 0, dst)\n"
+"#endif\n"
+STRINGIFY({
+	const uint colLocal = get_local_id(0) * WIDE_WORDS;
+	const memsize_t groupCol = get_group_id(0)*COL_GROUP_SIZE*COL_GROUP_ITERS;
+	const memsize_t len = get_global_size(0) * COL_GROUP_ITERS;
+	
+	) "\n#if NUM_OUTPUTS <= OUTPUTS_PER_THREAD\n" STRINGIFY(
+		const nat_uint outputsThisThread = NUM_OUTPUTS;
+		const nat_uint outBase = 0;
+		__global val_t* dstBase = dst + groupCol + colLocal;
+	) "\n#else\n" STRINGIFY(
+		const nat_uint outBase = get_global_id(1) * OUTPUTS_PER_THREAD;
+		) "\n#if NUM_OUTPUTS % OUTPUTS_PER_THREAD == 0\n" STRINGIFY(
+		const nat_uint outputsThisThread = OUTPUTS_PER_THREAD;
+		) "\n#else\n" STRINGIFY(
+		const nat_uint outputsThisThread = (get_global_id(1)+1 == get_global_size(1) ? NUM_OUTPUTS % OUTPUTS_PER_THREAD : OUTPUTS_PER_THREAD);
+		) "\n#endif\n" STRINGIFY(
+		__global val_t* dstBase = dst + WBUF_REF(outBase, len, groupCol + colLocal);
+	) "\n#endif\n" STRINGIFY(
+	__global const val_t* srcBase = src + groupCol + colLocal;
+	
+	__local val_t cache[SUBMIT_INPUTS][COL_GROUP_SIZE*COL_GROUP_ITERS];
+	LUT_DECLARATION(lut_table, SUBMIT_INPUTS);
+	LUT_GENERATE(lut_table, coeff + COBUF_REF(outBase, 0u), numInputs);
+	
+	for(uint iter=0; iter<COL_GROUP_ITERS; iter+=WIDE_WORDS) { // first iteration -> copy loaded data to cache
+		uint iterBase = iter*COL_GROUP_SIZE;
+		
+		wide_val_t val, result;
+		val.v = VLOAD_WIDE(0, srcBase + iterBase);
+		VSTORE_WIDE(val.v, 0, cache[0] + colLocal + iterBase);
+		) "\n#pragma unroll\n" STRINGIFY(
+		for(uint w=0; w<WIDE_WORDS; w++)
+			result.s[w] = LUT_MULTIPLY(LUT_REF(lut_table, 0u), val.s[w]);
+		
+		__global const val_t* srcIterBase = srcBase + iterBase;
+		) "\n#ifdef numInputs\n#pragma unroll\n#endif\n" STRINGIFY(
+		for (nat_uint input = 1; input < numInputs; input++) {
+			srcIterBase += len;
+			val.v = VLOAD_WIDE(0, srcIterBase);
+			VSTORE_WIDE(val.v, 0, cache[input] + colLocal + iterBase);
+			) "\n#pragma unroll\n" STRINGIFY(
+			for(uint w=0; w<WIDE_WORDS; w++)
+				result.s[w] ^= LUT_MULTIPLY(LUT_REF(lut_table, input), val.s[w]);
+		}
+		WRITE_DST_WIDE(dstBase + iterBase, result.v);
+	}
+	
+	// subsequent iterations: use cache
+	for(nat_uint output=1; output<outputsThisThread; output++) {
+		dstBase += len;
+		LUT_GENERATE(lut_table, coeff + COBUF_REF(outBase+output, 0u), numInputs);
+		for(uint iter=0; iter<COL_GROUP_ITERS; iter+=WIDE_WORDS) {
+			uint iterBase = iter*COL_GROUP_SIZE;
+			wide_val_t val, result;
+			val.v = VLOAD_WIDE(0, cache[0] + colLocal + iterBase);
+			) "\n#pragma unroll\n" STRINGIFY(
+			for(uint w=0; w<WIDE_WORDS; w++)
+				result.s[w] = LUT_MULTIPLY(LUT_REF(lut_table, 0u), val.s[w]);
+			
+			) "\n#ifdef numInputs\n#pragma unroll\n#endif\n" STRINGIFY(
+			for (ushort input = 1; input < numInputs; input++) {
+				val.v = VLOAD_WIDE(0, cache[input] + colLocal + iterBase);
+				) "\n#pragma unroll\n" STRINGIFY(
+				for(uint w=0; w<WIDE_WORDS; w++)
+					result.s[w] ^= LUT_MULTIPLY(LUT_REF(lut_table, input), val.s[w]);
+			}
+			WRITE_DST_WIDE(dstBase + iterBase, result.v);
+		}
+	}
+}) "\n#undef WRITE_DST_WIDE\n";
+
 // strategy where inputs are pulled from global memory (not cached), multiplies to multiple outputs, and requires a LUT per coefficient
 // seems to generally be less efficient that CACHELUT
 const static char _ocl_kernel_lut_funcs[] =
@@ -1017,10 +1274,16 @@ GF16OCL_MethodInfo PAR2ProcOCL::info(Galois16OCLMethods method) {
 	case GF16OCL_LOG_TINY:
 	case GF16OCL_LOG_SMALL_LMEM:
 	case GF16OCL_LOG_TINY_LMEM:
+	case GF16OCL_LOG_WIDE:
+	case GF16OCL_LOG_ASYNC:
 		ret.idealInBatch = 8;
 	break;
 	case GF16OCL_LOOKUP:
 	case GF16OCL_LOOKUP_HALF:
+	case GF16OCL_LOOKUP_WIDE:
+	case GF16OCL_LOOKUP_HALF_WIDE:
+	case GF16OCL_LOOKUP_ASYNC:
+	case GF16OCL_LOOKUP_HALF_ASYNC:
 		ret.usesOutGrouping = false;
 		ret.idealInBatch = 4;
 		ret.idealIters = 4;
@@ -1036,12 +1299,105 @@ GF16OCL_MethodInfo PAR2ProcOCL::info(Galois16OCLMethods method) {
 	return ret;
 }
 
+// compiled programs are cached on disk, as compilation can take several seconds
+// files are named by a hash of everything except the platform/driver version, so that a driver update replaces its entry; the full key is stored in the file to detect this (and hash collisions)
+#define OCL_CACHE_MAGIC "ParParOCLCache1\n"
+static uint64_t ocl_cache_hash(const std::string& data, uint64_t h = 0xcbf29ce484222325ULL) {
+	// FNV-1a
+	for(unsigned char c : data) {
+		h ^= c;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+std::string PAR2ProcOCL::cache_key(Galois16OCLMethods method, const char* params, const std::string& source) const {
+	cl::Platform platform(device.getInfo<CL_DEVICE_PLATFORM>());
+	char sourceHash[17];
+	snprintf(sourceHash, sizeof(sourceHash), "%016llx", (unsigned long long)ocl_cache_hash(source));
+	std::stringstream key;
+	key << "platform=" << platform.getInfo<CL_PLATFORM_NAME>() << "\n"
+		<< "device=" << device.getInfo<CL_DEVICE_NAME>() << "\n"
+		<< "method=" << methodToText(method) << "\n"
+		<< "params=" << params << "\n" // includes grouping, iteration count, batch size etc
+		<< "source=" << sourceHash << "\n"
+		// the following only affect the key stored in the file
+		<< "platform_version=" << platform.getInfo<CL_PLATFORM_VERSION>() << "\n"
+		<< "driver=" << device.getInfo<CL_DRIVER_VERSION>() << "\n";
+	return key.str();
+}
+static std::string ocl_cache_path(const std::string& dir, const std::string& key) {
+	// exclude the version lines from the file name
+	size_t versionPos = key.find("platform_version=");
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)ocl_cache_hash(key.substr(0, versionPos)));
+	return dir + "/" + name;
+}
+static bool ocl_cache_read(const std::string& path, const std::string& key, std::vector<unsigned char>& binary) {
+	FILE* f = fopen(path.c_str(), "rb");
+	if(!f) return false;
+	bool success = false;
+	char magic[sizeof(OCL_CACHE_MAGIC)-1];
+	uint32_t keyLen;
+	uint64_t binLen;
+	if(fread(magic, 1, sizeof(magic), f) == sizeof(magic) && !memcmp(magic, OCL_CACHE_MAGIC, sizeof(magic))
+	&& fread(&keyLen, sizeof(keyLen), 1, f) == 1 && keyLen == key.length()) {
+		std::string fileKey(keyLen, '\0');
+		if(fread(&fileKey[0], 1, keyLen, f) == keyLen && fileKey == key
+		&& fread(&binLen, sizeof(binLen), 1, f) == 1 && binLen > 0 && binLen < 256*1048576) {
+			binary.resize(binLen);
+			success = fread(binary.data(), 1, binLen, f) == binLen;
+		}
+	}
+	fclose(f);
+	return success;
+}
+static void ocl_cache_write(const std::string& path, const std::string& key, const cl::Program& program) {
+	std::vector<char*> binaries;
+	std::vector<size_t> sizes;
+	try {
+		sizes = program.getInfo<CL_PROGRAM_BINARY_SIZES>();
+		binaries = program.getInfo<CL_PROGRAM_BINARIES>();
+	} catch(cl::Error const&) {
+		for(char* bin : binaries) delete[] bin;
+		return;
+	}
+	// program is only built for one device
+	if(binaries.size() == 1 && sizes.size() == 1 && binaries[0] && sizes[0]) {
+		// write to a temporary file first, so that a concurrent reader never sees a partial entry; the name is unique to this process and write, as other processes may be building the same program
+		static std::atomic<unsigned> tmpCounter(0);
+		char tmpSuffix[32];
+		snprintf(tmpSuffix, sizeof(tmpSuffix), ".%u.%u.tmp", (unsigned)getpid(), tmpCounter++);
+		std::string tmpPath = path + tmpSuffix;
+		FILE* f = fopen(tmpPath.c_str(), "wb");
+		if(f) {
+			uint32_t keyLen = key.length();
+			uint64_t binLen = sizes[0];
+			bool success = fwrite(OCL_CACHE_MAGIC, 1, sizeof(OCL_CACHE_MAGIC)-1, f) == sizeof(OCL_CACHE_MAGIC)-1
+				&& fwrite(&keyLen, sizeof(keyLen), 1, f) == 1
+				&& fwrite(key.data(), 1, keyLen, f) == keyLen
+				&& fwrite(&binLen, sizeof(binLen), 1, f) == 1
+				&& fwrite(binaries[0], 1, binLen, f) == binLen;
+			success = (fclose(f) == 0) && success;
+			if(success) {
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+				remove(path.c_str()); // Windows won't rename over an existing file; elsewhere, rename replaces it atomically
+#endif
+				success = rename(tmpPath.c_str(), path.c_str()) == 0;
+			}
+			if(!success) remove(tmpPath.c_str());
+		}
+	}
+	for(char* bin : binaries) delete[] bin;
+}
+
 // _sliceSize must be divisible by 2
-bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, bool outputSequential) {
+bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputBatch, unsigned targetIters, unsigned targetGrouping, unsigned targetWorkGroup, bool outputSequential) {
 	// TODO: get device info
-	// CL_DEVICE_HOST_UNIFIED_MEMORY (deprecated?)
 	// CL_DEVICE_ADDRESS_BITS (max referencable memory)
 	
+	// existing buffers must be released before their host memory can be freed
+	free_host_buffers();
+	
 	
 	unsigned infoShortVecSize = device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT>(); // seems to usually be the same as CL_DEVICE_NATIVE_VECTOR_WIDTH_SHORT
 	if(infoShortVecSize < 4) infoShortVecSize = 2; // assume all GPUs do 32-bit math efficiently (various nVidia platforms return 1, but 2 runs faster)
@@ -1057,19 +1413,27 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 		wgSize = wgSizeMultiple;
 #endif
 	if(wgSize > 8192) wgSize = 8192; // sanity check
+	if(targetWorkGroup && targetWorkGroup < wgSize)
+		wgSize = targetWorkGroup;
 	
 	size_t deviceAvailConstSize = device.getInfo<CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE>();
 	size_t deviceLocalSize = device.getInfo<CL_DEVICE_LOCAL_MEM_SIZE>() - 128; // subtract a little to allow some spare space if the device needs it
 	//size_t deviceGlobalSize = device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>(); // TODO: check sliceSizeCksum*numOutputs ?
+	size_t deviceMaxAlloc = device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>();
+	if(maxAllocLimit && maxAllocLimit < deviceMaxAlloc)
+		deviceMaxAlloc = maxAllocLimit;
 	
-	unsigned numOutputs = outputExponents.size();
-	unsigned outputsPerThread = numOutputs; // currently, process all outputs on every kernel invocation
+	unsigned totalOutputs = outputExponents.size();
+	unsigned numOutputs; // outputs per shard, set once the aligned slice size is known
+	unsigned outputsPerThread;
 	std::stringstream sourceStream;
 	
 	auto methInfo = info(method);
 	inputBatchSize = methInfo.idealInBatch;
 	unsigned groupIterations = methInfo.idealIters;
 	unsigned threadWordSize = infoShortVecSize*2;
+	bool wideLoad = (method == GF16OCL_LOOKUP_WIDE || method == GF16OCL_LOOKUP_HALF_WIDE || method == GF16OCL_LOG_WIDE);
+	unsigned itersMultiple = wideLoad ? 16/threadWordSize : 1; // each thread of the wide kernel handles 16 bytes at a time
 	unsigned sizePerWorkGroup = threadWordSize * wgSize;
 	outputsPerGroup = 8; // for nolut kernel; have seen some cards prefer '4' (on older cards?)
 	const char* kernelCode;
@@ -1146,6 +1510,8 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 	case GF16OCL_LOG_TINY:
 	case GF16OCL_LOG_SMALL_LMEM:
 	case GF16OCL_LOG_TINY_LMEM:
+	case GF16OCL_LOG_WIDE:
+	case GF16OCL_LOG_ASYNC:
 		coeffType = outputSequential ? GF16OCL_COEFF_LOG_SEQ : GF16OCL_COEFF_LOG;
 		
 		{
@@ -1157,8 +1523,9 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 		}
 		
 		while(1) {
-			if(inputBatchSize*sizePerWorkGroup > deviceLocalSize)
-				inputBatchSize = (unsigned)(deviceLocalSize / sizePerWorkGroup);
+			// the wide kernel needs at least `itersMultiple` iterations cached
+			if(inputBatchSize*sizePerWorkGroup*itersMultiple > deviceLocalSize)
+				inputBatchSize = (unsigned)(deviceLocalSize / (sizePerWorkGroup*itersMultiple));
 			
 			if(inputBatchSize < 1 && deviceLocalSize >= 2048) {
 				// try reducing workgroup if too large
@@ -1177,6 +1544,10 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 		kernelCode = _ocl_kernel_nolut;
 		kernelFuncs = _ocl_kernel_nolut_funcs;
 		sourceStream << "#define OCL_METHOD_LOG\n";
+		if(method == GF16OCL_LOG_WIDE)
+			sourceStream << "#define NOLUT_WIDE\n";
+		if(method == GF16OCL_LOG_ASYNC)
+			sourceStream << "#define NOLUT_ASYNC\n";
 		if(method == GF16OCL_LOG_SMALL || method == GF16OCL_LOG_SMALL2 || method == GF16OCL_LOG_SMALL_LMEM)
 			sourceStream << "#define OCL_METHOD_EXP_SMALL\n";
 		if(method == GF16OCL_LOG_TINY || method == GF16OCL_LOG_TINY_LMEM)
@@ -1189,6 +1560,10 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 	case GF16OCL_LOOKUP_HALF:
 	case GF16OCL_LOOKUP_NOCACHE:
 	case GF16OCL_LOOKUP_HALF_NOCACHE:
+	case GF16OCL_LOOKUP_WIDE:
+	case GF16OCL_LOOKUP_HALF_WIDE:
+	case GF16OCL_LOOKUP_ASYNC:
+	case GF16OCL_LOOKUP_HALF_ASYNC:
 	default:
 		if(method == GF16OCL_LOOKUP_NOCACHE || method == GF16OCL_LOOKUP_HALF_NOCACHE) {
 			unsigned tables = (unsigned)(deviceLocalSize / (method == GF16OCL_LOOKUP_HALF_NOCACHE ? 512 : 1024));
@@ -1207,14 +1582,15 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 			kernelCode = _ocl_kernel_lut;
 			kernelFuncs = _ocl_kernel_lut_funcs;
 		} else {
+			bool halfTable = (method == GF16OCL_LOOKUP_HALF || method == GF16OCL_LOOKUP_HALF_WIDE || method == GF16OCL_LOOKUP_HALF_ASYNC);
 			if(targetInputBatch) inputBatchSize = targetInputBatch;
 			// TODO: compute ideal iteration count
 			while(1) {
 				groupIterations = (unsigned)round_down_pow2(
-					(deviceLocalSize - inputBatchSize*(method == GF16OCL_LOOKUP_HALF ? 512 : 1024))
+					(deviceLocalSize - inputBatchSize*(halfTable ? 512 : 1024))
 					/ (sizePerWorkGroup * inputBatchSize)
 				);
-				if(groupIterations < 1 && deviceLocalSize >= 8192) {
+				if(groupIterations < itersMultiple && deviceLocalSize >= 8192) {
 					// maybe the workgroup is too big
 					if(wgSize > 256) {
 						wgSize = 256;
@@ -1229,10 +1605,15 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 				}
 				break;
 			}
-			kernelCode = _ocl_kernel_cachelut;
+			if(wideLoad)
+				kernelCode = _ocl_kernel_cachelut_wide;
+			else if(method == GF16OCL_LOOKUP_ASYNC || method == GF16OCL_LOOKUP_HALF_ASYNC)
+				kernelCode = _ocl_kernel_cachelut_async;
+			else
+				kernelCode = _ocl_kernel_cachelut;
 		}
 		
-		methodCode = (method == GF16OCL_LOOKUP_HALF || method == GF16OCL_LOOKUP_HALF_NOCACHE) ? _ocl_method_ll : _ocl_method_lh;
+		methodCode = (method == GF16OCL_LOOKUP_HALF || method == GF16OCL_LOOKUP_HALF_NOCACHE || method == GF16OCL_LOOKUP_HALF_WIDE || method == GF16OCL_LOOKUP_HALF_ASYNC) ? _ocl_method_ll : _ocl_method_lh;
 		
 		// write multiply-by-256 reduction table
 		sourceStream << "__constant ushort mul256poly[256] = {0";
@@ -1263,17 +1644,18 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 		}
 		// if iterations cannot be scaled down, scale down workgroup size next
 		unsigned minWgSize = 1;
-		if(kernelCode == _ocl_kernel_lut || kernelCode == _ocl_kernel_cachelut)
+		if(kernelCode == _ocl_kernel_lut || kernelCode == _ocl_kernel_cachelut || kernelCode == _ocl_kernel_cachelut_wide || kernelCode == _ocl_kernel_cachelut_async)
 			minWgSize = 128; // if computing lookup tables, don't scale down the workgroup below this amount
 		if(groupIterations == 1 && sizePerWorkGroup > sliceSizeCksum && wgSize > minWgSize) {
 			wgSize = CEIL_DIV(sliceSizeCksum, threadWordSize);
 			if(wgSize < minWgSize) wgSize = minWgSize;
 		}
 	}
-	if(method == GF16OCL_LOOKUP || method == GF16OCL_LOOKUP_HALF || method == GF16OCL_LOOKUP_NOCACHE || method == GF16OCL_LOOKUP_HALF_NOCACHE) {
+	if(methodCode == _ocl_method_lh || methodCode == _ocl_method_ll) {
 		// lookup method assumes workgroup is a power of two
 		wgSize = round_down_pow2(wgSize);
 	}
+	groupIterations = (unsigned)CEIL_DIV(groupIterations, itersMultiple) * itersMultiple;
 	sizePerWorkGroup = threadWordSize * wgSize;
 	
 	// code generation for log methods
@@ -1291,7 +1673,7 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 			tblLog[0] = 65535; // special value to represent 0
 		}
 		int n = 1;
-		if(method == GF16OCL_LOG) {
+		if(method == GF16OCL_LOG || method == GF16OCL_LOG_WIDE || method == GF16OCL_LOG_ASYNC) {
 			tblAntiLogSize = 65536;
 			tblAntiLog = new uint16_t[tblAntiLogSize];
 			for (int exp = 0; exp < 65535; exp++) {
@@ -1445,16 +1827,32 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 		}
 	}
 	sourceStream << _ocl_defines << "\n" << methodCode << "\n";
+	if(wideLoad) sourceStream << _ocl_wide_defines << "\n";
 	
 	
 	
 	// avoid uneven workgroups by aligning to workgroup size
 	bytesPerGroup = sizePerWorkGroup * groupIterations;
 	size_t sliceGroups = CEIL_DIV(sliceSizeCksum, bytesPerGroup);
-	processRange = cl::NDRange(sliceGroups * wgSize, CEIL_DIV(numOutputs, outputsPerThread));
 	sliceSizeAligned = sliceGroups*bytesPerGroup;
 	allocatedSliceSize = sliceSizeAligned;
 	
+	// split outputs evenly across as few buffers as the device's allocation limit allows
+	size_t maxShardOutputs = deviceMaxAlloc / sliceSizeAligned;
+	if(maxShardOutputs < 1) {
+#ifndef GF16OCL_NO_OUTPUT
+		std::cerr << "OpenCL Error: slice size (" << sliceSizeAligned << ") exceeds the device's maximum allocation size (" << deviceMaxAlloc << ")" << std::endl;
+#endif
+		if(tblLog) delete[] tblLog;
+		if(tblAntiLog) delete[] tblAntiLog;
+		return false;
+	}
+	unsigned numShards = (unsigned)CEIL_DIV(totalOutputs, maxShardOutputs);
+	numOutputs = CEIL_DIV(totalOutputs, numShards);
+	outputsPerShard = numOutputs;
+	outputsPerThread = numOutputs; // currently, process all outputs on every kernel invocation
+	processRange = cl::NDRange(sliceGroups * wgSize, CEIL_DIV(numOutputs, outputsPerThread));
+	
 	
 	char params[300];
 	snprintf(params, sizeof(params), "%s -DMAX_SLICE_SIZE=%zu -DNUM_OUTPUTS=%u -DOUTPUTS_PER_THREAD=%u -DOUTPUT_THREADS=%u -DVECT_WIDTH=%u -DCOL_GROUP_SIZE=%zu -DCOL_GROUP_ITERS=%u -DOUTPUT_GROUPING=%u -DSUBMIT_INPUTS=%u", oclVerArg, sliceSizeAligned, numOutputs, outputsPerThread, CEIL_DIV(numOutputs, outputsPerThread), infoShortVecSize, wgSize, groupIterations, outputsPerGroup, inputBatchSize);
@@ -1534,83 +1932,138 @@ bool PAR2ProcOCL::setup_kernels(Galois16OCLMethods method, unsigned targetInputB
 	
 	
 	std::string tmpSource = sourceStream.str();
-	cl::Program::Sources sources(cl::Program::Sources(1, std::make_pair(tmpSource.data(), tmpSource.length())));
+	std::vector<cl::Device> buildDevices(1, device);
+	auto buildStart = std::chrono::steady_clock::now();
+	
+	// try loading a previously compiled program; if the runtime rejects it, fall back to compiling
+	cl::Program program;
+	std::string cacheKey, cachePath;
+	buildCached = false;
+	if(!cacheDir.empty()) {
+		cacheKey = cache_key(method, params, tmpSource);
+		cachePath = ocl_cache_path(cacheDir, cacheKey);
+		std::vector<unsigned char> binary;
+		if(ocl_cache_read(cachePath, cacheKey, binary)) {
+			try {
+				program = cl::Program(context, buildDevices, cl::Program::Binaries(1, std::make_pair((const void*)binary.data(), binary.size())));
+				program.build(buildDevices, params);
+				buildCached = true;
+			} catch(cl::Error const&) {}
+		}
+	}
 	
 	// compile OpenCL kernel
-	cl::Program program(context, sources);
-	try {
-		program.build(std::vector<cl::Device>(1, device), params);
-	} catch(cl::Error const& err) {
+	if(!buildCached) {
+		cl::Program::Sources sources(cl::Program::Sources(1, std::make_pair(tmpSource.data(), tmpSource.length())));
+		program = cl::Program(context, sources);
+		try {
+			program.build(buildDevices, params);
+		} catch(cl::Error const& err) {
 #ifndef GF16OCL_NO_OUTPUT
-		if(err.err() == CL_BUILD_PROGRAM_FAILURE || err.err() == CL_COMPILE_PROGRAM_FAILURE || err.err() == CL_LINK_PROGRAM_FAILURE) {
-			std::cerr << "OpenCL Build Failure: " << err.what() << "(" << err.err() << "); build log:" <<std::endl << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
-		} else
-			std::cerr << "OpenCL Build Error: " << err.what() << "(" << err.err() << ")" << std::endl;
+			if(err.err() == CL_BUILD_PROGRAM_FAILURE || err.err() == CL_COMPILE_PROGRAM_FAILURE || err.err() == CL_LINK_PROGRAM_FAILURE) {
+				std::cerr << "OpenCL Build Failure: " << err.what() << "(" << err.err() << "); build log:" <<std::endl << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
+			} else
+				std::cerr << "OpenCL Build Error: " << err.what() << "(" << err.err() << ")" << std::endl;
 #endif
-		if(tblLog) delete[] tblLog;
-		if(tblAntiLog) delete[] tblAntiLog;
-		return false;
+			if(tblLog) delete[] tblLog;
+			if(tblAntiLog) delete[] tblAntiLog;
+			return false;
+		}
+		if(!cachePath.empty())
+			ocl_cache_write(cachePath, cacheKey, program);
 	}
+	buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
 	
 	
-	// variant kernels for first (mul only) & last (misaligned input count) iterations
-	kernelMul = cl::Kernel(program, "gf16_ocl_kernel_first");
-	kernelMulLast = cl::Kernel(program, "gf16_ocl_kernel_only");
-	kernelMulAddLast = cl::Kernel(program, "gf16_ocl_kernel_last");
-	kernelMulAdd = cl::Kernel(program, "gf16_ocl_kernel");
+	// variant kernels for first (mul only) & last (misaligned input count) iterations; each shard needs its own, as arguments are bound to the kernel object
+	shards = std::vector<PAR2ProcOCLShard>(numShards);
+	for(auto& shard : shards) {
+		shard.kernelMul = cl::Kernel(program, "gf16_ocl_kernel_first");
+		shard.kernelMulLast = cl::Kernel(program, "gf16_ocl_kernel_only");
+		shard.kernelMulAddLast = cl::Kernel(program, "gf16_ocl_kernel_last");
+		shard.kernelMulAdd = cl::Kernel(program, "gf16_ocl_kernel");
+	}
 	
 	
-	// TODO: check if supports CPU shared memory and use host mem instead?
-	// should probably check for dedicated memory to determine if transferring is needed
+	// if the device shares memory with the host, use our own allocations, which stay mapped whilst being filled, so inputs are written directly into them; otherwise inputs are written into a mapped pinned buffer, then copied across asynchronously
 	for(auto& area : staging) {
-		area.input = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*sliceSizeAligned);
+		if(zeroCopy) {
+			ALIGN_ALLOC(area.host, inputBatchSize*sliceSizeAligned, hostAlignment);
+			if(!area.host) {
+				if(tblLog) delete[] tblLog;
+				if(tblAntiLog) delete[] tblAntiLog;
+				return false;
+			}
+			area.input = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, inputBatchSize*sliceSizeAligned, area.host);
+			area.mapped = queue.enqueueMapBuffer(area.input, CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, 0, inputBatchSize*sliceSizeAligned);
+		} else {
+			area.input = cl::Buffer(context, CL_MEM_READ_ONLY, inputBatchSize*sliceSizeAligned);
+			area.pinned = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*sliceSizeAligned);
+			area.mapped = queue.enqueueMapBuffer(area.pinned, CL_TRUE, CL_MAP_WRITE, 0, inputBatchSize*sliceSizeAligned);
+		}
+		// coefficients for padding outputs stay zero, so they never need to be updated
+		area.procCoeffs.clear();
 		if(coeffType != GF16OCL_COEFF_NORMAL) {
-			area.coeffs = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*sizeof(uint16_t));
+			area.coeffs = std::vector<cl::Buffer>(1, cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*sizeof(uint16_t)));
 			area.procCoeffs.resize(inputBatchSize);
 		} else {
-			area.coeffs = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*numOutputs*sizeof(uint16_t));
-			area.procCoeffs.resize(inputBatchSize*numOutputs);
+			area.coeffs.clear();
+			for(unsigned s=0; s<numShards; s++)
+				area.coeffs.push_back(cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, inputBatchSize*numOutputs*sizeof(uint16_t)));
+			area.procCoeffs.resize(inputBatchSize*numOutputs*numShards);
+		}
+	}
+	for(auto& shard : shards) {
+		if(zeroCopy) {
+			ALIGN_ALLOC(shard.outputHost, numOutputs*sliceSizeAligned, hostAlignment);
+			if(!shard.outputHost) {
+				if(tblLog) delete[] tblLog;
+				if(tblAntiLog) delete[] tblAntiLog;
+				return false;
+			}
+			shard.output = cl::Buffer(context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, numOutputs*sliceSizeAligned, shard.outputHost);
+		} else
+			shard.output = cl::Buffer(context, CL_MEM_READ_WRITE, numOutputs*sliceSizeAligned);
+		
+		// attach arguments to kernels
+		shard.kernelMul.setArg(0, shard.output);
+		shard.kernelMulLast.setArg(0, shard.output);
+		shard.kernelMulAddLast.setArg(0, shard.output);
+		shard.kernelMulAdd.setArg(0, shard.output);
+		
+		if(coeffType == GF16OCL_COEFF_LOG) {
+			shard.outExp = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, numOutputs*sizeof(uint16_t));
+			shard.kernelMul.setArg(3, shard.outExp);
+			shard.kernelMulAdd.setArg(3, shard.outExp);
+			shard.kernelMulLast.setArg(4, shard.outExp);
+			shard.kernelMulAddLast.setArg(4, shard.outExp);
 		}
 	}
-	// TODO: need to consider CL_DEVICE_MAX_MEM_ALLOC_SIZE and perhaps break this into multiple allocations
-	buffer_output = cl::Buffer(context, CL_MEM_READ_WRITE, numOutputs*sliceSizeAligned);
 	
 	workGroupRange = cl::NDRange(wgSize, 1);
 	
-	
-	// attach arguments to kernels
-	kernelMul.setArg(0, buffer_output);
-	kernelMulLast.setArg(0, buffer_output);
-	kernelMulAddLast.setArg(0, buffer_output);
-	kernelMulAdd.setArg(0, buffer_output);
-	
 	extra_buffers.clear();
 	
-	if(coeffType == GF16OCL_COEFF_LOG) {
-		buffer_outExp = cl::Buffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, numOutputs*sizeof(uint16_t));
-		kernelMul.setArg(3, buffer_outExp);
-		kernelMulAdd.setArg(3, buffer_outExp);
-		kernelMulLast.setArg(4, buffer_outExp);
-		kernelMulAddLast.setArg(4, buffer_outExp);
-	} else {
-		buffer_outExp = cl::Buffer();
-	}
 	// if we couldn't embed log tables directly into the source, transfer them now
 	if(tblLog) {
 		const cl::Buffer bufLog(context, CL_MEM_READ_ONLY, tblLogSize*2);
 		extra_buffers.push_back(bufLog);
-		kernelMul.setArg(4, bufLog);
-		kernelMulAdd.setArg(4, bufLog);
-		kernelMulLast.setArg(5, bufLog);
-		kernelMulAddLast.setArg(5, bufLog);
+		for(auto& shard : shards) {
+			shard.kernelMul.setArg(4, bufLog);
+			shard.kernelMulAdd.setArg(4, bufLog);
+			shard.kernelMulLast.setArg(5, bufLog);
+			shard.kernelMulAddLast.setArg(5, bufLog);
+		}
 		
 		if(tblAntiLog) {
 			extra_buffers.push_back(cl::Buffer(context, CL_MEM_READ_ONLY, tblAntiLogSize*2));
 			const cl::Buffer& bufALog = extra_buffers.back();
-			kernelMul.setArg(5, bufALog);
-			kernelMulAdd.setArg(5, bufALog);
-			kernelMulLast.setArg(6, bufALog);
-			kernelMulAddLast.setArg(6, bufALog);
+			for(auto& shard : shards) {
+				shard.kernelMul.setArg(5, bufALog);
+				shard.kernelMulAdd.setArg(5, bufALog);
+				shard.kernelMulLast.setArg(6, bufALog);
+				shard.kernelMulAddLast.setArg(6, bufALog);
+			}
 			
 			std::vector<cl::Event> enqueueEvents(2);
 			queue.enqueueWriteBuffer(bufLog, CL_FALSE, 0, tblLogSize*2, tblLog, NULL, &enqueueEvents[0]);
@@ -0,0 +1,213 @@
+#include <iostream>
+#include "../src/stdint.h"
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include "controller_ocl.h"
+#include "../src/platform.h"
+#include "gfmat_coeff.h"
+
+// multiply-add result for the probe, computed on the CPU; the lookup method works on natural layout, so needs no prepare/finish
+class PAR2ProcOCLProbeRef {
+	Galois16Mul gf;
+	size_t sliceSize, len;
+	std::vector<void*> outputs;
+
+public:
+	PAR2ProcOCLProbeRef(size_t _sliceSize, unsigned numOutputs) : gf(GF16_LOOKUP), sliceSize(_sliceSize), outputs(numOutputs) {
+		len = gf.alignToStride(sliceSize);
+		for(auto& output : outputs) {
+			ALIGN_ALLOC(output, len, gf.info().alignment);
+			memset(output, 0, len);
+		}
+	}
+	~PAR2ProcOCLProbeRef() {
+		for(auto& output : outputs)
+			ALIGN_FREE(output);
+	}
+	void add(const void* input, uint16_t inputNum, const std::vector<uint16_t>& outputExp) {
+		void* src;
+		ALIGN_ALLOC(src, len, gf.info().alignment);
+		memset(src, 0, len);
+		memcpy(src, input, sliceSize);
+		uint16_t inputLog = gfmat_input_log(inputNum);
+		for(unsigned i=0; i<outputs.size(); i++)
+			gf.mul_add(outputs[i], src, len, gfmat_coeff_from_log(inputLog, outputExp[i]), nullptr);
+		ALIGN_FREE(src);
+	}
+	inline const void* output(unsigned index) const {
+		return outputs[index];
+	}
+};
+
+// simple xorshift, so that the probe's data is the same on every run
+static void probe_fill(void* dst, size_t len, uint64_t seed) {
+	uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+	uint8_t* p = static_cast<uint8_t*>(dst);
+	for(size_t i=0; i<len; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		p[i] = (uint8_t)state;
+	}
+}
+
+
+// checks the current setup against the CPU, then times it; returns seconds per input slice per output, or negative if the results are incorrect
+// all four kernel variants are checked: a full batch followed by a partial one, then the reverse
+double PAR2ProcOCL::probe(unsigned iterations) {
+	unsigned numOutputs = outputExponents.size();
+	unsigned partialBatch = inputBatchSize > 1 ? inputBatchSize-1 : 1;
+	std::vector<uint8_t> input(sliceSize);
+	std::vector<uint8_t> output(sliceSizeAligned);
+	auto& area = staging[0];
+
+	try {
+		queue.finish();
+		for(int pass=0; pass<2; pass++) {
+			PAR2ProcOCLProbeRef ref(sliceSize, numOutputs);
+			reset_state();
+			uint16_t inputNum = 0;
+			unsigned batches[2] = {inputBatchSize, partialBatch};
+			if(pass) std::swap(batches[0], batches[1]);
+			for(unsigned numInputs : batches) {
+				for(unsigned i=0; i<numInputs; i++) {
+					probe_fill(input.data(), sliceSize, inputNum);
+					gf->copy_cksum(static_cast<char*>(area.mapped) + i*sliceSizeAligned, input.data(), sliceSize, sliceSize);
+					set_coeffs(area, i, inputNum);
+					ref.add(input.data(), inputNum, outputExponents);
+					inputNum++;
+				}
+				enqueue_batch(0, numInputs);
+				queue.finish(); // the staging area is reused for the next batch
+			}
+
+			for(unsigned i=0; i<numOutputs; i++) {
+				auto& shard = shards[i / outputsPerShard];
+				void* remote = queue.enqueueMapBuffer(shard.output, CL_TRUE, CL_MAP_READ, (i % outputsPerShard)*sliceSizeAligned, sliceSizeAligned);
+				int cksumSuccess = gf->copy_cksum_check(output.data(), remote, sliceSize);
+				queue.enqueueUnmapMemObject(shard.output, remote);
+				if(!cksumSuccess || memcmp(output.data(), ref.output(i), sliceSize))
+					return -1;
+			}
+		}
+		queue.finish();
+
+		// the data doesn't matter here, so the staging area is just resubmitted; the first batch warms up the device
+		reset_state();
+		for(unsigned i=0; i<inputBatchSize; i++)
+			set_coeffs(area, i, (uint16_t)i);
+		enqueue_batch(0, inputBatchSize);
+		queue.finish();
+		auto start = std::chrono::steady_clock::now();
+		for(unsigned i=0; i<iterations; i++)
+			enqueue_batch(0, inputBatchSize);
+		queue.finish();
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		reset_state();
+		return elapsed / ((double)iterations * inputBatchSize * numOutputs);
+	} catch(cl::Error const& err) {
+#ifndef GF16OCL_NO_OUTPUT
+		std::cerr << "OpenCL Error: " << err.what() << "(" << err.err() << ")" << std::endl;
+#endif
+		reset_state();
+		return -1;
+	}
+}
+
+
+#define PROBE_ITERATIONS 8
+
+std::vector<GF16OCL_TuneResult> PAR2ProcOCL::autotune(int platformId, int deviceId, const std::string& cacheDir, size_t probeSize, unsigned probeOutputs) {
+	std::vector<GF16OCL_TuneResult> results;
+	// the probe's reference computes coefficients before any processor may have been created
+	gfmat_init();
+
+#ifdef USE_LIBUV
+	// nothing is signalled back during the probe, but the backend needs a loop for its notification handles
+	uv_loop_t loop;
+	if(uv_loop_init(&loop)) return results;
+#endif
+	auto* proc = new PAR2ProcOCL(IF_LIBUV(&loop,) platformId, deviceId, 1);
+	proc->setCacheDir(cacheDir);
+	proc->setSliceSize(probeSize);
+	std::vector<uint16_t> outputExp(probeOutputs);
+	for(unsigned i=0; i<probeOutputs; i++)
+		outputExp[i] = i;
+
+	auto tryConfig = [&](GF16OCL_TuneResult cfg) -> GF16OCL_TuneResult {
+		// skip anything already tried
+		for(const auto& result : results) {
+			if(result.method == cfg.method && result.inputBatch == cfg.inputBatch && result.iters == cfg.iters && result.grouping == cfg.grouping && result.workGroup == cfg.workGroup)
+				return result;
+		}
+		cfg.valid = false;
+		cfg.time = 0;
+		bool ready;
+		try {
+			ready = proc->init(cfg.method, cfg.inputBatch, cfg.iters, cfg.grouping, GF16_AUTO, cfg.workGroup)
+				&& proc->setRecoverySlices(probeOutputs, outputExp.data());
+		} catch(cl::Error const&) {
+			ready = false;
+		}
+		if(ready) {
+			double time = proc->probe(PROBE_ITERATIONS);
+			if(time >= 0) {
+				cfg.valid = true;
+				cfg.time = time;
+			}
+		}
+		results.push_back(cfg);
+		return cfg;
+	};
+	auto better = [](const GF16OCL_TuneResult& a, const GF16OCL_TuneResult& b) -> bool {
+		if(a.valid != b.valid) return a.valid;
+		return a.valid && a.time < b.time;
+	};
+
+	if(proc->_initSuccess) {
+		// first, find the best methods with default parameters; methods which fail validation get discarded here
+		std::vector<GF16OCL_TuneResult> bases;
+		for(auto method : availableMethods(-1, -1)) {
+			auto result = tryConfig({method, 0, 0, 0, 0, 0, false});
+			if(result.valid) bases.push_back(result);
+		}
+		for(auto method : {GF16OCL_LOG, GF16OCL_LOG_SMALL, GF16OCL_LOG_SMALL2, GF16OCL_LOG_TINY, GF16OCL_LOG_SMALL_LMEM, GF16OCL_LOG_TINY_LMEM, GF16OCL_LOG_WIDE, GF16OCL_LOG_ASYNC}) {
+			auto result = tryConfig({method, 0, 0, 0, 0, 0, false});
+			if(result.valid) bases.push_back(result);
+		}
+		std::sort(bases.begin(), bases.end(), better);
+		if(bases.size() > 2) bases.resize(2);
+
+		// then adjust one parameter at a time on the best couple, keeping whatever helps, rather than searching every combination
+		unsigned maxWorkGroup = proc->deviceInfo().maxWorkGroup;
+		for(auto best : bases) {
+			auto methInfo = info(best.method);
+			auto tune = [&](unsigned GF16OCL_TuneResult::* param, std::vector<unsigned> values) {
+				auto cur = best;
+				for(unsigned value : values) {
+					if(value < 1) continue;
+					auto cfg = cur;
+					cfg.*param = value;
+					auto result = tryConfig(cfg);
+					if(better(result, best)) best = result;
+				}
+			};
+			tune(&GF16OCL_TuneResult::workGroup, {maxWorkGroup/2, maxWorkGroup/4});
+			tune(&GF16OCL_TuneResult::inputBatch, {methInfo.idealInBatch/2, methInfo.idealInBatch*2});
+			tune(&GF16OCL_TuneResult::iters, {methInfo.idealIters/2, methInfo.idealIters*2});
+			if(methInfo.usesOutGrouping)
+				tune(&GF16OCL_TuneResult::grouping, {2, 4, 16});
+		}
+	}
+
+	proc->deinit();
+#ifdef USE_LIBUV
+	uv_run(&loop, UV_RUN_DEFAULT); // completes closing the handles, which live in the backend
+	uv_loop_close(&loop);
+#endif
+	delete proc;
+
+	std::stable_sort(results.begin(), results.end(), better);
+	return results;
+}
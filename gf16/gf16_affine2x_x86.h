@@ -96,3 +96,19 @@ GF_FINISH_PACKED_FUNCS(gf16_affine2x, _FNSUFFIX, sizeof(_mword), _FN(gf16_affine
 #else
 GF_FINISH_PACKED_FUNCS_STUB(gf16_affine2x, _FNSUFFIX)
 #endif
+
+// natural layout variant: the kernel transforms data in-register, so packing is just a copy
+// (only implemented for 256/512-bit vectors)
+#if MWORD_SIZE >= 32
+# ifdef _AVAILABLE
+#  ifdef PLATFORM_AMD64
+GF_PREPARE_PACKED_FUNCS(gf16_affine2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_prepare_block), _FN(gf16_natural_prepare_blocku), 6 + (MWORD_SIZE==64)*6, _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare), sizeof(_mword))
+#  else
+GF_PREPARE_PACKED_FUNCS(gf16_affine2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_prepare_block), _FN(gf16_natural_prepare_blocku), 2, _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare), sizeof(_mword))
+#  endif
+GF_FINISH_PACKED_FUNCS(gf16_affine2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_finish_copy_block), _FN(gf16_natural_finish_copy_blocku), 1, _MM_END, _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), NULL, sizeof(_mword))
+# else
+GF_PREPARE_PACKED_FUNCS_STUB(gf16_affine2x_natural, _FNSUFFIX)
+GF_FINISH_PACKED_FUNCS_STUB(gf16_affine2x_natural, _FNSUFFIX)
+# endif
+#endif
@@ -178,6 +178,68 @@ GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine, _avx2)
 #endif
 
 
+#if defined(__GFNI__) && defined(__AVX2__) && defined(PLATFORM_AMD64)
+// 4 outputs use 8 accumulator registers, leaving room for the input and temporaries
+# define GF16_AFFINE_MULTIOUT_AVX2 4
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_round_avx2(
+	const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint64_t* mats
+) {
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(__m256i)*2) {
+		__m256i tph[GF16_AFFINE_MULTIOUT_AVX2], tpl[GF16_AFFINE_MULTIOUT_AVX2];
+		for(unsigned out = 0; out < outputs; out++) {
+			tph[out] = _mm256_load_si256((__m256i*)(_dst + out*dstStride + ptr));
+			tpl[out] = _mm256_load_si256((__m256i*)(_dst + out*dstStride + ptr) + 1);
+		}
+		const uint64_t* mat = mats;
+		for(unsigned src = 0; src < srcCount; src++) {
+			__m256i ta = _mm256_load_si256((__m256i*)(_src[src] + ptr*srcScale[src]));
+			__m256i tb = _mm256_load_si256((__m256i*)(_src[src] + ptr*srcScale[src]) + 1);
+			for(unsigned out = 0; out < outputs; out++) {
+				// matrices are broadcast straight from memory, as there aren't enough registers to hold them
+				tpl[out] = _mm256_xor_si256(tpl[out], _mm256_xor_si256(
+					_mm256_gf2p8affine_epi64_epi8(ta, _mm256_set1_epi64x(mat[3]), 0),
+					_mm256_gf2p8affine_epi64_epi8(tb, _mm256_set1_epi64x(mat[0]), 0)
+				));
+				tph[out] = _mm256_xor_si256(tph[out], _mm256_xor_si256(
+					_mm256_gf2p8affine_epi64_epi8(ta, _mm256_set1_epi64x(mat[1]), 0),
+					_mm256_gf2p8affine_epi64_epi8(tb, _mm256_set1_epi64x(mat[2]), 0)
+				));
+				mat += 4;
+			}
+		}
+		for(unsigned out = 0; out < outputs; out++) {
+			_mm256_store_si256((__m256i*)(_dst + out*dstStride + ptr), tph[out]);
+			_mm256_store_si256((__m256i*)(_dst + out*dstStride + ptr) + 1, tpl[out]);
+		}
+	}
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_x_avx2(
+	const void *HEDLEY_RESTRICT scratch, const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, size_t coeffStride
+) {
+	// each matrix is stored as 4 qwords: ll, hh, hl, lh
+	ALIGN_TO(32, uint64_t mats[GF16_MULADD_MULTIOUT_MAX_SRC*GF16_AFFINE_MULTIOUT_AVX2*4]);
+	for(unsigned src = 0; src < srcCount; src++)
+		for(unsigned out = 0; out < outputs; out++)
+			_mm256_store_si256((__m256i*)(mats + (src*outputs + out)*4), gf16_affine_load_matrix(scratch, coefficients[out*coeffStride + src]));
+	
+	switch(outputs) {
+		case 4: gf16_affine_muladd_multiout_round_avx2(4, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 3: gf16_affine_muladd_multiout_round_avx2(3, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 2: gf16_affine_muladd_multiout_round_avx2(2, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 1: gf16_affine_muladd_multiout_round_avx2(1, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		default: HEDLEY_UNREACHABLE();
+	}
+}
+GF16_MULADD_MULTIOUT_FUNCS(gf16_affine, _avx2, gf16_affine_muladd_multiout_x_avx2, 3, GF16_AFFINE_MULTIOUT_AVX2, sizeof(__m256i)*2, _mm256_zeroupper())
+#else
+GF16_MULADD_MULTIOUT_FUNCS_STUB(gf16_affine, _avx2)
+#endif
+
+
 #if defined(__GFNI__) && defined(__AVX2__)
 # include "gf16_bitdep_init_avx2.h"
 #endif
@@ -196,11 +258,37 @@ void* gf16_affine_init_avx2(int polynomial) {
 
 
 #if defined(__GFNI__) && defined(__AVX2__)
-static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx2(
+// the natural variant accepts data in its original layout, transforming it in-register instead of relying on prepare/finish
+static HEDLEY_ALWAYS_INLINE __m256i gf16_affine2x_load_avx2(const uint8_t* src, const int natural) {
+	__m256i data = _mm256_load_si256((__m256i*)src);
+	if(natural)
+		data = _mm256_shuffle_epi8(data, _mm256_set_epi32(
+			0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200,
+			0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200
+		));
+	return data;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_store_avx2(uint8_t* dst, __m256i result1, __m256i result2, const int natural) {
+	result2 = _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2));
+	if(natural) {
+		result1 = _mm256_xor_si256(result1, result2);
+		result1 = _mm256_shuffle_epi8(result1, _mm256_set_epi32(
+			0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
+			0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
+		));
+		result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)dst));
+	} else {
+		result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)dst));
+		result1 = _mm256_xor_si256(result1, result2);
+	}
+	_mm256_store_si256((__m256i*)dst, result1);
+}
+
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_xn_avx2(
 	const void *HEDLEY_RESTRICT scratch,
 	uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale,
 	GF16_MULADD_MULTI_SRCLIST,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf, const int natural
 ) {
 	GF16_MULADD_MULTI_SRC_UNUSED(6);
 	
@@ -251,40 +339,38 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx2(
 		if(doPrefetch == 2)
 			_mm_prefetch(_pf+ptr, _MM_HINT_T2);
 		if(ptr & (sizeof(__m256i)*2-1)) { // align to a cacheline boundary
-			__m256i data = _mm256_load_si256((__m256i*)(_src1 + ptr*srcScale));
+			__m256i data = gf16_affine2x_load_avx2(_src1 + ptr*srcScale, natural);
 			__m256i result1 = _mm256_gf2p8affine_epi64_epi8(data, matNormA, 0);
 			__m256i result2 = _mm256_gf2p8affine_epi64_epi8(data, matSwapA, 0);
 			
 			if(srcCount >= 2) {
-				data = _mm256_load_si256((__m256i*)(_src2 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src2 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormB, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapB, 0));
 			}
 			
 			if(srcCount >= 3) {
-				data = _mm256_load_si256((__m256i*)(_src3 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src3 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormC, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapC, 0));
 			}
 			if(srcCount >= 4) {
-				data = _mm256_load_si256((__m256i*)(_src4 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src4 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormD, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapD, 0));
 			}
 			if(srcCount >= 5) {
-				data = _mm256_load_si256((__m256i*)(_src5 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src5 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormE, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapE, 0));
 			}
 			if(srcCount >= 6) {
-				data = _mm256_load_si256((__m256i*)(_src6 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src6 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormF, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapF, 0));
 			}
 			
-			result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)(_dst + ptr)));
-			result1 = _mm256_xor_si256(result1, _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
-			_mm256_store_si256((__m256i*)(_dst + ptr), result1);
+			gf16_affine2x_store_avx2(_dst + ptr, result1, result2, natural);
 			
 			ptr += sizeof(__m256i);
 		}
@@ -296,44 +382,54 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx2(
 			_mm_prefetch(_pf+ptr, _MM_HINT_T2);
 		
 		for(int iter=0; iter<(doPrefetch?2:1); iter++) { // if prefetching, iterate on cachelines
-			__m256i data = _mm256_load_si256((__m256i*)(_src1 + ptr*srcScale));
+			__m256i data = gf16_affine2x_load_avx2(_src1 + ptr*srcScale, natural);
 			__m256i result1 = _mm256_gf2p8affine_epi64_epi8(data, matNormA, 0);
 			__m256i result2 = _mm256_gf2p8affine_epi64_epi8(data, matSwapA, 0);
 			
 			if(srcCount >= 2) {
-				data = _mm256_load_si256((__m256i*)(_src2 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src2 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormB, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapB, 0));
 			}
 			if(srcCount >= 3) {
-				data = _mm256_load_si256((__m256i*)(_src3 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src3 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormC, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapC, 0));
 			}
 			if(srcCount >= 4) {
-				data = _mm256_load_si256((__m256i*)(_src4 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src4 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormD, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapD, 0));
 			}
 			if(srcCount >= 5) {
-				data = _mm256_load_si256((__m256i*)(_src5 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src5 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormE, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapE, 0));
 			}
 			if(srcCount >= 6) {
-				data = _mm256_load_si256((__m256i*)(_src6 + ptr*srcScale));
+				data = gf16_affine2x_load_avx2(_src6 + ptr*srcScale, natural);
 				result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNormF, 0));
 				result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwapF, 0));
 			}
 			
-			result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)(_dst + ptr)));
-			result1 = _mm256_xor_si256(result1, _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
-			_mm256_store_si256((__m256i*)(_dst + ptr), result1);
+			gf16_affine2x_store_avx2(_dst + ptr, result1, result2, natural);
 			
 			ptr += sizeof(__m256i);
 		}
 	}
 }
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx2(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	gf16_affine2x_muladd_xn_avx2(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 0);
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_natural_muladd_x_avx2(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	gf16_affine2x_muladd_xn_avx2(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 1);
+}
 #endif /*defined(__GFNI__) && defined(__AVX2__)*/
 
 void gf16_affine2x_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
@@ -356,3 +452,23 @@ GF16_MULADD_MULTI_FUNCS(gf16_affine2x, _avx2, gf16_affine2x_muladd_x_avx2, 2, si
 #else
 GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine2x, _avx2)
 #endif
+
+void gf16_affine2x_natural_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	gf16_muladd_single(scratch, &gf16_affine2x_natural_muladd_x_avx2, dst, src, len, coefficient);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX2__)
+# ifdef PLATFORM_AMD64
+GF16_MULADD_MULTI_FUNCS(gf16_affine2x_natural, _avx2, gf16_affine2x_natural_muladd_x_avx2, 6, sizeof(__m256i), 0, _mm256_zeroupper())
+# else
+GF16_MULADD_MULTI_FUNCS(gf16_affine2x_natural, _avx2, gf16_affine2x_natural_muladd_x_avx2, 2, sizeof(__m256i), 0, _mm256_zeroupper())
+# endif
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine2x_natural, _avx2)
+#endif
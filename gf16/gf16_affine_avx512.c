@@ -34,11 +34,14 @@ int gf16_affine_available_avx512 = 0;
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
 # ifdef PLATFORM_AMD64
 GF_PREPARE_PACKED_FUNCS(gf16_affine, _avx512, sizeof(__m512i)*2, gf16_shuffle_prepare_block_avx512, gf16_shuffle_prepare_blocku_avx512, 6, _mm256_zeroupper(), __m512i checksum = _mm512_setzero_si512(), gf16_checksum_block_avx512, gf16_checksum_blocku_avx512, gf16_checksum_exp_avx512, gf16_checksum_prepare_avx512, sizeof(__m512i))
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS(gf16_affine, _avx512, sizeof(__m512i)*2, gf16_shuffle_prepare_block_nt_avx512, gf16_shuffle_prepare_blocku_avx512, 6, _mm_sfence(); _mm256_zeroupper(), __m512i checksum = _mm512_setzero_si512(), gf16_checksum_block_avx512, gf16_checksum_blocku_avx512, gf16_checksum_exp_avx512, gf16_checksum_prepare_avx512)
 # else
 GF_PREPARE_PACKED_FUNCS(gf16_affine, _avx512, sizeof(__m512i)*2, gf16_shuffle_prepare_block_avx512, gf16_shuffle_prepare_blocku_avx512, 1, _mm256_zeroupper(), __m512i checksum = _mm512_setzero_si512(), gf16_checksum_block_avx512, gf16_checksum_blocku_avx512, gf16_checksum_exp_avx512, gf16_checksum_prepare_avx512, sizeof(__m512i))
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS(gf16_affine, _avx512, sizeof(__m512i)*2, gf16_shuffle_prepare_block_nt_avx512, gf16_shuffle_prepare_blocku_avx512, 1, _mm_sfence(); _mm256_zeroupper(), __m512i checksum = _mm512_setzero_si512(), gf16_checksum_block_avx512, gf16_checksum_blocku_avx512, gf16_checksum_exp_avx512, gf16_checksum_prepare_avx512)
 # endif
 #else
 GF_PREPARE_PACKED_FUNCS_STUB(gf16_affine, _avx512)
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS_STUB(gf16_affine, _avx512)
 #endif
 
 
@@ -260,6 +263,71 @@ GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine, _avx512)
 #endif
 
 
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+// with 32 registers, 8 outputs can be accumulated at once
+# define GF16_AFFINE_MULTIOUT_AVX512 8
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_round_avx512(
+	const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint64_t* mats
+) {
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(__m512i)*2) {
+		__m512i tph[GF16_AFFINE_MULTIOUT_AVX512], tpl[GF16_AFFINE_MULTIOUT_AVX512];
+		for(unsigned out = 0; out < outputs; out++) {
+			tph[out] = _mm512_load_si512((__m512i*)(_dst + out*dstStride + ptr));
+			tpl[out] = _mm512_load_si512((__m512i*)(_dst + out*dstStride + ptr) + 1);
+		}
+		const uint64_t* mat = mats;
+		for(unsigned src = 0; src < srcCount; src++) {
+			__m512i ta = _mm512_load_si512((__m512i*)(_src[src] + ptr*srcScale[src]));
+			__m512i tb = _mm512_load_si512((__m512i*)(_src[src] + ptr*srcScale[src]) + 1);
+			for(unsigned out = 0; out < outputs; out++) {
+				// the set1 should fold into an embedded broadcast
+				tpl[out] = _mm512_ternarylogic_epi32(
+					_mm512_gf2p8affine_epi64_epi8(ta, _mm512_set1_epi64(mat[3]), 0),
+					_mm512_gf2p8affine_epi64_epi8(tb, _mm512_set1_epi64(mat[0]), 0),
+					tpl[out],
+					0x96
+				);
+				tph[out] = _mm512_ternarylogic_epi32(
+					_mm512_gf2p8affine_epi64_epi8(ta, _mm512_set1_epi64(mat[1]), 0),
+					_mm512_gf2p8affine_epi64_epi8(tb, _mm512_set1_epi64(mat[2]), 0),
+					tph[out],
+					0x96
+				);
+				mat += 4;
+			}
+		}
+		for(unsigned out = 0; out < outputs; out++) {
+			_mm512_store_si512((__m512i*)(_dst + out*dstStride + ptr), tph[out]);
+			_mm512_store_si512((__m512i*)(_dst + out*dstStride + ptr) + 1, tpl[out]);
+		}
+	}
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_x_avx512(
+	const void *HEDLEY_RESTRICT scratch, const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, size_t coeffStride
+) {
+	// each matrix is stored as 4 qwords: ll, hh, hl, lh
+	ALIGN_TO(32, uint64_t mats[GF16_MULADD_MULTIOUT_MAX_SRC*GF16_AFFINE_MULTIOUT_AVX512*4]);
+	for(unsigned src = 0; src < srcCount; src++)
+		for(unsigned out = 0; out < outputs; out++)
+			_mm256_store_si256((__m256i*)(mats + (src*outputs + out)*4), gf16_affine_load_matrix(scratch, coefficients[out*coeffStride + src]));
+	
+	switch(outputs) {
+		#define CASE(x) case x: gf16_affine_muladd_multiout_round_avx512(x, _dst, dstStride, srcCount, _src, srcScale, len, mats); break
+		CASE(8); CASE(7); CASE(6); CASE(5); CASE(4); CASE(3); CASE(2); CASE(1);
+		#undef CASE
+		default: HEDLEY_UNREACHABLE();
+	}
+}
+GF16_MULADD_MULTIOUT_FUNCS(gf16_affine, _avx512, gf16_affine_muladd_multiout_x_avx512, 6, GF16_AFFINE_MULTIOUT_AVX512, sizeof(__m512i)*2, _mm256_zeroupper())
+#else
+GF16_MULADD_MULTIOUT_FUNCS_STUB(gf16_affine, _avx512)
+#endif
+
+
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
 # include "gf16_bitdep_init_avx2.h"
 #endif
@@ -277,10 +345,17 @@ void* gf16_affine_init_avx512(int polynomial) {
 
 
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
-static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_2round(const int srcCountOffs, const void* _src1, const void* _src2, __m512i* result, __m512i* swapped, __m512i matNorm1, __m512i matSwap1, __m512i matNorm2, __m512i matSwap2) {
+// the natural variant accepts data in its original layout, transforming it in-register instead of relying on prepare/finish
+static HEDLEY_ALWAYS_INLINE __m512i gf16_affine2x_load_avx512(const void* src, const int natural) {
+	__m512i data = _mm512_load_si512(src);
+	if(natural)
+		data = separate_low_high512(data);
+	return data;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_2round(const int srcCountOffs, const void* _src1, const void* _src2, __m512i* result, __m512i* swapped, __m512i matNorm1, __m512i matSwap1, __m512i matNorm2, __m512i matSwap2, const int natural) {
 	if(srcCountOffs < 0) return;
 	
-	__m512i data1 = _mm512_load_si512(_src1);
+	__m512i data1 = gf16_affine2x_load_avx512(_src1, natural);
 	if(srcCountOffs == 0) {
 		*result = _mm512_xor_si512(
 			*result,
@@ -292,7 +367,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_2round(const int srcCountO
 		);
 	}
 	else { // if(srcCountOffs > 0)
-		__m512i data2 = _mm512_load_si512(_src2);
+		__m512i data2 = gf16_affine2x_load_avx512(_src2, natural);
 		*result = _mm512_ternarylogic_epi32(
 			*result,
 			_mm512_gf2p8affine_epi64_epi8(data1, matNorm1, 0),
@@ -307,10 +382,10 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_2round(const int srcCountO
 		);
 	}
 }
-static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_xn_avx512(
 	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale,
 	GF16_MULADD_MULTI_SRCLIST,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf, const int natural
 ) {
 	GF16_MULADD_MULTI_SRC_UNUSED(13);
 	
@@ -412,13 +487,13 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
 	
 	
 	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(__m512i)) {
-		__m512i data = _mm512_load_si512((__m512i*)(_src1 + ptr*srcScale));
+		__m512i data = gf16_affine2x_load_avx512(_src1 + ptr*srcScale, natural);
 		__m512i result = _mm512_gf2p8affine_epi64_epi8(data, matNormA, 0);
 		__m512i swapped = _mm512_gf2p8affine_epi64_epi8(data, matSwapA, 0);
 		if(srcCount > 1)
-			data = _mm512_load_si512((__m512i*)(_src2 + ptr*srcScale));
+			data = gf16_affine2x_load_avx512(_src2 + ptr*srcScale, natural);
 		if(srcCount >= 3) {
-			__m512i data2 = _mm512_load_si512((__m512i*)(_src3 + ptr*srcScale));
+			__m512i data2 = gf16_affine2x_load_avx512(_src3 + ptr*srcScale, natural);
 			result = _mm512_ternarylogic_epi32(
 				result,
 				_mm512_gf2p8affine_epi64_epi8(data, matNormB, 0),
@@ -442,18 +517,26 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
 			);
 		}
 		
-		gf16_affine2x_muladd_2round(srcCount - 4, _src4 + ptr*srcScale, _src5 + ptr*srcScale, &result, &swapped, matNormD, matSwapD, matNormE, matSwapE);
-		gf16_affine2x_muladd_2round(srcCount - 6, _src6 + ptr*srcScale, _src7 + ptr*srcScale, &result, &swapped, matNormF, matSwapF, matNormG, matSwapG);
-		gf16_affine2x_muladd_2round(srcCount - 8, _src8 + ptr*srcScale, _src9 + ptr*srcScale, &result, &swapped, matNormH, matSwapH, matNormI, matSwapI);
-		gf16_affine2x_muladd_2round(srcCount - 10, _src10 + ptr*srcScale, _src11 + ptr*srcScale, &result, &swapped, matNormJ, matSwapJ, matNormK, matSwapK);
-		gf16_affine2x_muladd_2round(srcCount - 12, _src12 + ptr*srcScale, _src13 + ptr*srcScale, &result, &swapped, matNormL, matSwapL, matNormM, matSwapM);
+		gf16_affine2x_muladd_2round(srcCount - 4, _src4 + ptr*srcScale, _src5 + ptr*srcScale, &result, &swapped, matNormD, matSwapD, matNormE, matSwapE, natural);
+		gf16_affine2x_muladd_2round(srcCount - 6, _src6 + ptr*srcScale, _src7 + ptr*srcScale, &result, &swapped, matNormF, matSwapF, matNormG, matSwapG, natural);
+		gf16_affine2x_muladd_2round(srcCount - 8, _src8 + ptr*srcScale, _src9 + ptr*srcScale, &result, &swapped, matNormH, matSwapH, matNormI, matSwapI, natural);
+		gf16_affine2x_muladd_2round(srcCount - 10, _src10 + ptr*srcScale, _src11 + ptr*srcScale, &result, &swapped, matNormJ, matSwapJ, matNormK, matSwapK, natural);
+		gf16_affine2x_muladd_2round(srcCount - 12, _src12 + ptr*srcScale, _src13 + ptr*srcScale, &result, &swapped, matNormL, matSwapL, matNormM, matSwapM, natural);
 		
-		result = _mm512_ternarylogic_epi32(
-			result,
-			_mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)),
-			_mm512_load_si512((__m512i*)(_dst + ptr)),
-			0x96
-		);
+		if(natural) {
+			result = _mm512_xor_si512(result, _mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)));
+			result = _mm512_xor_si512(
+				_mm512_shuffle_epi8(result, _mm512_set4_epi32(0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800)),
+				_mm512_load_si512((__m512i*)(_dst + ptr))
+			);
+		} else {
+			result = _mm512_ternarylogic_epi32(
+				result,
+				_mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)),
+				_mm512_load_si512((__m512i*)(_dst + ptr)),
+				0x96
+			);
+		}
 		_mm512_store_si512 ((__m512i*)(_dst + ptr), result);
 		
 		if(doPrefetch == 1)
@@ -462,6 +545,18 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
 			_mm_prefetch(_pf+ptr, _MM_HINT_T1);
 	}
 }
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	gf16_affine2x_muladd_xn_avx512(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 0);
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_natural_muladd_x_avx512(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	gf16_affine2x_muladd_xn_avx512(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 1);
+}
 #endif /*defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)*/
 
 
@@ -487,3 +582,23 @@ GF16_MULADD_MULTI_FUNCS(gf16_affine2x, _avx512, gf16_affine2x_muladd_x_avx512, 2
 #else
 GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine2x, _avx512)
 #endif
+
+void gf16_affine2x_natural_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	gf16_muladd_single(scratch, &gf16_affine2x_natural_muladd_x_avx512, dst, src, len, coefficient);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+# ifdef PLATFORM_AMD64
+GF16_MULADD_MULTI_FUNCS(gf16_affine2x_natural, _avx512, gf16_affine2x_natural_muladd_x_avx512, 12, sizeof(__m512i), 0, _mm256_zeroupper())
+# else
+GF16_MULADD_MULTI_FUNCS(gf16_affine2x_natural, _avx512, gf16_affine2x_natural_muladd_x_avx512, 2, sizeof(__m512i), 0, _mm256_zeroupper())
+# endif
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine2x_natural, _avx512)
+#endif
@@ -225,6 +225,71 @@ GF16_MULADD_MULTI_FUNCS_STUB(gf16_affine, _gfni)
 #endif
 
 
+#if defined(__GFNI__) && defined(__SSSE3__) && defined(PLATFORM_AMD64)
+// 4 outputs use 8 accumulator registers, leaving room for the input and temporaries
+# define GF16_AFFINE_MULTIOUT_GFNI 4
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_round_gfni(
+	const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const __m128i* mats
+) {
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(__m128i)*2) {
+		__m128i tph[GF16_AFFINE_MULTIOUT_GFNI], tpl[GF16_AFFINE_MULTIOUT_GFNI];
+		for(unsigned out = 0; out < outputs; out++) {
+			tph[out] = _mm_load_si128((__m128i*)(_dst + out*dstStride + ptr));
+			tpl[out] = _mm_load_si128((__m128i*)(_dst + out*dstStride + ptr) + 1);
+		}
+		const __m128i* mat = mats;
+		for(unsigned src = 0; src < srcCount; src++) {
+			__m128i ta = _mm_load_si128((__m128i*)(_src[src] + ptr*srcScale[src]));
+			__m128i tb = _mm_load_si128((__m128i*)(_src[src] + ptr*srcScale[src]) + 1);
+			for(unsigned out = 0; out < outputs; out++) {
+				// matrices are used directly from memory, as there aren't enough registers to hold them
+				tpl[out] = _mm_xor_si128(tpl[out], _mm_gf2p8affine_epi64_epi8(ta, _mm_load_si128(mat + 3), 0));
+				tpl[out] = _mm_xor_si128(tpl[out], _mm_gf2p8affine_epi64_epi8(tb, _mm_load_si128(mat + 0), 0));
+				tph[out] = _mm_xor_si128(tph[out], _mm_gf2p8affine_epi64_epi8(ta, _mm_load_si128(mat + 1), 0));
+				tph[out] = _mm_xor_si128(tph[out], _mm_gf2p8affine_epi64_epi8(tb, _mm_load_si128(mat + 2), 0));
+				mat += 4;
+			}
+		}
+		for(unsigned out = 0; out < outputs; out++) {
+			_mm_store_si128((__m128i*)(_dst + out*dstStride + ptr), tph[out]);
+			_mm_store_si128((__m128i*)(_dst + out*dstStride + ptr) + 1, tpl[out]);
+		}
+	}
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_multiout_x_gfni(
+	const void *HEDLEY_RESTRICT scratch, const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, size_t coeffStride
+) {
+	// each matrix is stored pre-broadcast as 4 vectors: ll, hh, hl, lh
+	__m128i mats[GF16_MULADD_MULTIOUT_MAX_SRC*GF16_AFFINE_MULTIOUT_GFNI*4];
+	for(unsigned src = 0; src < srcCount; src++)
+		for(unsigned out = 0; out < outputs; out++) {
+			__m128i depmask1, depmask2;
+			__m128i* mat = mats + (src*outputs + out)*4;
+			gf16_affine_load_matrix(scratch, coefficients[out*coeffStride + src], &depmask1, &depmask2);
+			mat[0] = _mm_shuffle_epi32(depmask1, _MM_SHUFFLE(1,0,1,0));
+			mat[1] = _mm_unpackhi_epi64(depmask1, depmask1);
+			mat[2] = _mm_shuffle_epi32(depmask2, _MM_SHUFFLE(1,0,1,0));
+			mat[3] = _mm_unpackhi_epi64(depmask2, depmask2);
+		}
+	
+	switch(outputs) {
+		case 4: gf16_affine_muladd_multiout_round_gfni(4, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 3: gf16_affine_muladd_multiout_round_gfni(3, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 2: gf16_affine_muladd_multiout_round_gfni(2, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		case 1: gf16_affine_muladd_multiout_round_gfni(1, _dst, dstStride, srcCount, _src, srcScale, len, mats); break;
+		default: HEDLEY_UNREACHABLE();
+	}
+}
+GF16_MULADD_MULTIOUT_FUNCS(gf16_affine, _gfni, gf16_affine_muladd_multiout_x_gfni, 3, GF16_AFFINE_MULTIOUT_GFNI, sizeof(__m128i)*2, (void)0)
+#else
+GF16_MULADD_MULTIOUT_FUNCS_STUB(gf16_affine, _gfni)
+#endif
+
+
 #include "gf16_bitdep_init_sse2.h"
 void* gf16_affine_init_gfni(int polynomial) {
 #if defined(__SSSE3__)
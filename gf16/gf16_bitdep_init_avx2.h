@@ -82,4 +82,64 @@ static void gf16_bitdep_init256(void* dst, int polynomial, int genAffine) {
 		}
 	}
 }
+#elif defined(__AVX__)
+/* AVX1 version (for the 128-bit VEX XOR-JIT), which generates the same table as above, working on each 128-bit half separately */
+static inline void gf16_bitdep256_store(__m128i* dst, __m128i lo, __m128i hi, int genAffine) {
+	if(genAffine) {
+		_mm_store_si128(dst, _mm_unpacklo_epi64(_mm_unpackhi_epi64(hi, hi), lo));
+		_mm_store_si128(dst+1, _mm_blend_epi16(hi, lo, 0xF0));
+	} else {
+		_mm_store_si128(dst, _mm_or_si128(
+			_mm_and_si128(lo, _mm_set1_epi16(0xff)),
+			_mm_slli_epi16(hi, 8)
+		));
+		_mm_store_si128(dst+1, _mm_or_si128(
+			_mm_and_si128(hi, _mm_set1_epi16((short)0xff00)),
+			_mm_srli_epi16(lo, 8)
+		));
+	}
+}
+
+static void gf16_bitdep_init256(void* dst, int polynomial, int genAffine) {
+	__m128i shuf = _mm_cmpeq_epi8(
+		_mm_setzero_si128(),
+		_mm_and_si128(
+			_mm_shuffle_epi8(
+				_mm_cvtsi32_si128(polynomial & 0xffff),
+				_mm_set_epi32(0, 0, 0x01010101, 0x01010101)
+			),
+			_mm_set_epi32(0x01020408, 0x10204080, 0x01020408, 0x10204080)
+		)
+	);
+	
+	__m128i addvalsLo = genAffine ? _mm_set_epi32(0, 0, 0x01020408, 0x10204080) : _mm_set_epi32(0, 0, 0x80402010, 0x08040201);
+	__m128i addvalsHi = _mm_slli_si128(addvalsLo, 8);
+	for(int val=0; val<16; val++) {
+		__m128i valtest = _mm_set1_epi16(val << 12);
+		__m128i addmask = _mm_srai_epi16(valtest, 15);
+		__m128i depmaskLo = _mm_and_si128(addvalsLo, addmask);
+		__m128i depmaskHi = _mm_and_si128(addvalsHi, addmask);
+		for(int i=0; i<3; i++) {
+			__m128i lastLo = _mm_shuffle_epi8(depmaskLo, shuf);
+			__m128i lastHi = _mm_shuffle_epi8(depmaskHi, shuf);
+			depmaskLo = _mm_xor_si128(_mm_srli_si128(depmaskLo, 1), lastLo);
+			depmaskHi = _mm_xor_si128(_mm_srli_si128(depmaskHi, 1), lastHi);
+			
+			valtest = _mm_add_epi16(valtest, valtest);
+			addmask = _mm_srai_epi16(valtest, 15);
+			depmaskLo = _mm_xor_si128(depmaskLo, _mm_and_si128(addvalsLo, addmask));
+			depmaskHi = _mm_xor_si128(depmaskHi, _mm_and_si128(addvalsHi, addmask));
+		}
+		gf16_bitdep256_store((__m128i*)dst + (val*4 + 0)*2, depmaskLo, depmaskHi, genAffine);
+		for(int j=1; j<4; j++) {
+			for(int i=0; i<4; i++) {
+				__m128i lastLo = _mm_shuffle_epi8(depmaskLo, shuf);
+				__m128i lastHi = _mm_shuffle_epi8(depmaskHi, shuf);
+				depmaskLo = _mm_xor_si128(_mm_srli_si128(depmaskLo, 1), lastLo);
+				depmaskHi = _mm_xor_si128(_mm_srli_si128(depmaskHi, 1), lastHi);
+			}
+			gf16_bitdep256_store((__m128i*)dst + (val*4 + j)*2, depmaskLo, depmaskHi, genAffine);
+		}
+	}
+}
 #endif
@@ -174,4 +174,19 @@ static HEDLEY_ALWAYS_INLINE void _FN(gf16_checksum_prepare)(void *HEDLEY_RESTRIC
 	}
 #undef _X
 }
+
+// block copies for methods which operate directly on the natural layout, so only need packing
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_natural_prepare_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	_MMI(store)((_mword*)dst, _MMI(loadu)((_mword*)src));
+}
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_natural_prepare_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
+	_MMI(store)((_mword*)dst, partial_load(src, remaining));
+}
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_natural_finish_copy_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	_MMI(storeu)((_mword*)dst, _MMI(load)((_mword*)src));
+}
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_natural_finish_copy_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t bytes) {
+	partial_store((_mword*)dst, _MMI(load)((_mword*)src), bytes);
+}
+
 #endif
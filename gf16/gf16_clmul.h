@@ -16,6 +16,19 @@
 
 FUNCS(neon);
 FUNCS(sve2);
+FUNCS(avx2);
+FUNCS(avx512);
+
+#undef FUNCS
+
+#define FUNCS(v) \
+	void gf16_clmul_finish_packed_##v(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen); \
+	int gf16_clmul_finish_packed_cksum_##v(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen); \
+	int gf16_clmul_finish_partial_packsum_##v(void *HEDLEY_RESTRICT dst, void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen, size_t partOffset, size_t partLen); \
+	extern int gf16_clmul_available_##v
+
+FUNCS(avx2);
+FUNCS(avx512);
 
 #undef FUNCS
 
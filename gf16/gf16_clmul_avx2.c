@@ -0,0 +1,37 @@
+
+#include "gf16_global.h"
+#include "../src/platform.h"
+
+#define MWORD_SIZE 32
+#define _mword __m256i
+#define _MM(f) _mm256_ ## f
+#define _MMI(f) _mm256_ ## f ## _si256
+#define _FNSUFFIX _avx2
+#define _MM_END _mm256_zeroupper();
+
+#if defined(__AVX2__) && defined(__VPCLMULQDQ__)
+int gf16_clmul_available_avx2 = 1;
+# define _AVAILABLE
+#else
+int gf16_clmul_available_avx2 = 0;
+#endif
+#include "gf16_clmul_x86.h"
+
+#ifdef _AVAILABLE
+GF16_MULADD_MULTI_FUNCS(gf16_clmul, _avx2, gf16_clmul_muladd_x_avx2, CLMUL_NUM_REGIONS, sizeof(__m256i)*CLMUL_VECS, 0, _mm256_zeroupper())
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_clmul, _avx2)
+#endif
+
+#undef CLMUL_NUM_REGIONS
+#undef CLMUL_VECS
+
+#ifdef _AVAILABLE
+# undef _AVAILABLE
+#endif
+#undef MWORD_SIZE
+#undef _mword
+#undef _MM
+#undef _MMI
+#undef _FNSUFFIX
+#undef _MM_END
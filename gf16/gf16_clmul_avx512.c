@@ -0,0 +1,37 @@
+
+#include "gf16_global.h"
+#include "../src/platform.h"
+
+#define MWORD_SIZE 64
+#define _mword __m512i
+#define _MM(f) _mm512_ ## f
+#define _MMI(f) _mm512_ ## f ## _si512
+#define _FNSUFFIX _avx512
+#define _MM_END _mm256_zeroupper();
+
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(__VPCLMULQDQ__)
+int gf16_clmul_available_avx512 = 1;
+# define _AVAILABLE
+#else
+int gf16_clmul_available_avx512 = 0;
+#endif
+#include "gf16_clmul_x86.h"
+
+#ifdef _AVAILABLE
+GF16_MULADD_MULTI_FUNCS(gf16_clmul, _avx512, gf16_clmul_muladd_x_avx512, CLMUL_NUM_REGIONS, sizeof(__m512i)*CLMUL_VECS, 0, _mm256_zeroupper())
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_clmul, _avx512)
+#endif
+
+#undef CLMUL_NUM_REGIONS
+#undef CLMUL_VECS
+
+#ifdef _AVAILABLE
+# undef _AVAILABLE
+#endif
+#undef MWORD_SIZE
+#undef _mword
+#undef _MM
+#undef _MMI
+#undef _FNSUFFIX
+#undef _MM_END
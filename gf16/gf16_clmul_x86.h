@@ -0,0 +1,155 @@
+
+#include "gf16_global.h"
+#include "../src/platform.h"
+#include "gf16_muladd_multi.h"
+
+// data is left in its natural layout; each block holds 64 bytes (two vectors for AVX2)
+#define CLMUL_VECS (64/MWORD_SIZE)
+#ifdef PLATFORM_AMD64
+# define CLMUL_NUM_REGIONS 6
+#else
+# define CLMUL_NUM_REGIONS 2
+#endif
+
+#ifdef _AVAILABLE
+# include "gf16_checksum_x86.h"
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_prepare_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	for(int v=0; v<CLMUL_VECS; v++)
+		_MMI(store)((_mword*)dst + v, _MMI(loadu)((_mword*)src + v));
+}
+// final block
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_prepare_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
+	memcpy(dst, src, remaining);
+	memset((uint8_t*)dst + remaining, 0, sizeof(_mword)*CLMUL_VECS - remaining);
+}
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_finish_copy_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	for(int v=0; v<CLMUL_VECS; v++)
+		_MMI(storeu)((_mword*)dst + v, _MMI(load)((_mword*)src + v));
+}
+
+# if MWORD_SIZE == 64
+#  define _CLMUL_XOR3(a, b, c) _mm512_ternarylogic_epi32(a, b, c, 0x96)
+#  define _CLMUL_COEFF(c) _mm512_set1_epi64(c)
+# else
+#  define _CLMUL_XOR3(a, b, c) _MMI(xor)(_MMI(xor)(a, b), c)
+#  define _CLMUL_COEFF(c) _mm256_set1_epi64x(c)
+# endif
+
+// multiplies each 16-bit word of a vector, by the coefficient held in the low 16 bits of each 64-bit lane
+// even and odd words are split into separate 32-bit lanes, so that each clmul produces two non-overlapping 31-bit products
+// `prod` accumulates unreduced products as {even lo, even hi, odd lo, odd hi} per vector
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_round)(const void* src, _mword* prod, _mword coeff, int first) {
+	for(int v=0; v<CLMUL_VECS; v++) {
+		_mword data = _MMI(load)((_mword*)src + v);
+		_mword ev = _MMI(and)(data, _MM(set1_epi32)(0xffff));
+		_mword od = _MM(srli_epi32)(data, 16);
+
+		_mword evLo = _MM(clmulepi64_epi128)(ev, coeff, 0x00);
+		_mword evHi = _MM(clmulepi64_epi128)(ev, coeff, 0x01);
+		_mword odLo = _MM(clmulepi64_epi128)(od, coeff, 0x00);
+		_mword odHi = _MM(clmulepi64_epi128)(od, coeff, 0x01);
+		if(first) {
+			prod[v*4 +0] = evLo;
+			prod[v*4 +1] = evHi;
+			prod[v*4 +2] = odLo;
+			prod[v*4 +3] = odHi;
+		} else {
+			prod[v*4 +0] = _MMI(xor)(prod[v*4 +0], evLo);
+			prod[v*4 +1] = _MMI(xor)(prod[v*4 +1], evHi);
+			prod[v*4 +2] = _MMI(xor)(prod[v*4 +2], odLo);
+			prod[v*4 +3] = _MMI(xor)(prod[v*4 +3], odHi);
+		}
+	}
+}
+
+// reduces 31-bit products modulo 0x1100b, and returns the 16-bit words in their original order
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_clmul_reduce)(const _mword* prod) {
+	// only the low 64 bits of each clmul result is populated
+	_mword ev = _MM(unpacklo_epi64)(prod[0], prod[1]);
+	_mword od = _MM(unpacklo_epi64)(prod[2], prod[3]);
+
+	// gather the low and high halves of each product
+# if MWORD_SIZE == 64
+	_mword lo = _mm512_mask_blend_epi16(0xAAAAAAAA, ev, _mm512_slli_epi32(od, 16));
+	_mword hi = _mm512_mask_blend_epi16(0xAAAAAAAA, _mm512_srli_epi32(ev, 16), od);
+# else
+	_mword lo = _mm256_blend_epi16(ev, _mm256_slli_epi32(od, 16), 0xAA);
+	_mword hi = _mm256_blend_epi16(_mm256_srli_epi32(ev, 16), od, 0xAA);
+# endif
+
+	// Barrett reduction: compute the quotient floor(hi*x^16 / 0x1100b), then subtract (xor) quotient*0x1100b from the product
+	// as hi is at most 15 bits, the quotient can be computed with a few shifts
+	_mword e = _MMI(xor)(_MM(srli_epi16)(hi, 4), _MM(srli_epi16)(hi, 13));
+	_mword q = _CLMUL_XOR3(hi, e, _MMI(xor)(_MM(srli_epi16)(e, 4), _MM(srli_epi16)(e, 8)));
+	// the x^16 term of the polynomial is cancelled out by hi, so only the low part of q*0x1100b needs to be computed
+	lo = _CLMUL_XOR3(lo, q, _MM(slli_epi16)(q, 1));
+	return _CLMUL_XOR3(lo, _MM(slli_epi16)(q, 3), _MM(slli_epi16)(q, 12));
+}
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_muladd_x)(
+	const void *HEDLEY_RESTRICT scratch,
+	uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len,
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	GF16_MULADD_MULTI_SRC_UNUSED(CLMUL_NUM_REGIONS);
+	UNUSED(scratch);
+
+	_mword coeff[CLMUL_NUM_REGIONS];
+	for(int src=0; src<srcCount; src++)
+		coeff[src] = _CLMUL_COEFF(coefficients[src]);
+
+	// one block is a cacheline, so prefetch once per iteration
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(_mword)*CLMUL_VECS) {
+		_mword prod[CLMUL_VECS*4];
+		_FN(gf16_clmul_round)(_src1+ptr*srcScale, prod, coeff[0], 1);
+		if(srcCount > 1)
+			_FN(gf16_clmul_round)(_src2+ptr*srcScale, prod, coeff[1], 0);
+#ifdef PLATFORM_AMD64
+		if(srcCount > 2)
+			_FN(gf16_clmul_round)(_src3+ptr*srcScale, prod, coeff[2], 0);
+		if(srcCount > 3)
+			_FN(gf16_clmul_round)(_src4+ptr*srcScale, prod, coeff[3], 0);
+		if(srcCount > 4)
+			_FN(gf16_clmul_round)(_src5+ptr*srcScale, prod, coeff[4], 0);
+		if(srcCount > 5)
+			_FN(gf16_clmul_round)(_src6+ptr*srcScale, prod, coeff[5], 0);
+#endif
+
+		for(int v=0; v<CLMUL_VECS; v++) {
+			_mword* dst = (_mword*)(_dst+ptr) + v;
+			_MMI(store)(dst, _MMI(xor)(_MMI(load)(dst), _FN(gf16_clmul_reduce)(prod + v*4)));
+		}
+
+		if(doPrefetch == 1)
+			_mm_prefetch(_pf+ptr, MM_HINT_WT1);
+		if(doPrefetch == 2)
+			_mm_prefetch(_pf+ptr, _MM_HINT_T2);
+	}
+}
+# undef _CLMUL_XOR3
+# undef _CLMUL_COEFF
+#endif /*defined(_AVAILABLE)*/
+
+
+void _FN(gf16_clmul_muladd)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	gf16_muladd_single(scratch, &_FN(gf16_clmul_muladd_x), dst, src, len, val);
+	_MM_END
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(val);
+#endif
+}
+
+#ifdef _AVAILABLE
+GF_PREPARE_PACKED_FUNCS(gf16_clmul, _FNSUFFIX, sizeof(_mword)*CLMUL_VECS, _FN(gf16_clmul_prepare_block), _FN(gf16_clmul_prepare_blocku), CLMUL_NUM_REGIONS, _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare), sizeof(_mword))
+#else
+GF_PREPARE_PACKED_FUNCS_STUB(gf16_clmul, _FNSUFFIX)
+#endif
+
+#ifdef _AVAILABLE
+GF_FINISH_PACKED_FUNCS(gf16_clmul, _FNSUFFIX, sizeof(_mword)*CLMUL_VECS, _FN(gf16_clmul_finish_copy_block), gf16_copy_blocku, 1, _MM_END, _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), NULL, sizeof(_mword))
+#else
+GF_FINISH_PACKED_FUNCS_STUB(gf16_clmul, _FNSUFFIX)
+#endif
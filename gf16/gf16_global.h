@@ -216,12 +216,30 @@ static HEDLEY_ALWAYS_INLINE void gf16_prepare_packed(
 
 
 
+// if a non-temporal store function is supplied, the block is finished into a temporary buffer, so that the checksum doesn't need to read back from the destination
+#define GF16_FINISH_NT_MAX_BLOCKLEN 1024
+static HEDLEY_ALWAYS_INLINE void gf16_finish_packed_block(
+	void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, const size_t blockLen, gf16_transform_block finishBlock,
+	gf16_checksum_block checksumBlock, void *HEDLEY_RESTRICT checksum, gf16_transform_block storeBlockNT
+) {
+	if(storeBlockNT) {
+		ALIGN_TO(64, uint8_t tmp[GF16_FINISH_NT_MAX_BLOCKLEN]);
+		ASSUME(blockLen <= sizeof(tmp));
+		finishBlock(tmp, src);
+		if(checksumBlock) checksumBlock(tmp, checksum, blockLen, 1);
+		storeBlockNT(dst, tmp);
+	} else {
+		finishBlock(dst, src);
+		if(checksumBlock) checksumBlock(dst, checksum, blockLen, 0);
+	}
+}
+
 static HEDLEY_ALWAYS_INLINE int gf16_finish_packed(
 	void *HEDLEY_RESTRICT dst, void *HEDLEY_RESTRICT src, size_t sliceLen, const size_t blockLen, gf16_transform_block finishBlock, gf16_transform_blocku finishBlockU,
 	unsigned numOutputs, unsigned outputNum, size_t chunkLen, const unsigned interleaveSize,
 	size_t partOffset, size_t partLen,
 	gf16_checksum_block checksumBlock, gf16_checksum_blocku checksumBlockU, gf16_checksum_exp checksumExp, gf16_finish_block inlineFinishBlock,
-	size_t accessAlign
+	size_t accessAlign, gf16_transform_block storeBlockNT
 ) {
 	size_t checksumLen = checksumBlock ? blockLen : 0;
 	size_t alignedSliceLen = sliceLen + blockLen-1;
@@ -277,8 +295,7 @@ static HEDLEY_ALWAYS_INLINE int gf16_finish_packed(
 			// last block doesn't align to stride
 			for(; pos<dataChunkLen-blockLen; pos+=blockLen) {
 				if(!partLeft) return 0;
-				finishBlock(_dst + pos, _src + pos*interleaveBy);
-				if(checksumBlock) checksumBlock(_dst + pos, checksum, blockLen, 0);
+				gf16_finish_packed_block(_dst + pos, _src + pos*interleaveBy, blockLen, finishBlock, checksumBlock, checksum, storeBlockNT);
 				partLeft -= blockLen;
 			}
 			if(!partLeft) return 0;
@@ -289,8 +306,7 @@ static HEDLEY_ALWAYS_INLINE int gf16_finish_packed(
 		} else {
 			for(; pos<dataChunkLen; pos+=blockLen) {
 				if(!partLeft) return 0;
-				finishBlock(_dst + pos, _src + pos*interleaveBy);
-				if(checksumBlock) checksumBlock(_dst + pos, checksum, blockLen, 0);
+				gf16_finish_packed_block(_dst + pos, _src + pos*interleaveBy, blockLen, finishBlock, checksumBlock, checksum, storeBlockNT);
 				partLeft -= blockLen;
 			}
 		}
@@ -306,8 +322,7 @@ static HEDLEY_ALWAYS_INLINE int gf16_finish_packed(
 		
 		for(; pos < (remaining - (remaining%blockLen)); pos+=blockLen) {
 			if(!partLeft) return 0;
-			finishBlock(_dst + pos, _src + pos*interleaveBy);
-			if(checksumBlock) checksumBlock(_dst + pos, checksum, blockLen, 0);
+			gf16_finish_packed_block(_dst + pos, _src + pos*interleaveBy, blockLen, finishBlock, checksumBlock, checksum, storeBlockNT);
 			partLeft -= blockLen;
 		}
 		if(!partLeft) return 0;
@@ -360,6 +375,18 @@ void TOKENPASTE3(fnpre , _prepare_partial_packsum , fnsuf)(void *HEDLEY_RESTRICT
 	if(partOffset + partLen == srcLen) ALIGN_FREE(checksum); \
 }
 
+// variant of the above, where the caller supplies a prepfn which uses non-temporal stores; only the full slice function is generated, as it's the only one used with large buffers
+#define GF_PREPARE_PACKED_CKSUM_NT_FUNCS(fnpre, fnsuf, blksize, prepfn, prepufn, interleave, finisher, cksumInit, cksumfn, cksumufn, cksumxfn, cksumprepfn) \
+void TOKENPASTE3(fnpre , _prepare_packed_cksum_nt , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen, size_t sliceLen, unsigned inputPackSize, unsigned inputNum, size_t chunkLen) { \
+	cksumInit; \
+	gf16_prepare_packed(dst, src, srcLen, sliceLen, blksize, &prepfn, &prepufn, inputPackSize, inputNum, chunkLen, interleave, 0, srcLen, &checksum, &cksumfn, &cksumufn, &cksumxfn, &cksumprepfn); \
+	finisher; \
+}
+#define GF_PREPARE_PACKED_CKSUM_NT_FUNCS_STUB(fnpre, fnsuf) \
+void TOKENPASTE3(fnpre , _prepare_packed_cksum_nt , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen, size_t sliceLen, unsigned inputPackSize, unsigned inputNum, size_t chunkLen) { \
+	UNUSED(dst); UNUSED(src); UNUSED(srcLen); UNUSED(sliceLen); UNUSED(inputPackSize); UNUSED(inputNum); UNUSED(chunkLen); \
+}
+
 #define GF_PREPARE_PACKED_FUNCS(fnpre, fnsuf, blksize, prepfn, prepufn, interleave, finisher, cksumInit, cksumfn, cksumufn, cksumxfn, cksumprepfn, align) \
 void TOKENPASTE3(fnpre , _prepare_packed , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen, size_t sliceLen, unsigned inputPackSize, unsigned inputNum, size_t chunkLen) { \
 	gf16_prepare_packed(dst, src, srcLen, sliceLen, blksize, &prepfn, &prepufn, inputPackSize, inputNum, chunkLen, interleave, 0, srcLen, NULL, NULL, NULL, NULL, NULL); \
@@ -383,20 +410,36 @@ GF_PREPARE_PACKED_CKSUM_FUNCS_STUB(fnpre, fnsuf)
 
 #define GF_FINISH_PACKED_FUNCS(fnpre, fnsuf, blksize, finfn, finufn, interleave, finisher, cksumfn, cksumufn, cksumxfn, ilfinfn, align) \
 void TOKENPASTE3(fnpre , _finish_packed , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen) { \
-	gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, 0, sliceLen, NULL, NULL, NULL, NULL, align); \
+	gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, 0, sliceLen, NULL, NULL, NULL, NULL, align, NULL); \
 	finisher; \
 } \
 int TOKENPASTE3(fnpre , _finish_packed_cksum , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen) { \
-	int result = gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, 0, sliceLen, &cksumfn, &cksumufn, &cksumxfn, ilfinfn, align); \
+	int result = gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, 0, sliceLen, &cksumfn, &cksumufn, &cksumxfn, ilfinfn, align, NULL); \
 	finisher; \
 	return result; \
 } \
 int TOKENPASTE3(fnpre , _finish_partial_packsum , fnsuf)(void *HEDLEY_RESTRICT dst, void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen, size_t partOffset, size_t partLen) { \
-	int result = gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, partOffset, partLen, &cksumfn, &cksumufn, &cksumxfn, ilfinfn, align); \
+	int result = gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, partOffset, partLen, &cksumfn, &cksumufn, &cksumxfn, ilfinfn, align, NULL); \
 	finisher; \
 	return result; \
 }
 
+// non-temporal store variant of finish_packed_cksum; storefn copies a finished block to the destination, bypassing the cache
+// as such stores need an aligned destination, this falls back to the regular function (which must be defined) if the destination isn't aligned
+#define GF_FINISH_PACKED_CKSUM_NT_FUNCS(fnpre, fnsuf, blksize, finfn, finufn, interleave, finisher, cksumfn, cksumufn, cksumxfn, ilfinfn, align, storefn) \
+int TOKENPASTE3(fnpre , _finish_packed_cksum_nt , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen) { \
+	if((uintptr_t)dst & (align-1)) \
+		return TOKENPASTE3(fnpre , _finish_packed_cksum , fnsuf)(dst, src, sliceLen, numOutputs, outputNum, chunkLen); \
+	int result = gf16_finish_packed(dst, (void *HEDLEY_RESTRICT)src, sliceLen, blksize, &finfn, &finufn, numOutputs, outputNum, chunkLen, interleave, 0, sliceLen, &cksumfn, &cksumufn, &cksumxfn, ilfinfn, align, &storefn); \
+	finisher; \
+	return result; \
+}
+#define GF_FINISH_PACKED_CKSUM_NT_FUNCS_STUB(fnpre, fnsuf) \
+int TOKENPASTE3(fnpre , _finish_packed_cksum_nt , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen) { \
+	UNUSED(dst); UNUSED(src); UNUSED(sliceLen); UNUSED(numOutputs); UNUSED(outputNum); UNUSED(chunkLen); \
+	return 0; \
+}
+
 #define GF_FINISH_PACKED_FUNCS_STUB(fnpre, fnsuf) \
 void TOKENPASTE3(fnpre , _finish_packed , fnsuf)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t sliceLen, unsigned numOutputs, unsigned outputNum, size_t chunkLen) { \
 	UNUSED(dst); UNUSED(src); UNUSED(sliceLen); UNUSED(numOutputs); UNUSED(outputNum); UNUSED(chunkLen); \
@@ -1,7 +1,9 @@
 
+#include "gf16_lookup.h"
 #include "gf16_global.h"
 #include "../src/platform.h"
 #include "gf16_checksum_generic.h"
+#include "gf16_muladd_multi.h"
 
 #define GF16_MULTBY_TWO_X2(p) ((((p) << 1) & 0xffffffff) ^ ((GF16_POLYNOMIAL ^ ((GF16_POLYNOMIAL&0xffff) << 16)) & -((p) >> 31)))
 #define GF16_MULTBY_TWO_X4(p) ( \
@@ -309,6 +311,155 @@ HEDLEY_CONST size_t gf16_lookup_stride() {
 }
 
 
+// tables are small enough to keep a few around, allowing the destination to be read/written once for multiple regions
+// more regions per pass seems to be slower, likely due to register pressure on the source pointers
+#define LOOKUP_MULTI_REGIONS 2
+static HEDLEY_ALWAYS_INLINE void gf16_lookup_muladd_x(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale,
+	GF16_MULADD_MULTI_SRCLIST, size_t len,
+	const uint16_t *HEDLEY_RESTRICT coefficients,
+	const int doPrefetch, const char* _pf
+) {
+	GF16_MULADD_MULTI_SRC_UNUSED(LOOKUP_MULTI_REGIONS);
+	UNUSED(scratch); UNUSED(doPrefetch); UNUSED(_pf);
+	
+	uint16_t lhtable[LOOKUP_MULTI_REGIONS][512];
+	const uint8_t* srcs[LOOKUP_MULTI_REGIONS] = {_src1, _src2};
+	for(int src=0; src<srcCount; src++)
+		calc_table(coefficients[src], lhtable[src]);
+	
+	#define LH_LOOKUP(src, p) (lhtable[src][srcs[src][(ptr+p)*srcScale]] ^ lhtable[src][256 + srcs[src][(ptr+p)*srcScale + 1]])
+	if(sizeof(uintptr_t) >= 8) { // process in 64-bit
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=8) {
+			uint16_t r0 = LH_LOOKUP(0, 0), r1 = LH_LOOKUP(0, 2), r2 = LH_LOOKUP(0, 4), r3 = LH_LOOKUP(0, 6);
+			for(int src=1; src<srcCount; src++) {
+				r0 ^= LH_LOOKUP(src, 0);
+				r1 ^= LH_LOOKUP(src, 2);
+				r2 ^= LH_LOOKUP(src, 4);
+				r3 ^= LH_LOOKUP(src, 6);
+			}
+			writeXor64(_dst + ptr, PACK_4X16(r0, r1, r2, r3));
+		}
+	}
+	else if(sizeof(uintptr_t) >= 4) { // assume 32-bit CPU
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=4) {
+			uint16_t r0 = LH_LOOKUP(0, 0), r1 = LH_LOOKUP(0, 2);
+			for(int src=1; src<srcCount; src++) {
+				r0 ^= LH_LOOKUP(src, 0);
+				r1 ^= LH_LOOKUP(src, 2);
+			}
+			writeXor32(_dst + ptr, PACK_2X16(r0, r1));
+		}
+	}
+	else { // use 2 byte wordsize
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=2) {
+			uint16_t r0 = LH_LOOKUP(0, 0);
+			for(int src=1; src<srcCount; src++)
+				r0 ^= LH_LOOKUP(src, 0);
+			writeXor16(_dst + ptr, r0);
+		}
+	}
+	#undef LH_LOOKUP
+}
+
+void gf16_lookup_muladd_multi_packed(const void *HEDLEY_RESTRICT scratch, unsigned packRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+	gf16_muladd_multi_packed(scratch, &gf16_lookup_muladd_x, 1, LOOKUP_MULTI_REGIONS, packRegions, regions, dst, src, len, gf16_lookup_stride(), coefficients);
+}
+
+
+
+// 'fat' table: a single 64K entry (128KB) table indexed by the whole 16-bit word, halving the number of lookups at the expense of L2 cache
+// as the table is too large for the stack, it's held in the thread's mutable scratch space, along with the split table it's built from
+struct gf16_lookup_fat_scratch {
+	uint16_t fat[65536];
+	uint16_t lh[512];
+};
+static HEDLEY_ALWAYS_INLINE void calc_fat_table(uint16_t coefficient, struct gf16_lookup_fat_scratch* table) {
+	uint16_t* lhtable = table->lh;
+	uint16_t* fattable = table->fat;
+	calc_table(coefficient, lhtable);
+	
+	// entries are indexed by the word as read in native byte order
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	const uint16_t* rowTable = lhtable;
+	const uint16_t* colTable = lhtable + 256;
+#else
+	const uint16_t* rowTable = lhtable + 256;
+	const uint16_t* colTable = lhtable;
+#endif
+	for(int row=0; row<256; row++) {
+		uint16_t* fatRow = fattable + row*256;
+		if(sizeof(uintptr_t) >= 8) {
+			uint64_t rowVal = rowTable[row] * 0x0001000100010001ULL;
+			for(int col=0; col<256; col+=4)
+				write64(fatRow + col, rowVal ^ read64(colTable + col));
+		} else if(sizeof(uintptr_t) >= 4) {
+			uint32_t rowVal = rowTable[row] * 0x00010001UL;
+			for(int col=0; col<256; col+=2)
+				write32(fatRow + col, rowVal ^ read32(colTable + col));
+		} else {
+			uint16_t rowVal = rowTable[row];
+			for(int col=0; col<256; col++)
+				fatRow[col] = rowVal ^ colTable[col];
+		}
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE void gf16_lookup_fat_process(const uint16_t *HEDLEY_RESTRICT fattable, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, const int doAdd) {
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	if(sizeof(uintptr_t) >= 8) { // process in 64-bit
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=8) {
+			uint64_t result = PACK_4X16(
+				fattable[read16(_src + ptr)],
+				fattable[read16(_src + ptr + 2)],
+				fattable[read16(_src + ptr + 4)],
+				fattable[read16(_src + ptr + 6)]
+			);
+			if(doAdd) writeXor64(_dst + ptr, result);
+			else write64(_dst + ptr, result);
+		}
+	}
+	else if(sizeof(uintptr_t) >= 4) { // assume 32-bit CPU
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=4) {
+			uint32_t result = PACK_2X16(
+				fattable[read16(_src + ptr)],
+				fattable[read16(_src + ptr + 2)]
+			);
+			if(doAdd) writeXor32(_dst + ptr, result);
+			else write32(_dst + ptr, result);
+		}
+	}
+	else { // use 2 byte wordsize
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=2) {
+			if(doAdd) writeXor16(_dst + ptr, fattable[read16(_src + ptr)]);
+			else write16(_dst + ptr, fattable[read16(_src + ptr)]);
+		}
+	}
+}
+
+void gf16_lookup_fat_mul(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(scratch);
+	struct gf16_lookup_fat_scratch* table = (struct gf16_lookup_fat_scratch*)mutScratch;
+	calc_fat_table(coefficient, table);
+	gf16_lookup_fat_process(table->fat, dst, src, len, 0);
+}
+void gf16_lookup_fat_muladd(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(scratch);
+	struct gf16_lookup_fat_scratch* table = (struct gf16_lookup_fat_scratch*)mutScratch;
+	calc_fat_table(coefficient, table);
+	gf16_lookup_fat_process(table->fat, dst, src, len, 1);
+}
+void* gf16_lookup_fat_init_mut() {
+	return malloc(sizeof(struct gf16_lookup_fat_scratch));
+}
+void gf16_lookup_fat_uninit_mut(void* mutScratch) {
+	free(mutScratch);
+}
+
+
 
 struct gf16_lookup3_tables {
 	uint16_t table1[2048]; // bits  0-10
@@ -525,43 +676,58 @@ static HEDLEY_ALWAYS_INLINE void calc_2table(uint16_t coefficient, struct gf16_l
 }
 
 
-unsigned gf16_lookup3_muladd_multi_packed(const void *HEDLEY_RESTRICT scratch, unsigned packRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(scratch); UNUSED(packRegions); UNUSED(mutScratch);
+// two regions' tables (16KB) are kept at once, which still fits in the L1 cache of most CPUs
+#define LOOKUP3_MULTI_REGIONS 2
+static HEDLEY_ALWAYS_INLINE void gf16_lookup3_muladd_x(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale,
+	GF16_MULADD_MULTI_SRCLIST, size_t len,
+	const uint16_t *HEDLEY_RESTRICT coefficients,
+	const int doPrefetch, const char* _pf
+) {
+	GF16_MULADD_MULTI_SRC_UNUSED(LOOKUP3_MULTI_REGIONS);
+	UNUSED(scratch); UNUSED(doPrefetch); UNUSED(_pf);
 	
-	uint8_t* _dst = (uint8_t*)dst + len;
-	uint8_t* _src = (uint8_t*)src;
-	for(unsigned region=0; region<regions; region++) {
-		struct gf16_lookup2_tables lookup;
-		calc_2table(coefficients[region], &lookup);
-		_src += len;
-		
-		if(sizeof(uintptr_t) >= 8) { // assume 64-bit CPU
-			for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=8) {
-				uint64_t data = read64(_src + ptr);
+	struct gf16_lookup2_tables lookup[LOOKUP3_MULTI_REGIONS];
+	const uint8_t* srcs[LOOKUP3_MULTI_REGIONS] = {_src1, _src2};
+	for(int src=0; src<srcCount; src++)
+		calc_2table(coefficients[src], lookup + src);
+	
+	if(sizeof(uintptr_t) >= 8) { // assume 64-bit CPU
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=8) {
+			uint64_t result = 0;
+			for(int src=0; src<srcCount; src++) {
+				uint64_t data = read64(srcs[src] + ptr*srcScale);
 				uint32_t data2 = data >> 32;
-				writeXor64(_dst + ptr, (
-					(uint32_t)lookup.table1[data & 0x7ff] ^
-					lookup.table2[(data & 0xffc00000) >> 22] ^
-					((uint32_t)lookup.table1[(data & 0x3ff800) >> 11] << 16)
+				result ^= (
+					(uint32_t)lookup[src].table1[data & 0x7ff] ^
+					lookup[src].table2[(data & 0xffc00000) >> 22] ^
+					((uint32_t)lookup[src].table1[(data & 0x3ff800) >> 11] << 16)
 				) ^ ((uint64_t)(
-					(uint64_t)lookup.table1[data2 & 0x7ff] ^
-					lookup.table2[data2 >> 22]
+					(uint64_t)lookup[src].table1[data2 & 0x7ff] ^
+					lookup[src].table2[data2 >> 22]
 				) << 32) ^
-				((uint64_t)lookup.table1[(data2 & 0x3ff800) >> 11] << 48));
+				((uint64_t)lookup[src].table1[(data2 & 0x3ff800) >> 11] << 48);
 			}
+			writeXor64(_dst + ptr, result);
 		}
-		else {
-			for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=4) {
-				uint32_t data = read32(_src + ptr);
-				writeXor32(_dst + ptr,
-					(uint32_t)lookup.table1[data & 0x7ff] ^
-					lookup.table2[data >> 22] ^
-					((uint32_t)lookup.table1[(data & 0x3ff800) >> 11] << 16)
-				);
+	}
+	else {
+		for(intptr_t ptr = -(intptr_t)len; ptr; ptr+=4) {
+			uint32_t result = 0;
+			for(int src=0; src<srcCount; src++) {
+				uint32_t data = read32(srcs[src] + ptr*srcScale);
+				result ^= (uint32_t)lookup[src].table1[data & 0x7ff] ^
+					lookup[src].table2[data >> 22] ^
+					((uint32_t)lookup[src].table1[(data & 0x3ff800) >> 11] << 16);
 			}
+			writeXor32(_dst + ptr, result);
 		}
 	}
-	return regions;
+}
+
+void gf16_lookup3_muladd_multi_packed(const void *HEDLEY_RESTRICT scratch, unsigned packRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+	gf16_muladd_multi_packed(scratch, &gf16_lookup3_muladd_x, 1, LOOKUP3_MULTI_REGIONS, packRegions, regions, dst, src, len, gf16_lookup3_stride(), coefficients);
 }
 
 
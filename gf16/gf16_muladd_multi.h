@@ -3,6 +3,10 @@
 	const uint8_t* _src1, const uint8_t* _src2, const uint8_t* _src3, const uint8_t* _src4, const uint8_t* _src5, const uint8_t* _src6, \
 	const uint8_t* _src7, const uint8_t* _src8, const uint8_t* _src9, const uint8_t* _src10, const uint8_t* _src11, const uint8_t* _src12, \
 	const uint8_t* _src13, const uint8_t* _src14, const uint8_t* _src15, const uint8_t* _src16, const uint8_t* _src17, const uint8_t* _src18
+// for passing the above list through to another kernel
+#define GF16_MULADD_MULTI_SRCLIST_FORWARD srcCount, \
+	_src1, _src2, _src3, _src4, _src5, _src6, _src7, _src8, _src9, \
+	_src10, _src11, _src12, _src13, _src14, _src15, _src16, _src17, _src18
 #define GF16_MULADD_MULTI_SRC_UNUSED(max) \
 	HEDLEY_ASSUME(srcCount <= max); \
 	if(max < 2) UNUSED(_src2); \
@@ -40,6 +44,20 @@ void fnpre ## _muladd_multi_packpf ## fnsuf(const void *HEDLEY_RESTRICT scratch,
 	finisher; \
 }
 
+// output-blocked variant: each call multiplies the packed inputs into `outputs` destinations (spaced `len` apart), loading each input block once for all destinations
+// coefficients for each output are spaced `packedRegions` apart
+#define GF16_MULADD_MULTIOUT_FUNCS(fnpre, fnsuf, xfn, interleave, outputsPerCall, blocksize, finisher) \
+void fnpre ## _muladd_multiout_packed ## fnsuf(const void *HEDLEY_RESTRICT scratch, unsigned packedRegions, unsigned regions, unsigned outputs, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) { \
+	UNUSED(mutScratch); \
+	gf16_muladd_multiout_packed(scratch, &xfn, interleave, outputsPerCall, packedRegions, regions, outputs, dst, src, len, blocksize, coefficients); \
+	finisher; \
+}
+#define GF16_MULADD_MULTIOUT_FUNCS_STUB(fnpre, fnsuf) \
+void fnpre ## _muladd_multiout_packed ## fnsuf(const void *HEDLEY_RESTRICT scratch, unsigned packedRegions, unsigned regions, unsigned outputs, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) { \
+	UNUSED(mutScratch); \
+	UNUSED(scratch); UNUSED(packedRegions); UNUSED(regions); UNUSED(outputs); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); \
+}
+
 #define GF16_MULADD_MULTI_FUNCS_STUB(fnpre, fnsuf) \
 void fnpre ## _muladd_multi ## fnsuf(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) { \
 	UNUSED(mutScratch); \
@@ -524,3 +542,44 @@ static HEDLEY_ALWAYS_INLINE void gf16_muladd_multi_packpf(const void *HEDLEY_RES
 }
 
 #undef REMAINING_CASES
+
+
+// maximum number of inputs handled per output-blocked kernel call; the kernel holds a matrix per input+output pair, so this bounds its stack usage
+#define GF16_MULADD_MULTIOUT_MAX_SRC 16
+
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__OPTIMIZE__)
+typedef void (*fMuladdMultiOut)
+#else
+typedef void (*const fMuladdMultiOut)
+#endif
+(const void *HEDLEY_RESTRICT scratch, const unsigned outputs, uint8_t *HEDLEY_RESTRICT _dst, size_t dstStride,
+	const unsigned srcCount, const uint8_t* const* _src, const unsigned* srcScale,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, size_t coeffStride
+);
+
+static HEDLEY_ALWAYS_INLINE void gf16_muladd_multiout_packed(const void *HEDLEY_RESTRICT scratch, fMuladdMultiOut muladd_mo, const unsigned interleave, const unsigned outputsPerCall, unsigned inputPackSize, unsigned regions, unsigned outputs, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, size_t blockLen, const uint16_t *HEDLEY_RESTRICT coefficients) {
+	ASSUME(regions <= inputPackSize);
+	
+	const uint8_t* _src = (const uint8_t*)src;
+	const uint8_t* srcList[GF16_MULADD_MULTIOUT_MAX_SRC];
+	unsigned srcScale[GF16_MULADD_MULTIOUT_MAX_SRC];
+	
+	for(unsigned region = 0; region < regions; region += GF16_MULADD_MULTIOUT_MAX_SRC) {
+		unsigned srcCount = regions - region > GF16_MULADD_MULTIOUT_MAX_SRC ? GF16_MULADD_MULTIOUT_MAX_SRC : regions - region;
+		// locate each input's end point in the interleaved layout (see gf16_muladd_multi_packed)
+		for(unsigned i = 0; i < srcCount; i++) {
+			unsigned groupStart = (region + i) - (region + i) % interleave;
+			unsigned groupSize = inputPackSize - groupStart > interleave ? interleave : inputPackSize - groupStart;
+			srcList[i] = _src + groupStart * len + len*groupSize + blockLen*((region + i) % interleave);
+			srcScale[i] = groupSize;
+		}
+		for(unsigned out = 0; out < outputs; out += outputsPerCall) {
+			muladd_mo(
+				scratch, outputs - out > outputsPerCall ? outputsPerCall : outputs - out,
+				(uint8_t*)dst + out*len + len, len,
+				srcCount, srcList, srcScale,
+				len, coefficients + out*inputPackSize + region, inputPackSize
+			);
+		}
+	}
+}
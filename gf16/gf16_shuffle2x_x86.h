@@ -4,32 +4,16 @@
 
 #ifdef _AVAILABLE
 # include "gf16_checksum_x86.h"
-static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_prepare_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
-	_mword data = _MMI(loadu)((_mword*)src);
-	
-	data = separate_low_high(data);
-#if MWORD_SIZE >= 64
-	data = _mm512_permutexvar_epi64(_mm512_set_epi64(7,5,3,1, 6,4,2,0), data);
-#else
-	data = _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
-#endif
-	
-	_MMI(store)((_mword*)dst, data);
-}
-static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_prepare_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
-	_mword data = partial_load(src, remaining);
-	
+// converts 16-bit words in natural layout to the split low/high byte layout used by shuffle2x
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_shuffle2x_transform)(_mword data) {
 	data = separate_low_high(data);
 #if MWORD_SIZE >= 64
-	data = _mm512_permutexvar_epi64(_mm512_set_epi64(7,5,3,1, 6,4,2,0), data);
+	return _mm512_permutexvar_epi64(_mm512_set_epi64(7,5,3,1, 6,4,2,0), data);
 #else
-	data = _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
+	return _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
 #endif
-	
-	_MMI(store)((_mword*)dst, data);
 }
-
-static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_finish_block)(void *HEDLEY_RESTRICT dst) {
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_shuffle2x_untransform)(_mword data) {
 	_mword shuf = _MM(set_epi32)(
 #if MWORD_SIZE >= 64
 		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
@@ -37,56 +21,39 @@ static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_finish_block)(void *HEDLEY_R
 #endif
 		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
 		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
-	);	
-	_mword data = _MMI(load)((_mword*)dst);
-	
+	);
 #if MWORD_SIZE >= 64
 	data = _mm512_permutexvar_epi64(_mm512_set_epi64(7,3, 6,2, 5,1, 4,0), data);
 #else
 	data = _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
 #endif
-	data = _MM(shuffle_epi8)(data, shuf);
-	
+	return _MM(shuffle_epi8)(data, shuf);
+}
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_prepare_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	_mword data = _MMI(loadu)((_mword*)src);
+	data = _FN(gf16_shuffle2x_transform)(data);
+	_MMI(store)((_mword*)dst, data);
+}
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_prepare_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
+	_mword data = partial_load(src, remaining);
+	data = _FN(gf16_shuffle2x_transform)(data);
+	_MMI(store)((_mword*)dst, data);
+}
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_finish_block)(void *HEDLEY_RESTRICT dst) {
+	_mword data = _MMI(load)((_mword*)dst);
+	data = _FN(gf16_shuffle2x_untransform)(data);
 	_MMI(store)((_mword*)dst, data);
 }
 static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_finish_copy_block)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
-	_mword shuf = _MM(set_epi32)(
-#if MWORD_SIZE >= 64
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-#endif
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
-	);	
 	_mword data = _MMI(load)((_mword*)src);
-	
-#if MWORD_SIZE >= 64
-	data = _mm512_permutexvar_epi64(_mm512_set_epi64(7,3, 6,2, 5,1, 4,0), data);
-#else
-	data = _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
-#endif
-	data = _MM(shuffle_epi8)(data, shuf);
-	
+	data = _FN(gf16_shuffle2x_untransform)(data);
 	_MMI(storeu)((_mword*)dst, data);
 }
 static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle2x_finish_copy_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t bytes) {
-	_mword shuf = _MM(set_epi32)(
-#if MWORD_SIZE >= 64
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-#endif
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
-		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
-	);	
 	_mword data = _MMI(load)((_mword*)src);
-	
-#if MWORD_SIZE >= 64
-	data = _mm512_permutexvar_epi64(_mm512_set_epi64(7,3, 6,2, 5,1, 4,0), data);
-#else
-	data = _mm256_permute4x64_epi64(data, _MM_SHUFFLE(3,1,2,0));
-#endif
-	data = _MM(shuffle_epi8)(data, shuf);
-	
+	data = _FN(gf16_shuffle2x_untransform)(data);
 	partial_store((_mword*)dst, data, bytes);
 }
 #endif
@@ -125,6 +92,19 @@ GF_FINISH_PACKED_FUNCS(gf16_shuffle2x, _FNSUFFIX, sizeof(_mword), _FN(gf16_shuff
 GF_FINISH_PACKED_FUNCS_STUB(gf16_shuffle2x, _FNSUFFIX)
 #endif
 
+// natural layout variant: the kernel transforms data in-register, so packing is just a copy
+#ifdef _AVAILABLE
+# ifdef PLATFORM_AMD64
+GF_PREPARE_PACKED_FUNCS(gf16_shuffle2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_prepare_block), _FN(gf16_natural_prepare_blocku), 2 + (MWORD_SIZE==64)*4, _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare), sizeof(_mword))
+# else
+GF_PREPARE_PACKED_FUNCS(gf16_shuffle2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_prepare_block), _FN(gf16_natural_prepare_blocku), 1, _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare), sizeof(_mword))
+# endif
+GF_FINISH_PACKED_FUNCS(gf16_shuffle2x_natural, _FNSUFFIX, sizeof(_mword), _FN(gf16_natural_finish_copy_block), _FN(gf16_natural_finish_copy_blocku), 1, _MM_END, _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), NULL, sizeof(_mword))
+#else
+GF_PREPARE_PACKED_FUNCS_STUB(gf16_shuffle2x_natural, _FNSUFFIX)
+GF_FINISH_PACKED_FUNCS_STUB(gf16_shuffle2x_natural, _FNSUFFIX)
+#endif
+
 
 #ifdef _AVAILABLE
 void _FN(gf16_shuffle2x_setup_vec)(const void *HEDLEY_RESTRICT scratch, uint16_t val, _mword* shufNormLo, _mword* shufSwapLo, _mword* shufNormHi, _mword* shufSwapHi) {
@@ -17,8 +17,9 @@
 #include "gf16_muladd_multi.h"
 
 #if defined(_AVAILABLE)
-static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_round_avx2(__m256i* _dst, const int srcCount, __m256i* _src1, __m256i* _src2, __m256i shufNormLoA, __m256i shufNormLoB, __m256i shufNormHiA, __m256i shufNormHiB, __m256i shufSwapLoA, __m256i shufSwapLoB, __m256i shufSwapHiA, __m256i shufSwapHiB) {
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_round_avx2(__m256i* _dst, const int srcCount, __m256i* _src1, __m256i* _src2, __m256i shufNormLoA, __m256i shufNormLoB, __m256i shufNormHiA, __m256i shufNormHiB, __m256i shufSwapLoA, __m256i shufSwapLoB, __m256i shufSwapHiA, __m256i shufSwapHiB, const int natural) {
 	__m256i data = _mm256_load_si256(_src1);
+	if(natural) data = gf16_shuffle2x_transform_avx2(data);
 	__m256i mask = _mm256_set1_epi8(0x0f);
 	
 	__m256i ti = _mm256_and_si256(mask, data);
@@ -29,10 +30,12 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_round_avx2(__m256i* _dst,
 	swapped = _mm256_xor_si256(_mm256_shuffle_epi8(shufSwapHiA, ti), swapped);
 	result = _mm256_xor_si256(_mm256_shuffle_epi8(shufNormHiA, ti), result);
 	
-	result = _mm256_xor_si256(result, _mm256_load_si256(_dst));
+	if(!natural)
+		result = _mm256_xor_si256(result, _mm256_load_si256(_dst));
 	
 	if(srcCount > 1) {
 		data = _mm256_load_si256(_src2);
+		if(natural) data = gf16_shuffle2x_transform_avx2(data);
 		
 		ti = _mm256_and_si256(mask, data);
 		result = _mm256_xor_si256(_mm256_shuffle_epi8(shufNormLoB, ti), result);
@@ -45,11 +48,14 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_round_avx2(__m256i* _dst,
 	
 	swapped = _mm256_permute2x128_si256(swapped, swapped, 0x01);
 	result = _mm256_xor_si256(result, swapped);
+	if(natural)
+		result = _mm256_xor_si256(gf16_shuffle2x_untransform_avx2(result), _mm256_load_si256(_dst));
 	
 	_mm256_store_si256(_dst, result);
 }
 
-static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx2(const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf) {
+// if `natural` is set, the source/destination is in natural layout, and is transformed in-register
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_xn_avx2(const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf, const int natural) {
 	GF16_MULADD_MULTI_SRC_UNUSED(2);
 	
 	__m256i shufNormLoA, shufSwapLoA, shufNormHiA, shufSwapHiA;
@@ -118,7 +124,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx2(const void *HEDLEY
 		if(len & (sizeof(__m256i)*2-1)) { // number of loop iterations isn't even, so do one iteration to make it even
 			gf16_shuffle2x_muladd_round_avx2(
 				(__m256i*)(_dst+ptr), srcCount, (__m256i*)(_src1+ptr*srcScale), (__m256i*)(_src2+ptr*srcScale),
-				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB
+				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB, natural
 			);
 			if(doPrefetch == 1)
 				_mm_prefetch(_pf+ptr, MM_HINT_WT1);
@@ -129,12 +135,12 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx2(const void *HEDLEY
 		while(ptr) {
 			gf16_shuffle2x_muladd_round_avx2(
 				(__m256i*)(_dst+ptr), srcCount, (__m256i*)(_src1+ptr*srcScale), (__m256i*)(_src2+ptr*srcScale),
-				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB
+				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB, natural
 			);
 			ptr += sizeof(__m256i);
 			gf16_shuffle2x_muladd_round_avx2(
 				(__m256i*)(_dst+ptr), srcCount, (__m256i*)(_src1+ptr*srcScale), (__m256i*)(_src2+ptr*srcScale),
-				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB
+				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB, natural
 			);
 			
 			if(doPrefetch == 1)
@@ -147,11 +153,17 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx2(const void *HEDLEY
 		for(intptr_t ptr = -(intptr_t)len; ptr; ptr += sizeof(__m256i)) {
 			gf16_shuffle2x_muladd_round_avx2(
 				(__m256i*)(_dst+ptr), srcCount, (__m256i*)(_src1+ptr*srcScale), (__m256i*)(_src2+ptr*srcScale),
-				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB
+				shufNormLoA, shufNormLoB, shufNormHiA, shufNormHiB, shufSwapLoA, shufSwapLoB, shufSwapHiA, shufSwapHiB, natural
 			);
 		}
 	}
 }
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx2(const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf) {
+	gf16_shuffle2x_muladd_xn_avx2(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 0);
+}
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_natural_muladd_x_avx2(const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf) {
+	gf16_shuffle2x_muladd_xn_avx2(scratch, _dst, srcScale, GF16_MULADD_MULTI_SRCLIST_FORWARD, len, coefficients, doPrefetch, _pf, 1);
+}
 #endif
 
 
@@ -171,6 +183,22 @@ void gf16_shuffle2x_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLE
 #endif
 }
 
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+GF16_MULADD_MULTI_FUNCS(gf16_shuffle2x_natural, _avx2, gf16_shuffle2x_natural_muladd_x_avx2, 2, sizeof(__m256i), 0, _mm256_zeroupper())
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_shuffle2x_natural, _avx2)
+#endif
+
+void gf16_shuffle2x_natural_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	gf16_muladd_single(scratch, &gf16_shuffle2x_natural_muladd_x_avx2, dst, src, len, val);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(val);
+#endif
+}
+
 
 
 
@@ -0,0 +1,222 @@
+
+#include "gf16_global.h"
+#include "../src/platform.h"
+#include "gf16_muladd_multi.h"
+#include "gf16_checksum_generic.h"
+
+// portable variant of the shuffle method, written using GCC/Clang vector extensions; relies on the compiler to lower it to whatever SIMD the target has (RVV, VSX, WASM SIMD etc)
+// vectors are fixed at 16 bytes, as this matches the size of the 4-bit lookup tables
+#if defined(__GNUC__) && !defined(__INTEL_COMPILER)
+# define _AVAILABLE 1
+int gf16_shuffle_available_vec = 1;
+#else
+int gf16_shuffle_available_vec = 0;
+#endif
+
+#define VEC_SIZE 16
+#define VEC_NUM_REGIONS 2
+#define VEC_CACHELINE_SIZE 64
+
+#ifdef _AVAILABLE
+typedef uint8_t vec_u8 __attribute__((vector_size(VEC_SIZE)));
+
+static HEDLEY_ALWAYS_INLINE vec_u8 vec_load(const void* p) {
+	vec_u8 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+static HEDLEY_ALWAYS_INLINE void vec_store(void* p, vec_u8 v) {
+	memcpy(p, &v, sizeof(v));
+}
+// indices are always < 16
+static HEDLEY_ALWAYS_INLINE vec_u8 vec_lookup(vec_u8 tbl, vec_u8 idx) {
+# ifdef __clang__
+	// Clang doesn't have a variable shuffle for generic vectors, so rely on the vectorizer picking this up
+	vec_u8 r;
+	for(int i=0; i<VEC_SIZE; i++)
+		r[i] = tbl[idx[i]];
+	return r;
+# else
+	return __builtin_shuffle(tbl, idx);
+# endif
+}
+
+
+// data is arranged in 32 byte blocks, with the low bytes of 16 words in the first vector, and the high bytes in the second
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_prepare_block(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	const uint8_t* _src = (const uint8_t*)src;
+	uint8_t* _dst = (uint8_t*)dst;
+	for(int i=0; i<VEC_SIZE; i++) {
+		_dst[i] = _src[i*2];
+		_dst[VEC_SIZE + i] = _src[i*2 + 1];
+	}
+}
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_prepare_blocku(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
+	uint8_t tmp[VEC_SIZE*2];
+	memcpy(tmp, src, remaining);
+	memset(tmp + remaining, 0, sizeof(tmp) - remaining);
+	gf16_shuffle_vec_prepare_block(dst, tmp);
+}
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_finish_block(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	const uint8_t* _src = (const uint8_t*)src;
+	uint8_t* _dst = (uint8_t*)dst;
+	for(int i=0; i<VEC_SIZE; i++) {
+		_dst[i*2] = _src[i];
+		_dst[i*2 + 1] = _src[VEC_SIZE + i];
+	}
+}
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_finish_blocku(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
+	uint8_t tmp[VEC_SIZE*2];
+	gf16_shuffle_vec_finish_block(tmp, src);
+	memcpy(dst, tmp, remaining);
+}
+
+// checksums use the generic (native word) routines; the checksum is stored in natural layout before being transformed like any other block
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_checksum_prepare(void *HEDLEY_RESTRICT dst, void *HEDLEY_RESTRICT checksum, const size_t blockLen, gf16_transform_block prepareBlock) {
+	UNUSED(prepareBlock);
+	uint8_t tmp[VEC_SIZE*2];
+	memset(tmp, 0, blockLen);
+	if(sizeof(uintptr_t) >= 8)
+		write64(tmp, SWAP64(read64(checksum)));
+	else if(sizeof(uintptr_t) >= 4)
+		write32(tmp, SWAP32(read32(checksum)));
+	else
+		write16(tmp, SWAP16(read16(checksum)));
+	gf16_shuffle_vec_prepare_block(dst, tmp);
+}
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_checksum_finish(void *HEDLEY_RESTRICT checksum) {
+	uint8_t tmp[VEC_SIZE*2];
+	gf16_shuffle_vec_finish_block(tmp, checksum);
+	if(sizeof(uintptr_t) >= 8)
+		write64(tmp, SWAP64(read64(tmp)));
+	else if(sizeof(uintptr_t) >= 4)
+		write32(tmp, SWAP32(read32(tmp)));
+	else
+		write16(tmp, SWAP16(read16(tmp)));
+	memcpy(checksum, tmp, sizeof(tmp));
+}
+
+
+// table n holds the products of each 4-bit value, shifted left by n*4 bits; the low and high bytes of each product are held separately
+// this is cheap enough to do with scalar code, which avoids needing anything beyond basic vector operations
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_calc_tables(uint16_t val, vec_u8* tbl_l, vec_u8* tbl_h) {
+	uint8_t lo[4][16], hi[4][16];
+	for(int n=0; n<4; n++) {
+		uint16_t prod[16];
+		prod[0] = 0;
+		for(int j=1; j<16; j<<=1) {
+			for(int k=0; k<j; k++)
+				prod[j+k] = prod[k] ^ val;
+			val = GF16_MULTBY_TWO(val);
+		}
+		for(int i=0; i<16; i++) {
+			lo[n][i] = prod[i] & 0xff;
+			hi[n][i] = prod[i] >> 8;
+		}
+		tbl_l[n] = vec_load(lo[n]);
+		tbl_h[n] = vec_load(hi[n]);
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_vec_round(const void* src, vec_u8* rl, vec_u8* rh, const vec_u8* tbl_l, const vec_u8* tbl_h, int first) {
+	vec_u8 lo = vec_load(src);
+	vec_u8 hi = vec_load((const uint8_t*)src + VEC_SIZE);
+
+	vec_u8 ti = lo & 0xf;
+	vec_u8 l = vec_lookup(tbl_l[0], ti);
+	vec_u8 h = vec_lookup(tbl_h[0], ti);
+	ti = lo >> 4;
+	l ^= vec_lookup(tbl_l[1], ti);
+	h ^= vec_lookup(tbl_h[1], ti);
+	ti = hi & 0xf;
+	l ^= vec_lookup(tbl_l[2], ti);
+	h ^= vec_lookup(tbl_h[2], ti);
+	ti = hi >> 4;
+	l ^= vec_lookup(tbl_l[3], ti);
+	h ^= vec_lookup(tbl_h[3], ti);
+
+	if(first) {
+		*rl = l;
+		*rh = h;
+	} else {
+		*rl ^= l;
+		*rh ^= h;
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_vec(
+	const void *HEDLEY_RESTRICT scratch,
+	uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale, GF16_MULADD_MULTI_SRCLIST, size_t len,
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doPrefetch, const char* _pf
+) {
+	GF16_MULADD_MULTI_SRC_UNUSED(VEC_NUM_REGIONS);
+	UNUSED(scratch);
+
+	vec_u8 tbl_Al[4], tbl_Ah[4];
+	vec_u8 tbl_Bl[4], tbl_Bh[4];
+	gf16_shuffle_vec_calc_tables(coefficients[0], tbl_Al, tbl_Ah);
+	if(srcCount > 1)
+		gf16_shuffle_vec_calc_tables(coefficients[1], tbl_Bl, tbl_Bh);
+
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += VEC_SIZE*2) {
+		vec_u8 rl, rh;
+		gf16_shuffle_vec_round(_src1+ptr*srcScale, &rl, &rh, tbl_Al, tbl_Ah, 1);
+		if(srcCount > 1)
+			gf16_shuffle_vec_round(_src2+ptr*srcScale, &rl, &rh, tbl_Bl, tbl_Bh, 0);
+		vec_store(_dst+ptr, vec_load(_dst+ptr) ^ rl);
+		vec_store(_dst+ptr+VEC_SIZE, vec_load(_dst+ptr+VEC_SIZE) ^ rh);
+
+		if(doPrefetch && !(ptr & (VEC_CACHELINE_SIZE-1))) {
+			if(doPrefetch == 1)
+				__builtin_prefetch(_pf+ptr, 1, 2);
+			if(doPrefetch == 2)
+				__builtin_prefetch(_pf+ptr, 0, 1);
+		}
+	}
+}
+#endif /*defined(_AVAILABLE)*/
+
+
+void gf16_shuffle_mul_vec(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch); UNUSED(scratch);
+#ifdef _AVAILABLE
+	vec_u8 tbl_l[4], tbl_h[4];
+	gf16_shuffle_vec_calc_tables(val, tbl_l, tbl_h);
+
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += VEC_SIZE*2) {
+		vec_u8 rl, rh;
+		gf16_shuffle_vec_round(_src+ptr, &rl, &rh, tbl_l, tbl_h, 1);
+		vec_store(_dst+ptr, rl);
+		vec_store(_dst+ptr+VEC_SIZE, rh);
+	}
+#else
+	UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(val);
+#endif
+}
+
+void gf16_shuffle_muladd_vec(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	gf16_muladd_single(scratch, &gf16_shuffle_muladd_x_vec, dst, src, len, val);
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(val);
+#endif
+}
+
+
+#ifdef _AVAILABLE
+GF16_MULADD_MULTI_FUNCS(gf16_shuffle, _vec, gf16_shuffle_muladd_x_vec, VEC_NUM_REGIONS, VEC_SIZE*2, 0, (void)0)
+#else
+GF16_MULADD_MULTI_FUNCS_STUB(gf16_shuffle, _vec)
+#endif
+
+#ifdef _AVAILABLE
+GF_PREPARE_PACKED_FUNCS(gf16_shuffle, _vec, VEC_SIZE*2, gf16_shuffle_vec_prepare_block, gf16_shuffle_vec_prepare_blocku, VEC_NUM_REGIONS, (void)0, uintptr_t checksum = 0, gf16_checksum_block_generic, gf16_checksum_blocku_generic, gf16_checksum_exp_generic, gf16_shuffle_vec_checksum_prepare, sizeof(uintptr_t))
+GF_FINISH_PACKED_FUNCS(gf16_shuffle, _vec, VEC_SIZE*2, gf16_shuffle_vec_finish_block, gf16_shuffle_vec_finish_blocku, 1, (void)0, gf16_checksum_block_generic, gf16_checksum_blocku_generic, gf16_checksum_exp_generic, gf16_shuffle_vec_checksum_finish, sizeof(uintptr_t))
+#else
+GF_PREPARE_PACKED_FUNCS_STUB(gf16_shuffle, _vec)
+GF_FINISH_PACKED_FUNCS_STUB(gf16_shuffle, _vec)
+#endif
@@ -29,6 +29,18 @@ GF_PREPARE_PACKED_FUNCS(gf16_shuffle, _FNSUFFIX, sizeof(_mword)*2, _FN(gf16_shuf
 GF_PREPARE_PACKED_FUNCS_STUB(gf16_shuffle, _FNSUFFIX)
 #endif
 
+#if MWORD_SIZE==64
+# ifdef _AVAILABLE
+#  ifdef PLATFORM_AMD64
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS(gf16_shuffle, _FNSUFFIX, sizeof(_mword)*2, _FN(gf16_shuffle_prepare_block_nt), _FN(gf16_shuffle_prepare_blocku), 3, _mm_sfence(); _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare))
+#  else
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS(gf16_shuffle, _FNSUFFIX, sizeof(_mword)*2, _FN(gf16_shuffle_prepare_block_nt), _FN(gf16_shuffle_prepare_blocku), 1, _mm_sfence(); _MM_END, _mword checksum = _MMI(setzero)(), _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), _FN(gf16_checksum_prepare))
+#  endif
+# else
+GF_PREPARE_PACKED_CKSUM_NT_FUNCS_STUB(gf16_shuffle, _FNSUFFIX)
+# endif
+#endif
+
 
 void _FN(gf16_shuffle_finish)(void *HEDLEY_RESTRICT dst, size_t len) {
 #ifdef _AVAILABLE
@@ -45,6 +57,14 @@ GF_FINISH_PACKED_FUNCS(gf16_shuffle, _FNSUFFIX, sizeof(_mword)*2, _FN(gf16_shuff
 GF_FINISH_PACKED_FUNCS_STUB(gf16_shuffle, _FNSUFFIX)
 #endif
 
+#if MWORD_SIZE==64
+# ifdef _AVAILABLE
+GF_FINISH_PACKED_CKSUM_NT_FUNCS(gf16_shuffle, _FNSUFFIX, sizeof(_mword)*2, _FN(gf16_shuffle_finish_copy_block), _FN(gf16_shuffle_finish_copy_blocku), 1, _mm_sfence(); _MM_END, _FN(gf16_checksum_block), _FN(gf16_checksum_blocku), _FN(gf16_checksum_exp), &_FN(gf16_shuffle_finish_block), sizeof(_mword), _FN(gf16_shuffle_store_block_nt))
+# else
+GF_FINISH_PACKED_CKSUM_NT_FUNCS_STUB(gf16_shuffle, _FNSUFFIX)
+# endif
+#endif
+
 
 #if MWORD_SIZE >= 32
 # ifdef _AVAILABLE
@@ -16,6 +16,21 @@ static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_prepare_block)(void *HEDLEY_RE
 		_MM(unpacklo_epi64)(ta, tb)
 	);
 }
+// as above, but bypasses the cache, for when the destination is too large to remain cached until it's processed
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_prepare_block_nt)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	_mword ta = _MMI(loadu)((_mword*)src);
+	_mword tb = _MMI(loadu)((_mword*)src + 1);
+	
+	ta = separate_low_high(ta);
+	tb = separate_low_high(tb);
+	
+	_MMI(stream)((_mword*)dst,
+		_MM(unpackhi_epi64)(ta, tb)
+	);
+	_MMI(stream)((_mword*)dst + 1,
+		_MM(unpacklo_epi64)(ta, tb)
+	);
+}
 // final block
 static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_prepare_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t remaining) {
 	_mword ta, tb;
@@ -57,6 +72,12 @@ static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_finish_copy_block)(void *HEDLE
 	_MMI(storeu)((_mword*)dst + 1, _MM(unpackhi_epi8)(tb, ta));
 }
 
+// copies a finished block, bypassing the cache
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_store_block_nt)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src) {
+	_MMI(stream)((_mword*)dst, _MMI(load)((_mword*)src));
+	_MMI(stream)((_mword*)dst + 1, _MMI(load)((_mword*)src + 1));
+}
+
 static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_finish_copy_blocku)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t bytes) {
 	_mword ta = _MMI(load)((_mword*)src);
 	_mword tb = _MMI(load)((_mword*)src + 1);
@@ -23,10 +23,22 @@ FUNCS(avx512);
 
 #undef FUNCS
 
+// the AVX JIT uses the same data layout as SSE2, so shares its prepare/finish routines
+void* gf16_xor_jit_init_avx(int polynomial, int jitOptStrat);
+void* gf16_xor_jit_init_mut_avx();
+void gf16_xor_jit_mul_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch);
+void gf16_xor_jit_muladd_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch);
+void gf16_xor_jit_muladd_prefetch_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch, const void *HEDLEY_RESTRICT prefetch);
+extern int gf16_xor_available_avx;
+
 void gf16_xor_jit_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 void gf16_xor_jit_muladd_multi_packed_avx512(const void *HEDLEY_RESTRICT scratch, unsigned packRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 
 void gf16_xor_jit_uninit(void* scratch);
+// for the SSE2/AVX/AVX2 JIT, whose mutable scratch is a cache of generated code
+void gf16_xor_jit_cache_uninit(void* mutScratch);
+void gf16_xor_jit_cache_hint(void* mutScratch, unsigned distinctCoeffs, unsigned reuse);
+void gf16_xor_jit_cache_stats(const void* mutScratch, uint64_t* hits, uint64_t* misses);
 
 // non-JIT version
 void* gf16_xor_init_sse2(int polynomial);
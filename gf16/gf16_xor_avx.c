@@ -0,0 +1,84 @@
+
+#define _GF16_XORJIT_COPY_ALIGN 16
+#include "gf16_xor_common.h"
+#undef _GF16_XORJIT_COPY_ALIGN
+#include <string.h>
+
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+int gf16_xor_available_avx = 1;
+#else
+int gf16_xor_available_avx = 0;
+#endif
+
+/* same data layout as the SSE2 JIT (so its prepare/finish routines are used), but generated code uses VEX encoded instructions, avoiding register copies needed by two-operand SSE instructions */
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+# define MWORD_SIZE 16
+# define _FNSUFFIX _avx
+# define _MM_END
+# include "gf16_xor_vex_x86.h"
+# undef MWORD_SIZE
+# undef _FNSUFFIX
+# undef _MM_END
+#endif
+
+void gf16_xor_jit_mul_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+	if(coefficient == 0) {
+		memset(dst, 0, len);
+		return;
+	}
+	gf16_xor_jit_mul_base_avx(scratch, dst, src, len, coefficient, mutScratch, 0, 0, NULL);
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
+#endif
+}
+
+void gf16_xor_jit_muladd_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+	if(coefficient == 0) return;
+	gf16_xor_jit_mul_base_avx(scratch, dst, src, len, coefficient, mutScratch, 1, 0, NULL);
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
+#endif
+}
+
+void gf16_xor_jit_muladd_prefetch_avx(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch, const void *HEDLEY_RESTRICT prefetch) {
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+	if(coefficient == 0) return;
+	gf16_xor_jit_mul_base_avx(scratch, dst, src, len, coefficient, mutScratch, 1, _MM_HINT_T1, prefetch);
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch); UNUSED(prefetch);
+#endif
+}
+
+
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+# include "gf16_bitdep_init_avx2.h"
+#endif
+
+void* gf16_xor_jit_init_avx(int polynomial, int jitOptStrat) {
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+	struct gf16_xor_scratch* ret;
+	uint8_t tmpCode[XORDEP_JIT_CODE_SIZE];
+
+	ALIGN_ALLOC(ret, sizeof(struct gf16_xor_scratch), 32);
+	gf16_bitdep_init256(ret->deps, polynomial, 0);
+
+	gf16_xor_create_jit_lut_avx();
+
+	ret->jitOptStrat = jitOptStrat;
+	ret->codeStart = (uint_fast8_t)xor_write_init_jit_avx(tmpCode);
+	return ret;
+#else
+	UNUSED(polynomial); UNUSED(jitOptStrat);
+	return NULL;
+#endif
+}
+
+void* gf16_xor_jit_init_mut_avx() {
+#if defined(__AVX__) && defined(PLATFORM_AMD64)
+	return gf16_xorjit_cache_alloc(&xor_write_init_jit_avx);
+#else
+	return NULL;
+#endif
+}
@@ -4,6 +4,8 @@
 
 #include "x86_jit.h"
 #include "gf16_xor.h"
+#include <stdlib.h>
+#include <string.h>
 
 #define XORDEP_JIT_SIZE 4096
 #define XORDEP_JIT_CODE_SIZE 1280
@@ -115,6 +117,84 @@ struct gf16_xor_scratch {
 	uint_fast8_t codeStart;
 };
 
+/* cache of generated code (used as the mutable scratch for the SSE2/AVX/AVX2 JIT), so that code for a recently seen coefficient, such as the same input/output pair in the next chunk round, can be run again without being rewritten
+ * each slot holds a full copy of the code (including the init code), as the generated loop jumps back to the start of its block
+ * the cache only pays off if coefficients are re-used before being evicted, so it's disabled unless the caller hints that the working set fits; when disabled, code is written in place to a single block, as if there were no cache */
+#define GF16_XORJIT_CACHE_SLOTS 1024
+#define GF16_XORJIT_CACHE_SLOT_SIZE 2048 /* must fit codeStart + XORDEP_JIT_CODE_SIZE, plus overrun from 64-byte copies */
+#define GF16_XORJIT_CACHE_HASH_BITS 11
+#define GF16_XORJIT_CACHE_NONE 0xffff
+struct gf16_xorjit_cache_entry {
+	uint32_t key;
+	uint16_t hashNext; // next entry in the same hash bucket
+	uint16_t lruPrev, lruNext;
+};
+struct gf16_xorjit_cache {
+	jit_wx_pair* jit; // arena holding all slots; allocated on first use
+	jit_wx_pair* direct; // single block used when the cache is disabled
+	size_t (*writeInit)(uint8_t*);
+	int enabled;
+	unsigned used;
+	uint16_t lruHead, lruTail; // head is the most recently used
+	uint64_t hits, misses;
+	uint16_t buckets[1<<GF16_XORJIT_CACHE_HASH_BITS];
+	struct gf16_xorjit_cache_entry entries[GF16_XORJIT_CACHE_SLOTS];
+};
+
+static HEDLEY_ALWAYS_INLINE struct gf16_xorjit_cache* gf16_xorjit_cache_alloc(size_t (*writeInit)(uint8_t*)) {
+	struct gf16_xorjit_cache* cache = (struct gf16_xorjit_cache*)malloc(sizeof(struct gf16_xorjit_cache));
+	if(!cache) return NULL;
+	cache->direct = jit_alloc(XORDEP_JIT_SIZE);
+	if(!cache->direct) {
+		free(cache);
+		return NULL;
+	}
+	writeInit((uint8_t*)cache->direct->w);
+	cache->jit = NULL;
+	cache->writeInit = writeInit; // slots are initialised on first use, to avoid touching the whole arena upfront
+	cache->enabled = 0;
+	cache->used = 0;
+	cache->lruHead = cache->lruTail = GF16_XORJIT_CACHE_NONE;
+	cache->hits = cache->misses = 0;
+	memset(cache->buckets, 0xff, sizeof(cache->buckets));
+	return cache;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_xorjit_cache_free(struct gf16_xorjit_cache* cache) {
+	if(cache->jit) jit_free(cache->jit);
+	jit_free(cache->direct);
+	free(cache);
+}
+// enables the cache if `distinctCoeffs` (the number of distinct coefficient/variant combinations about to be used) fits, and each will be used more than once
+// cached entries are kept whilst disabled, as they remain valid
+static HEDLEY_ALWAYS_INLINE void gf16_xorjit_cache_hint(struct gf16_xorjit_cache* cache, unsigned distinctCoeffs, unsigned reuse) {
+	cache->enabled = reuse > 1 && distinctCoeffs <= GF16_XORJIT_CACHE_SLOTS;
+}
+
+static HEDLEY_ALWAYS_INLINE void gf16_xorjit_cache_lru_unlink(struct gf16_xorjit_cache* cache, uint16_t slot) {
+	struct gf16_xorjit_cache_entry* entry = cache->entries + slot;
+	if(entry->lruPrev == GF16_XORJIT_CACHE_NONE)
+		cache->lruHead = entry->lruNext;
+	else
+		cache->entries[entry->lruPrev].lruNext = entry->lruNext;
+	if(entry->lruNext == GF16_XORJIT_CACHE_NONE)
+		cache->lruTail = entry->lruPrev;
+	else
+		cache->entries[entry->lruNext].lruPrev = entry->lruPrev;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_xorjit_cache_lru_push(struct gf16_xorjit_cache* cache, uint16_t slot) {
+	struct gf16_xorjit_cache_entry* entry = cache->entries + slot;
+	entry->lruPrev = GF16_XORJIT_CACHE_NONE;
+	entry->lruNext = cache->lruHead;
+	if(cache->lruHead == GF16_XORJIT_CACHE_NONE)
+		cache->lruTail = slot;
+	else
+		cache->entries[cache->lruHead].lruPrev = slot;
+	cache->lruHead = slot;
+}
+static HEDLEY_ALWAYS_INLINE unsigned gf16_xorjit_cache_bucket(uint32_t key) {
+	return (uint32_t)(key * 0x9E3779B1U) >> (32 - GF16_XORJIT_CACHE_HASH_BITS);
+}
+
 
 #ifdef __SSE2__
 typedef void*(*gf16_xorjit_write_func)(const struct gf16_xor_scratch *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT jitptr, uint16_t val, const int xor, const int prefetch);
@@ -195,6 +275,57 @@ static HEDLEY_ALWAYS_INLINE void gf16_xorjit_write_jit(const void *HEDLEY_RESTRI
 	}
 	#endif
 }
+
+// returns the executable code for the coefficient, only generating it if not found in the cache
+static HEDLEY_ALWAYS_INLINE void* gf16_xorjit_cached_jit(const void *HEDLEY_RESTRICT scratch, uint16_t coefficient, struct gf16_xorjit_cache* cache, const int add, const int prefetch, gf16_xorjit_write_func writeFunc) {
+	if(cache->enabled && !cache->jit) {
+		cache->jit = jit_alloc(GF16_XORJIT_CACHE_SLOTS * GF16_XORJIT_CACHE_SLOT_SIZE);
+		if(!cache->jit) cache->enabled = 0; // can't allocate the arena, so fall back to writing in place
+	}
+	if(!cache->enabled) {
+		gf16_xorjit_write_jit(scratch, coefficient, cache->direct, add, prefetch, writeFunc);
+		return cache->direct->x;
+	}
+	
+	uint32_t key = coefficient | (add << 16) | (prefetch << 17);
+	unsigned bucket = gf16_xorjit_cache_bucket(key);
+	uint16_t slot = cache->buckets[bucket];
+	while(slot != GF16_XORJIT_CACHE_NONE && cache->entries[slot].key != key)
+		slot = cache->entries[slot].hashNext;
+	
+	if(slot != GF16_XORJIT_CACHE_NONE) {
+		cache->hits++;
+		if(slot != cache->lruHead) {
+			gf16_xorjit_cache_lru_unlink(cache, slot);
+			gf16_xorjit_cache_lru_push(cache, slot);
+		}
+	} else {
+		cache->misses++;
+		if(cache->used < GF16_XORJIT_CACHE_SLOTS) {
+			slot = (uint16_t)(cache->used++);
+			cache->writeInit((uint8_t*)cache->jit->w + slot*GF16_XORJIT_CACHE_SLOT_SIZE);
+		} else {
+			// evict least recently used
+			slot = cache->lruTail;
+			gf16_xorjit_cache_lru_unlink(cache, slot);
+			uint16_t* link = cache->buckets + gf16_xorjit_cache_bucket(cache->entries[slot].key);
+			while(*link != slot)
+				link = &(cache->entries[*link].hashNext);
+			*link = cache->entries[slot].hashNext;
+		}
+		cache->entries[slot].key = key;
+		cache->entries[slot].hashNext = cache->buckets[bucket];
+		cache->buckets[bucket] = slot;
+		gf16_xorjit_cache_lru_push(cache, slot);
+		
+		jit_wx_pair slotJit;
+		slotJit.w = (uint8_t*)cache->jit->w + slot*GF16_XORJIT_CACHE_SLOT_SIZE;
+		slotJit.x = (uint8_t*)cache->jit->x + slot*GF16_XORJIT_CACHE_SLOT_SIZE;
+		slotJit.len = GF16_XORJIT_CACHE_SLOT_SIZE;
+		gf16_xorjit_write_jit(scratch, coefficient, &slotJit, add, prefetch, writeFunc);
+	}
+	return (uint8_t*)cache->jit->x + slot*GF16_XORJIT_CACHE_SLOT_SIZE;
+}
 #endif
 
 #endif /* PLATFORM_X86 */
@@ -670,8 +670,7 @@ static inline void* xor_write_jit_sse(const struct gf16_xor_scratch *HEDLEY_REST
 }
 
 static HEDLEY_ALWAYS_INLINE void gf16_xor_jit_mul_sse2_base(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch, const int add, const int doPrefetch, const void *HEDLEY_RESTRICT prefetch) {
-	jit_wx_pair* jit = (jit_wx_pair*)mutScratch;
-	gf16_xorjit_write_jit(scratch, coefficient, jit, add, doPrefetch, &xor_write_jit_sse);
+	void* fn = gf16_xorjit_cached_jit(scratch, coefficient, (struct gf16_xorjit_cache*)mutScratch, add, doPrefetch, &xor_write_jit_sse);
 	
 	// exec
 	/* adding 128 to the destination pointer allows the register offset to be coded in 1 byte
@@ -681,7 +680,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_xor_jit_mul_sse2_base(const void *HEDLEY_R
 		(intptr_t)dst + len - 128,
 		(intptr_t)dst - 128,
 		(intptr_t)prefetch - 128,
-		jit->x
+		fn
 	);
 }
 #endif /* defined(__SSE2__) */
@@ -1205,10 +1204,7 @@ void* gf16_xor_jit_init_sse2(int polynomial, int jitOptStrat) {
 
 void* gf16_xor_jit_init_mut_sse2() {
 #ifdef PLATFORM_X86
-	jit_wx_pair *jitCode = jit_alloc(XORDEP_JIT_SIZE);
-	if(!jitCode) return NULL;
-	xor_write_init_jit(jitCode->w);
-	return jitCode;
+	return gf16_xorjit_cache_alloc(&xor_write_init_jit);
 #else
 	return NULL;
 #endif
@@ -1222,6 +1218,33 @@ void gf16_xor_jit_uninit(void* scratch) {
 #endif
 }
 
+void gf16_xor_jit_cache_uninit(void* mutScratch) {
+#ifdef PLATFORM_X86
+	gf16_xorjit_cache_free((struct gf16_xorjit_cache*)mutScratch);
+#else
+	UNUSED(mutScratch);
+#endif
+}
+
+void gf16_xor_jit_cache_hint(void* mutScratch, unsigned distinctCoeffs, unsigned reuse) {
+#ifdef PLATFORM_X86
+	gf16_xorjit_cache_hint((struct gf16_xorjit_cache*)mutScratch, distinctCoeffs, reuse);
+#else
+	UNUSED(mutScratch); UNUSED(distinctCoeffs); UNUSED(reuse);
+#endif
+}
+
+void gf16_xor_jit_cache_stats(const void* mutScratch, uint64_t* hits, uint64_t* misses) {
+#ifdef PLATFORM_X86
+	const struct gf16_xorjit_cache* cache = (const struct gf16_xorjit_cache*)mutScratch;
+	*hits = cache->hits;
+	*misses = cache->misses;
+#else
+	UNUSED(mutScratch);
+	*hits = *misses = 0;
+#endif
+}
+
 void* gf16_xor_init_sse2(int polynomial) {
 #ifdef __SSE2__
 	void* ret;
@@ -22,7 +22,7 @@ extern "C" {
 # endif
 # include "x86_jit.h"
 struct CpuCap {
-	bool hasSSE2, hasSSSE3, hasAVX, hasAVX2, hasAVX512VLBW, hasAVX512VBMI, hasGFNI;
+	bool hasSSE2, hasSSSE3, hasAVX, hasAVX2, hasAVX512VLBW, hasAVX512VBMI, hasGFNI, hasVPCLMUL;
 	size_t propPrefShuffleThresh;
 	bool propFastJit, propHT;
 	bool canMemWX, isEmulated;
@@ -35,6 +35,7 @@ struct CpuCap {
 	  hasAVX512VLBW(true),
 	  hasAVX512VBMI(true),
 	  hasGFNI(true),
+	  hasVPCLMUL(true),
 	  propPrefShuffleThresh(0),
 	  propFastJit(false),
 	  propHT(false),
@@ -109,7 +110,7 @@ struct CpuCap {
 			|| family == 0xaf // AMD Zen3/4 family
 		);
 		
-		hasAVX = false; hasAVX2 = false; hasAVX512VLBW = false; hasAVX512VBMI = false; hasGFNI = false;
+		hasAVX = false; hasAVX2 = false; hasAVX512VLBW = false; hasAVX512VBMI = false; hasGFNI = false; hasVPCLMUL = false;
 #if !defined(_MSC_VER) || _MSC_VER >= 1600
 		_cpuidX(cpuInfoX, 7, 0);
 		if((cpuInfo[2] & 0x1C000000) == 0x1C000000) { // has AVX + OSXSAVE + XSAVE
@@ -125,6 +126,7 @@ struct CpuCap {
 			}
 		}
 		hasGFNI = (cpuInfoX[2] & 0x100) == 0x100;
+		hasVPCLMUL = hasAVX && (cpuInfoX[2] & 0x400) == 0x400;
 #endif
 		
 		_cpuid(cpuInfo, 0);
@@ -218,10 +220,12 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 	Galois16MethodInfo _info;
 	_info.id = method;
 	_info.idealInputMultiple = 1;
+	_info.idealOutputMultiple = 0;
 	_info.prefetchDownscale = 0;
 	_info.alignment = 2;
 	_info.stride = 2;
 	_info.cksumSize = 0; // set to alignment by default
+	_info.nonTemporalThreshold = 0;
 	
 	switch(method) {
 		case GF16_SHUFFLE_AVX:
@@ -253,6 +257,7 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.stride = 128;
 		break;
 		case GF16_SHUFFLE2X_AVX512:
+		case GF16_SHUFFLE2X_AVX512_NATURAL:
 			#ifdef PLATFORM_AMD64
 			_info.idealInputMultiple = 6;
 			#endif
@@ -260,6 +265,7 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.stride = 64;
 		break;
 		case GF16_SHUFFLE2X_AVX2:
+		case GF16_SHUFFLE2X_AVX2_NATURAL:
 			#ifdef PLATFORM_AMD64
 			_info.idealInputMultiple = 2;
 			#endif
@@ -316,11 +322,31 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.idealInputMultiple = 8;
 		break;
 		
+		case GF16_CLMUL_AVX2:
+			_info.alignment = 32;
+			_info.stride = 64;
+			#ifdef PLATFORM_AMD64
+			_info.idealInputMultiple = 6;
+			#else
+			_info.idealInputMultiple = 2;
+			#endif
+		break;
+		case GF16_CLMUL_AVX512:
+			_info.alignment = 64;
+			_info.stride = 64;
+			#ifdef PLATFORM_AMD64
+			_info.idealInputMultiple = 6;
+			#else
+			_info.idealInputMultiple = 2;
+			#endif
+		break;
+		
 		case GF16_AFFINE_AVX512:
 			_info.alignment = 64;
 			_info.stride = 128;
 			#ifdef PLATFORM_AMD64
 			_info.idealInputMultiple = 6;
+			_info.idealOutputMultiple = 8;
 			_info.prefetchDownscale = 1;
 			#endif
 		break;
@@ -330,6 +356,7 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.stride = 64;
 			#ifdef PLATFORM_AMD64
 			_info.idealInputMultiple = 3;
+			_info.idealOutputMultiple = 4;
 			#endif
 		break;
 		
@@ -338,10 +365,12 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.stride = 32;
 			#ifdef PLATFORM_AMD64
 			_info.idealInputMultiple = 3;
+			_info.idealOutputMultiple = 4;
 			#endif
 		break;
 		
 		case GF16_AFFINE2X_AVX512:
+		case GF16_AFFINE2X_AVX512_NATURAL:
 			_info.alignment = 64;
 			_info.stride = 64;
 			#ifdef PLATFORM_AMD64
@@ -352,6 +381,7 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 		break;
 		
 		case GF16_AFFINE2X_AVX2:
+		case GF16_AFFINE2X_AVX2_NATURAL:
 			_info.alignment = 32;
 			_info.stride = 32;
 			#ifdef PLATFORM_AMD64
@@ -373,7 +403,7 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 		
 		case GF16_XOR_JIT_AVX512:
 		case GF16_XOR_JIT_AVX2:
-		//case GF16_XOR_JIT_AVX:
+		case GF16_XOR_JIT_AVX:
 		case GF16_XOR_JIT_SSE2:
 		case GF16_XOR_SSE2: {
 			_info.alignment = 16;
@@ -392,6 +422,18 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.stride = 16;
 		break;
 		
+		case GF16_SHUFFLE_VEC:
+			_info.alignment = 16;
+			_info.stride = 32;
+			_info.cksumSize = gf16_lookup_stride(); // uses generic checksumming
+			_info.idealInputMultiple = 2;
+		break;
+		
+		case GF16_LOOKUP_FAT:
+			_info.stride = gf16_lookup_stride();
+			_info.alignment = _info.stride; // assume platform doesn't like misalignment
+		break;
+		
 		case GF16_LOOKUP3:
 			_info.stride = gf16_lookup3_stride();
 			_info.alignment = _info.stride; // assume platform doesn't like misalignment
@@ -416,6 +458,10 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			_info.idealChunkSize = 64*1024;
 			// seems like weaker processors prefer 32K
 		break;
+		case GF16_XOR_JIT_AVX:
+			// generated code is smaller than SSE2's (no register copies), which seems to allow slightly larger blocks
+			_info.idealChunkSize = 96*1024;
+		break;
 		case GF16_XOR_JIT_AVX2:
 			// 64-96K generally seems ideal, but this method is most likely used on Zen, which seems to prefer 128-256K
 			_info.idealChunkSize = 128*1024;
@@ -431,9 +477,14 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 			// lookup is mostly run on weaker processors, so prefer smaller to avoid overloading cache
 			_info.idealChunkSize = 32*1024;
 		break;
+		case GF16_LOOKUP_FAT:
+			// larger blocks amortize the cost of building the 128KB table
+			_info.idealChunkSize = 128*1024;
+		break;
 		case GF16_SHUFFLE_SSSE3:
 		case GF16_SHUFFLE_AVX:
 		case GF16_SHUFFLE_NEON:
+		case GF16_SHUFFLE_VEC:
 		case GF16_SHUFFLE_128_SVE: // may need smaller chunks for larger vector size
 		case GF16_SHUFFLE_128_SVE2:
 			_info.idealChunkSize = 16*1024;
@@ -443,6 +494,8 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 		case GF16_SHUFFLE_VBMI:
 		case GF16_SHUFFLE2X_AVX2:
 		case GF16_SHUFFLE2X_AVX512:
+		case GF16_SHUFFLE2X_AVX2_NATURAL:
+		case GF16_SHUFFLE2X_AVX512_NATURAL:
 		case GF16_SHUFFLE2X_128_SVE2:
 		case GF16_SHUFFLE_512_SVE2:
 			// try to target L2
@@ -450,14 +503,18 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 		break;
 		case GF16_AFFINE_AVX2:
 		case GF16_AFFINE2X_AVX2:
+		case GF16_AFFINE2X_AVX2_NATURAL:
 			_info.idealChunkSize = 4*1024; // completely untested
 		break;
 		case GF16_AFFINE_AVX512:
 		case GF16_AFFINE2X_AVX512:
+		case GF16_AFFINE2X_AVX512_NATURAL:
 			_info.idealChunkSize = 4*1024;
 		break;
 		case GF16_CLMUL_NEON: // faster init than Shuffle, and usually faster
 		case GF16_CLMUL_SVE2: // may want smaller chunk size for wider vectors
+		case GF16_CLMUL_AVX2:
+		case GF16_CLMUL_AVX512:
 		case GF16_AFFINE_GFNI:
 		case GF16_AFFINE2X_GFNI:
 			_info.idealChunkSize = 8*1024;
@@ -465,6 +522,16 @@ Galois16MethodInfo Galois16Mul::info(Galois16Methods _method) {
 		default: // shouldn't reach here as all options are covered above
 			_info.idealChunkSize = 32*1024; // random generic size that's a rough average of everything
 	}
+	
+	// methods with non-temporal prepare/finish variants; only worth using once the buffer can't fit in the LLC
+	switch(method) {
+		case GF16_SHUFFLE_AVX512:
+		case GF16_SHUFFLE_VBMI:
+		case GF16_AFFINE_AVX512:
+			_info.nonTemporalThreshold = llcSize();
+		break;
+		default: break;
+	}
 	return _info;
 }
 
@@ -475,6 +542,9 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 		scratch = NULL;
 	}
 	
+	prepare_packed_cksum_nt = NULL;
+	finish_packed_cksum_nt = NULL;
+	
 	#define METHOD_REQUIRES(c) if(!(c)) { \
 		setupMethod(_method == GF16_AUTO ? GF16_LOOKUP : GF16_AUTO); \
 		return; \
@@ -566,10 +636,12 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 					prepare = &gf16_shuffle_prepare_avx512;
 					prepare_packed = &gf16_shuffle_prepare_packed_avx512;
 					prepare_packed_cksum = &gf16_shuffle_prepare_packed_cksum_avx512;
+					prepare_packed_cksum_nt = &gf16_shuffle_prepare_packed_cksum_nt_avx512;
 					prepare_partial_packsum = &gf16_shuffle_prepare_partial_packsum_avx512;
 					finish = &gf16_shuffle_finish_avx512;
 					finish_packed = &gf16_shuffle_finish_packed_avx512;
 					finish_packed_cksum = &gf16_shuffle_finish_packed_cksum_avx512;
+					finish_packed_cksum_nt = &gf16_shuffle_finish_packed_cksum_nt_avx512;
 					finish_partial_packsum = &gf16_shuffle_finish_partial_packsum_avx512;
 					copy_cksum = &gf16_cksum_copy_avx512;
 					copy_cksum_check = &gf16_cksum_copy_check_avx512;
@@ -597,10 +669,12 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			prepare = &gf16_shuffle_prepare_avx512;
 			prepare_packed = &gf16_shuffle_prepare_packed_vbmi;
 			prepare_packed_cksum = &gf16_shuffle_prepare_packed_cksum_vbmi;
+			prepare_packed_cksum_nt = &gf16_shuffle_prepare_packed_cksum_nt_vbmi;
 			prepare_partial_packsum = &gf16_shuffle_prepare_partial_packsum_vbmi;
 			finish = &gf16_shuffle_finish_avx512;
 			finish_packed = &gf16_shuffle_finish_packed_avx512;
 			finish_packed_cksum = &gf16_shuffle_finish_packed_cksum_avx512;
+			finish_packed_cksum_nt = &gf16_shuffle_finish_packed_cksum_nt_avx512;
 			finish_partial_packsum = &gf16_shuffle_finish_partial_packsum_avx512;
 			copy_cksum = &gf16_cksum_copy_avx512;
 			copy_cksum_check = &gf16_cksum_copy_check_avx512;
@@ -659,6 +733,55 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			copy_cksum = &gf16_cksum_copy_avx2;
 			copy_cksum_check = &gf16_cksum_copy_check_avx2;
 		break;
+		case GF16_SHUFFLE2X_AVX512_NATURAL:
+			scratch = gf16_shuffle_init_x86(GF16_POLYNOMIAL);
+			METHOD_REQUIRES(gf16_shuffle_available_avx512 && scratch)
+			_mul_add = &gf16_shuffle2x_natural_muladd_avx512;
+			add_multi = &gf_add_multi_avx512;
+			#ifdef PLATFORM_AMD64
+			_mul_add_multi = &gf16_shuffle2x_natural_muladd_multi_avx512;
+			_mul_add_multi_packed = &gf16_shuffle2x_natural_muladd_multi_packed_avx512;
+			_mul_add_multi_packpf = &gf16_shuffle2x_natural_muladd_multi_packpf_avx512;
+			add_multi_packed = &gf_add_multi_packed_v1i6_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i6_avx512;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v1i1_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i1_avx512;
+			#endif
+			// data is left in its natural layout, so only packing is needed, and no prepare/finish step
+			prepare_packed = &gf16_shuffle2x_natural_prepare_packed_avx512;
+			prepare_packed_cksum = &gf16_shuffle2x_natural_prepare_packed_cksum_avx512;
+			prepare_partial_packsum = &gf16_shuffle2x_natural_prepare_partial_packsum_avx512;
+			finish_packed = &gf16_shuffle2x_natural_finish_packed_avx512;
+			finish_packed_cksum = &gf16_shuffle2x_natural_finish_packed_cksum_avx512;
+			finish_partial_packsum = &gf16_shuffle2x_natural_finish_partial_packsum_avx512;
+			copy_cksum = &gf16_cksum_copy_avx512;
+			copy_cksum_check = &gf16_cksum_copy_check_avx512;
+		break;
+		case GF16_SHUFFLE2X_AVX2_NATURAL:
+			scratch = gf16_shuffle_init_x86(GF16_POLYNOMIAL);
+			METHOD_REQUIRES(gf16_shuffle_available_avx2 && scratch)
+			_mul_add = &gf16_shuffle2x_natural_muladd_avx2;
+			add_multi = &gf_add_multi_avx2;
+			#ifdef PLATFORM_AMD64
+			_mul_add_multi = &gf16_shuffle2x_natural_muladd_multi_avx2;
+			_mul_add_multi_packed = &gf16_shuffle2x_natural_muladd_multi_packed_avx2;
+			_mul_add_multi_packpf = &gf16_shuffle2x_natural_muladd_multi_packpf_avx2;
+			add_multi_packed = &gf_add_multi_packed_v1i2_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v1i2_avx2;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v1i1_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v1i1_avx2;
+			#endif
+			prepare_packed = &gf16_shuffle2x_natural_prepare_packed_avx2;
+			prepare_packed_cksum = &gf16_shuffle2x_natural_prepare_packed_cksum_avx2;
+			prepare_partial_packsum = &gf16_shuffle2x_natural_prepare_partial_packsum_avx2;
+			finish_packed = &gf16_shuffle2x_natural_finish_packed_avx2;
+			finish_packed_cksum = &gf16_shuffle2x_natural_finish_packed_cksum_avx2;
+			finish_partial_packsum = &gf16_shuffle2x_natural_finish_partial_packsum_avx2;
+			copy_cksum = &gf16_cksum_copy_avx2;
+			copy_cksum_check = &gf16_cksum_copy_check_avx2;
+		break;
 		
 		case GF16_SHUFFLE_NEON:
 			scratch = gf16_shuffle_init_arm(GF16_POLYNOMIAL);
@@ -815,6 +938,54 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			copy_cksum_check = &gf16_cksum_copy_check_sve;
 		break;
 		
+		case GF16_CLMUL_AVX512:
+			METHOD_REQUIRES(gf16_clmul_available_avx512)
+			_mul_add = &gf16_clmul_muladd_avx512;
+			_mul_add_multi = &gf16_clmul_muladd_multi_avx512;
+			_mul_add_multi_packed = &gf16_clmul_muladd_multi_packed_avx512;
+			_mul_add_multi_packpf = &gf16_clmul_muladd_multi_packpf_avx512;
+			add_multi = &gf_add_multi_avx512;
+			#ifdef PLATFORM_AMD64
+			add_multi_packed = &gf_add_multi_packed_v1i6_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i6_avx512;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v1i2_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i2_avx512;
+			#endif
+			prepare_packed = &gf16_clmul_prepare_packed_avx512;
+			prepare_packed_cksum = &gf16_clmul_prepare_packed_cksum_avx512;
+			prepare_partial_packsum = &gf16_clmul_prepare_partial_packsum_avx512;
+			finish_packed = &gf16_clmul_finish_packed_avx512;
+			finish_packed_cksum = &gf16_clmul_finish_packed_cksum_avx512;
+			finish_partial_packsum = &gf16_clmul_finish_partial_packsum_avx512;
+			copy_cksum = &gf16_cksum_copy_avx512;
+			copy_cksum_check = &gf16_cksum_copy_check_avx512;
+		break;
+		
+		case GF16_CLMUL_AVX2:
+			METHOD_REQUIRES(gf16_clmul_available_avx2)
+			_mul_add = &gf16_clmul_muladd_avx2;
+			_mul_add_multi = &gf16_clmul_muladd_multi_avx2;
+			_mul_add_multi_packed = &gf16_clmul_muladd_multi_packed_avx2;
+			_mul_add_multi_packpf = &gf16_clmul_muladd_multi_packpf_avx2;
+			add_multi = &gf_add_multi_avx2;
+			#ifdef PLATFORM_AMD64
+			add_multi_packed = &gf_add_multi_packed_v2i6_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v2i6_avx2;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v2i2_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v2i2_avx2;
+			#endif
+			prepare_packed = &gf16_clmul_prepare_packed_avx2;
+			prepare_packed_cksum = &gf16_clmul_prepare_packed_cksum_avx2;
+			prepare_partial_packsum = &gf16_clmul_prepare_partial_packsum_avx2;
+			finish_packed = &gf16_clmul_finish_packed_avx2;
+			finish_packed_cksum = &gf16_clmul_finish_packed_cksum_avx2;
+			finish_partial_packsum = &gf16_clmul_finish_partial_packsum_avx2;
+			copy_cksum = &gf16_cksum_copy_avx2;
+			copy_cksum_check = &gf16_cksum_copy_check_avx2;
+		break;
+		
 		case GF16_AFFINE_AVX512:
 			scratch = gf16_affine_init_avx512(GF16_POLYNOMIAL);
 			METHOD_REQUIRES(gf16_affine_available_avx512 && gf16_shuffle_available_avx512)
@@ -826,6 +997,7 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			_mul_add_multi = &gf16_affine_muladd_multi_avx512;
 			_mul_add_multi_packed = &gf16_affine_muladd_multi_packed_avx512;
 			_mul_add_multi_packpf = &gf16_affine_muladd_multi_packpf_avx512;
+			_mul_add_multiout_packed = &gf16_affine_muladd_multiout_packed_avx512;
 			add_multi_packed = &gf_add_multi_packed_v2i6_avx512;
 			add_multi_packpf = &gf_add_multi_packpf_v2i6_avx512;
 			#else
@@ -835,10 +1007,12 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			prepare = &gf16_shuffle_prepare_avx512;
 			prepare_packed = &gf16_affine_prepare_packed_avx512;
 			prepare_packed_cksum = &gf16_affine_prepare_packed_cksum_avx512;
+			prepare_packed_cksum_nt = &gf16_affine_prepare_packed_cksum_nt_avx512;
 			prepare_partial_packsum = &gf16_affine_prepare_partial_packsum_avx512;
 			finish = &gf16_shuffle_finish_avx512;
 			finish_packed = &gf16_shuffle_finish_packed_avx512;
 			finish_packed_cksum = &gf16_shuffle_finish_packed_cksum_avx512;
+			finish_packed_cksum_nt = &gf16_shuffle_finish_packed_cksum_nt_avx512;
 			finish_partial_packsum = &gf16_shuffle_finish_partial_packsum_avx512;
 			copy_cksum = &gf16_cksum_copy_avx512;
 			copy_cksum_check = &gf16_cksum_copy_check_avx512;
@@ -855,6 +1029,7 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			_mul_add_multi = &gf16_affine_muladd_multi_avx2;
 			_mul_add_multi_packed = &gf16_affine_muladd_multi_packed_avx2;
 			_mul_add_multi_packpf = &gf16_affine_muladd_multi_packpf_avx2;
+			_mul_add_multiout_packed = &gf16_affine_muladd_multiout_packed_avx2;
 			add_multi_packed = &gf_add_multi_packed_v2i3_avx2;
 			add_multi_packpf = &gf_add_multi_packpf_v2i3_avx2;
 			#else
@@ -884,6 +1059,7 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			_mul_add_multi = &gf16_affine_muladd_multi_gfni;
 			_mul_add_multi_packed = &gf16_affine_muladd_multi_packed_gfni;
 			_mul_add_multi_packpf = &gf16_affine_muladd_multi_packpf_gfni;
+			_mul_add_multiout_packed = &gf16_affine_muladd_multiout_packed_gfni;
 			add_multi_packed = &gf_add_multi_packed_v2i3_sse2;
 			add_multi_packpf = &gf_add_multi_packpf_v2i3_sse2;
 			#else
@@ -956,6 +1132,56 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			copy_cksum_check = &gf16_cksum_copy_check_avx2;
 		break;
 		
+		case GF16_AFFINE2X_AVX512_NATURAL:
+			scratch = gf16_affine_init_avx512(GF16_POLYNOMIAL);
+			METHOD_REQUIRES(gf16_affine_available_avx512 && gf16_shuffle_available_avx512)
+			_mul_add = &gf16_affine2x_natural_muladd_avx512;
+			_mul_add_multi = &gf16_affine2x_natural_muladd_multi_avx512;
+			_mul_add_multi_packed = &gf16_affine2x_natural_muladd_multi_packed_avx512;
+			_mul_add_multi_packpf = &gf16_affine2x_natural_muladd_multi_packpf_avx512;
+			add_multi = &gf_add_multi_avx512;
+			#ifdef PLATFORM_AMD64
+			add_multi_packed = &gf_add_multi_packed_v1i12_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i12_avx512;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v1i2_avx512;
+			add_multi_packpf = &gf_add_multi_packpf_v1i2_avx512;
+			#endif
+			prepare_packed = &gf16_affine2x_natural_prepare_packed_avx512;
+			prepare_packed_cksum = &gf16_affine2x_natural_prepare_packed_cksum_avx512;
+			prepare_partial_packsum = &gf16_affine2x_natural_prepare_partial_packsum_avx512;
+			finish_packed = &gf16_affine2x_natural_finish_packed_avx512;
+			finish_packed_cksum = &gf16_affine2x_natural_finish_packed_cksum_avx512;
+			finish_partial_packsum = &gf16_affine2x_natural_finish_partial_packsum_avx512;
+			copy_cksum = &gf16_cksum_copy_avx512;
+			copy_cksum_check = &gf16_cksum_copy_check_avx512;
+		break;
+		
+		case GF16_AFFINE2X_AVX2_NATURAL:
+			scratch = gf16_affine_init_avx2(GF16_POLYNOMIAL);
+			METHOD_REQUIRES(gf16_affine_available_avx2 && gf16_shuffle_available_avx2)
+			_mul_add = &gf16_affine2x_natural_muladd_avx2;
+			_mul_add_multi = &gf16_affine2x_natural_muladd_multi_avx2;
+			_mul_add_multi_packed = &gf16_affine2x_natural_muladd_multi_packed_avx2;
+			_mul_add_multi_packpf = &gf16_affine2x_natural_muladd_multi_packpf_avx2;
+			add_multi = &gf_add_multi_avx2;
+			#ifdef PLATFORM_AMD64
+			add_multi_packed = &gf_add_multi_packed_v1i6_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v1i6_avx2;
+			#else
+			add_multi_packed = &gf_add_multi_packed_v1i2_avx2;
+			add_multi_packpf = &gf_add_multi_packpf_v1i2_avx2;
+			#endif
+			prepare_packed = &gf16_affine2x_natural_prepare_packed_avx2;
+			prepare_packed_cksum = &gf16_affine2x_natural_prepare_packed_cksum_avx2;
+			prepare_partial_packsum = &gf16_affine2x_natural_prepare_partial_packsum_avx2;
+			finish_packed = &gf16_affine2x_natural_finish_packed_avx2;
+			finish_packed_cksum = &gf16_affine2x_natural_finish_packed_cksum_avx2;
+			finish_partial_packsum = &gf16_affine2x_natural_finish_partial_packsum_avx2;
+			copy_cksum = &gf16_cksum_copy_avx2;
+			copy_cksum_check = &gf16_cksum_copy_check_avx2;
+		break;
+		
 		case GF16_AFFINE2X_GFNI:
 			scratch = gf16_affine_init_gfni(GF16_POLYNOMIAL);
 			METHOD_REQUIRES(gf16_affine_available_gfni && gf16_shuffle_available_ssse3)
@@ -985,7 +1211,7 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 		
 		case GF16_XOR_JIT_AVX512:
 		case GF16_XOR_JIT_AVX2:
-		//case GF16_XOR_JIT_AVX:
+		case GF16_XOR_JIT_AVX:
 		case GF16_XOR_JIT_SSE2:
 		case GF16_XOR_SSE2: {
 #ifdef PLATFORM_X86
@@ -1019,28 +1245,27 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 					copy_cksum = &gf16_cksum_copy_sse2;
 					copy_cksum_check = &gf16_cksum_copy_check_sse2;
 				break;
-				/*
 				case GF16_XOR_JIT_AVX:
 					METHOD_REQUIRES(gf16_xor_available_avx)
-					scratch = gf16_xor_jit_init_sse2(GF16_POLYNOMIAL, jitOptStrat);
+					scratch = gf16_xor_jit_init_avx(GF16_POLYNOMIAL, jitOptStrat);
 					_mul = &gf16_xor_jit_mul_avx;
 					_mul_add = &gf16_xor_jit_muladd_avx;
 					_mul_add_pf = &gf16_xor_jit_muladd_prefetch_avx;
 					add_multi = &gf_add_multi_sse2;
 					add_multi_packed = &gf_add_multi_packed_v16i1_sse2;
 					add_multi_packpf = &gf_add_multi_packpf_v16i1_sse2;
-					prepare = &gf16_xor_prepare_avx;
-					prepare_packed = &gf16_xor_prepare_packed_avx;
-					prepare_packed_cksum = &gf16_xor_prepare_packed_cksum_avx;
-					prepare_partial_packsum = &gf16_xor_prepare_partial_packsum_avx;
-					finish = &gf16_xor_finish_avx;
-					finish_packed = &gf16_xor_finish_packed_avx;
-					finish_packed_cksum = &gf16_xor_finish_packed_cksum_avx;
-					finish_partial_packsum = &gf16_xor_finish_partial_packsum_avx;
+					// same data layout as the SSE2 JIT
+					prepare = &gf16_xor_prepare_sse2;
+					prepare_packed = &gf16_xor_prepare_packed_sse2;
+					prepare_packed_cksum = &gf16_xor_prepare_packed_cksum_sse2;
+					prepare_partial_packsum = &gf16_xor_prepare_partial_packsum_sse2;
+					finish = &gf16_xor_finish_sse2;
+					finish_packed = &gf16_xor_finish_packed_sse2;
+					finish_packed_cksum = &gf16_xor_finish_packed_cksum_sse2;
+					finish_partial_packsum = &gf16_xor_finish_partial_packsum_sse2;
 					copy_cksum = &gf16_cksum_copy_sse2;
 					copy_cksum_check = &gf16_cksum_copy_check_sse2;
 				break;
-				*/
 				case GF16_XOR_JIT_AVX2:
 					METHOD_REQUIRES(gf16_xor_available_avx2)
 					scratch = gf16_xor_jit_init_avx2(GF16_POLYNOMIAL, jitOptStrat);
@@ -1102,6 +1327,34 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 			copy_cksum_check = &gf16_cksum_copy_check_sse2;
 		break;
 		
+		case GF16_SHUFFLE_VEC:
+			METHOD_REQUIRES(gf16_shuffle_available_vec)
+			_mul = &gf16_shuffle_mul_vec;
+			_mul_add = &gf16_shuffle_muladd_vec;
+			_mul_add_multi = &gf16_shuffle_muladd_multi_vec;
+			_mul_add_multi_packed = &gf16_shuffle_muladd_multi_packed_vec;
+			_mul_add_multi_packpf = &gf16_shuffle_muladd_multi_packpf_vec;
+			prepare_packed = &gf16_shuffle_prepare_packed_vec;
+			prepare_packed_cksum = &gf16_shuffle_prepare_packed_cksum_vec;
+			prepare_partial_packsum = &gf16_shuffle_prepare_partial_packsum_vec;
+			finish_packed = &gf16_shuffle_finish_packed_vec;
+			finish_packed_cksum = &gf16_shuffle_finish_packed_cksum_vec;
+			finish_partial_packsum = &gf16_shuffle_finish_partial_packsum_vec;
+			add_multi_packed = &gf_add_multi_packed_shuffle_vec;
+			add_multi_packpf = &gf_add_multi_packpf_shuffle_vec;
+		break;
+		
+		case GF16_LOOKUP_FAT:
+			_mul = &gf16_lookup_fat_mul;
+			_mul_add = &gf16_lookup_fat_muladd;
+			_pow_add = &gf16_lookup_powadd;
+			prepare_packed_cksum = &gf16_lookup_prepare_packed_cksum_generic;
+			prepare_partial_packsum = &gf16_lookup_prepare_partial_packsum_generic;
+			finish_packed = &gf16_lookup_finish_packed_generic;
+			finish_packed_cksum = &gf16_lookup_finish_packed_cksum_generic;
+			finish_partial_packsum = &gf16_lookup_finish_partial_packsum_generic;
+		break;
+		
 		case GF16_LOOKUP3:
 			_mul = &gf16_lookup3_mul;
 			_mul_add = &gf16_lookup3_muladd;
@@ -1121,6 +1374,7 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 		default:
 			_mul = &gf16_lookup_mul;
 			_mul_add = &gf16_lookup_muladd;
+			_mul_add_multi_packed = &gf16_lookup_muladd_multi_packed;
 			_pow_add = &gf16_lookup_powadd;
 			prepare_packed_cksum = &gf16_lookup_prepare_packed_cksum_generic;
 			prepare_partial_packsum = &gf16_lookup_prepare_partial_packsum_generic;
@@ -1131,6 +1385,10 @@ void Galois16Mul::setupMethod(Galois16Methods _method) {
 	}
 	#undef METHOD_REQUIRES
 	
+	if(!prepare_packed_cksum_nt)
+		prepare_packed_cksum_nt = prepare_packed_cksum;
+	if(!finish_packed_cksum_nt)
+		finish_packed_cksum_nt = finish_packed_cksum;
 	_info = info(method);
 }
 
@@ -1149,6 +1407,7 @@ Galois16Mul::Galois16Mul(Galois16Methods method) {
 	_mul_add_multi = NULL;
 	_mul_add_multi_packed = NULL;
 	_mul_add_multi_packpf = NULL;
+	_mul_add_multiout_packed = NULL;
 	copy_cksum = &gf16_cksum_copy_generic;
 	copy_cksum_check = &gf16_cksum_copy_check_generic;
 	
@@ -1171,10 +1430,12 @@ void Galois16Mul::move(Galois16Mul& other) {
 	prepare = other.prepare;
 	prepare_packed = other.prepare_packed;
 	prepare_packed_cksum = other.prepare_packed_cksum;
+	prepare_packed_cksum_nt = other.prepare_packed_cksum_nt;
 	prepare_partial_packsum = other.prepare_partial_packsum;
 	finish = other.finish;
 	finish_packed = other.finish_packed;
 	finish_packed_cksum = other.finish_packed_cksum;
+	finish_packed_cksum_nt = other.finish_packed_cksum_nt;
 	finish_partial_packsum = other.finish_partial_packsum;
 	_info = other._info;
 	_mul = other._mul;
@@ -1186,6 +1447,7 @@ void Galois16Mul::move(Galois16Mul& other) {
 	_mul_add_multi = other._mul_add_multi;
 	_mul_add_multi_packed = other._mul_add_multi_packed;
 	_mul_add_multi_packpf = other._mul_add_multi_packpf;
+	_mul_add_multiout_packed = other._mul_add_multiout_packed;
 	_pow = other._pow;
 	_pow_add = other._pow_add;
 	copy_cksum = other.copy_cksum;
@@ -1198,10 +1460,14 @@ void* Galois16Mul::mutScratch_alloc() const {
 	switch(_info.id) {
 		case GF16_XOR_JIT_SSE2:
 			return gf16_xor_jit_init_mut_sse2();
+		case GF16_XOR_JIT_AVX:
+			return gf16_xor_jit_init_mut_avx();
 		case GF16_XOR_JIT_AVX2:
 			return gf16_xor_jit_init_mut_avx2();
 		case GF16_XOR_JIT_AVX512:
 			return gf16_xor_jit_init_mut_avx512();
+		case GF16_LOOKUP_FAT:
+			return gf16_lookup_fat_init_mut();
 		break;
 		default:
 			return NULL;
@@ -1210,13 +1476,40 @@ void* Galois16Mul::mutScratch_alloc() const {
 void Galois16Mul::mutScratch_free(void* mutScratch) const {
 	switch(_info.id) {
 		case GF16_XOR_JIT_SSE2:
+		case GF16_XOR_JIT_AVX:
 		case GF16_XOR_JIT_AVX2:
+			gf16_xor_jit_cache_uninit(mutScratch);
+		break;
 		case GF16_XOR_JIT_AVX512:
 			gf16_xor_jit_uninit(mutScratch);
 		break;
+		case GF16_LOOKUP_FAT:
+			gf16_lookup_fat_uninit_mut(mutScratch);
+		break;
+		default: break;
+	}
+}
+void Galois16Mul::mutScratch_hint_reuse(void* mutScratch, unsigned distinctCoeffs, unsigned reuse) const {
+	switch(_info.id) {
+		case GF16_XOR_JIT_SSE2:
+		case GF16_XOR_JIT_AVX2:
+			if(mutScratch) gf16_xor_jit_cache_hint(mutScratch, distinctCoeffs, reuse);
+		break;
 		default: break;
 	}
 }
+bool Galois16Mul::mutScratch_cache_stats(const void* mutScratch, uint64_t& hits, uint64_t& misses) const {
+	switch(_info.id) {
+		case GF16_XOR_JIT_SSE2:
+		case GF16_XOR_JIT_AVX:
+		case GF16_XOR_JIT_AVX2:
+			if(!mutScratch) return false;
+			gf16_xor_jit_cache_stats(mutScratch, &hits, &misses);
+			return true;
+		default:
+			return false;
+	}
+}
 
 Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*outputs*/) {
 	const CpuCap caps(true);
@@ -1229,6 +1522,8 @@ Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*ou
 		if(gf16_affine_available_avx2 && caps.hasAVX2)
 			return GF16_AFFINE_AVX2;
 	}
+	// natural layout variants aren't selected either: they only save a copy on the transfer thread, which was within noise for Affine2x, whilst the extra permutes slow down Shuffle2x
+	// CLMul (VPCLMULQDQ) is never selected by default: on tested CPUs, it's slower than Shuffle, as each 64-bit multiply only yields two 16-bit products
 	if(caps.hasAVX512VLBW) {
 		if(gf16_shuffle_available_vbmi && caps.hasAVX512VBMI)
 			return GF16_SHUFFLE_VBMI;
@@ -1247,8 +1542,9 @@ Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*ou
 		return GF16_AFFINE2X_GFNI; // this should beat XOR-JIT; even seems to generally beat Shuffle2x AVX2
 	if(!caps.isEmulated && (!regionSizeHint || regionSizeHint > caps.propPrefShuffleThresh)) {
 		// TODO: if only a few recovery slices being made (e.g. 3), prefer shuffle
-		//if(gf16_xor_available_avx && caps.hasAVX && caps.canMemWX)
-		//	return GF16_XOR_JIT_AVX;
+		// three-operand VEX avoids the register copies SSE2 needs (helps Sandy/Ivy Bridge)
+		if(gf16_xor_available_avx && caps.hasAVX && caps.canMemWX)
+			return GF16_XOR_JIT_AVX;
 		if(gf16_xor_available_sse2 && caps.hasSSE2 && caps.canMemWX)
 			return GF16_XOR_JIT_SSE2;
 	}
@@ -1270,13 +1566,17 @@ Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*ou
 	
 	
 	// lookup vs lookup3: latter seems to be slightly faster than former in most cases (SKX, Silvermont, Zen1, Rpi3 (arm64; arm32 faster muladd, slower mul)), sometimes slightly slower (Haswell, IvB?, Piledriver)
-	// but test w/ multi-region lh-lookup & fat table before preferring it
+	// with both using multi-region kernels, they're roughly even on x86, so stick with the simpler lh-lookup
+	// fat table is slower on x86 (table doesn't fit in L1), but may help on in-order cores with large L2 caches
 	return GF16_LOOKUP;
 }
 
 std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 	std::vector<Galois16Methods> ret;
 	ret.push_back(GF16_LOOKUP);
+	ret.push_back(GF16_LOOKUP_FAT);
+	if(gf16_shuffle_available_vec)
+		ret.push_back(GF16_SHUFFLE_VEC);
 	if(gf16_lookup3_stride())
 		ret.push_back(GF16_LOOKUP3);
 	
@@ -1289,10 +1589,12 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 	if(gf16_shuffle_available_avx2 && caps.hasAVX2) {
 		ret.push_back(GF16_SHUFFLE_AVX2);
 		ret.push_back(GF16_SHUFFLE2X_AVX2);
+		ret.push_back(GF16_SHUFFLE2X_AVX2_NATURAL);
 	}
 	if(gf16_shuffle_available_avx512 && caps.hasAVX512VLBW) {
 		ret.push_back(GF16_SHUFFLE_AVX512);
 		ret.push_back(GF16_SHUFFLE2X_AVX512);
+		ret.push_back(GF16_SHUFFLE2X_AVX512_NATURAL);
 	}
 	if(gf16_shuffle_available_vbmi && caps.hasAVX512VBMI) {
 		ret.push_back(GF16_SHUFFLE_VBMI);
@@ -1306,13 +1608,22 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 		if(gf16_affine_available_avx2 && gf16_shuffle_available_avx2 && caps.hasAVX2) {
 			ret.push_back(GF16_AFFINE_AVX2);
 			ret.push_back(GF16_AFFINE2X_AVX2);
+			ret.push_back(GF16_AFFINE2X_AVX2_NATURAL);
 		}
 		if(gf16_affine_available_avx512 && gf16_shuffle_available_avx512 && caps.hasAVX512VLBW) {
 			ret.push_back(GF16_AFFINE_AVX512);
 			ret.push_back(GF16_AFFINE2X_AVX512);
+			ret.push_back(GF16_AFFINE2X_AVX512_NATURAL);
 		}
 	}
 	
+	if(caps.hasVPCLMUL) {
+		if(gf16_clmul_available_avx2 && caps.hasAVX2)
+			ret.push_back(GF16_CLMUL_AVX2);
+		if(gf16_clmul_available_avx512 && caps.hasAVX512VLBW)
+			ret.push_back(GF16_CLMUL_AVX512);
+	}
+	
 	if(gf16_xor_available_sse2 && caps.hasSSE2) {
 		ret.push_back(GF16_XOR_SSE2);
 		ret.push_back(GF16_LOOKUP_SSE2);
@@ -1320,8 +1631,8 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 	if(caps.canMemWX) {
 		if(gf16_xor_available_sse2 && caps.hasSSE2)
 			ret.push_back(GF16_XOR_JIT_SSE2);
-		//if(gf16_xor_available_avx && caps.hasAVX)
-		//	ret.push_back(GF16_XOR_JIT_AVX);
+		if(gf16_xor_available_avx && caps.hasAVX)
+			ret.push_back(GF16_XOR_JIT_AVX);
 		if(gf16_xor_available_avx2 && caps.hasAVX2)
 			ret.push_back(GF16_XOR_JIT_AVX2);
 		if(gf16_xor_available_avx512 && caps.hasAVX512VLBW)
@@ -1348,6 +1659,46 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 	return ret;
 }
 
+static size_t detect_llc_size() {
+	size_t result = 0;
+#if defined(PLATFORM_X86) && (!defined(_MSC_VER) || _MSC_VER >= 1600)
+	int cpuInfo[4];
+	unsigned leaf = 0;
+	_cpuid(cpuInfo, 0);
+	if(cpuInfo[1] == 0x756E6547 && cpuInfo[2] == 0x6C65746E && cpuInfo[3] == 0x49656E69) { // GenuineIntel
+		if(cpuInfo[0] >= 4)
+			leaf = 4;
+	} else {
+		// AMD/Hygon provide the same information via an extended leaf, if topology extensions are supported
+		_cpuid(cpuInfo, 0x80000000);
+		if((unsigned)cpuInfo[0] >= 0x8000001D) {
+			_cpuid(cpuInfo, 0x80000001);
+			if(cpuInfo[2] & (1<<22))
+				leaf = 0x8000001D;
+		}
+	}
+	if(leaf) {
+		// enumerate deterministic cache parameters; the largest data/unified cache is assumed to be the LLC
+		for(int i=0; i<16; i++) {
+			_cpuidX(cpuInfo, leaf, i);
+			int type = cpuInfo[0] & 0x1f;
+			if(type == 0) break;
+			if(type == 2) continue; // instruction cache
+			size_t size = (size_t)(((cpuInfo[1] >> 22) & 0x3ff) + 1) // ways
+				* (((cpuInfo[1] >> 12) & 0x3ff) + 1) // partitions
+				* ((cpuInfo[1] & 0xfff) + 1) // line size
+				* ((size_t)(unsigned)cpuInfo[2] + 1); // sets
+			if(size > result) result = size;
+		}
+	}
+#endif
+	return result;
+}
+size_t Galois16Mul::llcSize() {
+	static const size_t size = detect_llc_size();
+	return size;
+}
+
 void Galois16Mul::_prepare_packed_none(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen, size_t sliceLen, unsigned inputPackSize, unsigned inputNum, size_t chunkLen) {
 	ASSUME(inputNum < inputPackSize);
 	ASSUME(srcLen <= sliceLen);
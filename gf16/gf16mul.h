@@ -21,6 +21,7 @@ typedef void(*Galois16PowFunc) (const void *HEDLEY_RESTRICT scratch, unsigned ou
 typedef void(*Galois16MulMultiFunc) (const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 typedef void(*Galois16MulPackedFunc) (const void *HEDLEY_RESTRICT scratch, unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 typedef void(*Galois16MulPackPfFunc) (const void *HEDLEY_RESTRICT scratch, unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch, const void* HEDLEY_RESTRICT prefetchIn, const void* HEDLEY_RESTRICT prefetchOut);
+typedef void(*Galois16MulMultiOutFunc) (const void *HEDLEY_RESTRICT scratch, unsigned packedRegions, unsigned regions, unsigned outputs, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 typedef void(*Galois16AddFunc) (void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len);
 typedef void(*Galois16AddMultiFunc) (unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len);
 typedef void(*Galois16AddPackedFunc) (unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len);
@@ -58,8 +59,16 @@ enum Galois16Methods {
 	GF16_AFFINE2X_AVX2,
 	GF16_AFFINE2X_AVX512,
 	GF16_CLMUL_NEON,
-	GF16_CLMUL_SVE2
-	// TODO: consider non-transforming shuffle/affine
+	GF16_CLMUL_SVE2,
+	GF16_CLMUL_AVX2,
+	GF16_CLMUL_AVX512,
+	GF16_SHUFFLE2X_AVX2_NATURAL,
+	GF16_SHUFFLE2X_AVX512_NATURAL,
+	GF16_AFFINE2X_AVX2_NATURAL,
+	GF16_AFFINE2X_AVX512_NATURAL,
+	GF16_XOR_JIT_AVX,
+	GF16_LOOKUP_FAT,
+	GF16_SHUFFLE_VEC
 };
 static const char* Galois16MethodsText[] = {
 	"Auto",
@@ -89,7 +98,16 @@ static const char* Galois16MethodsText[] = {
 	"Affine2x (GFNI+AVX2)",
 	"Affine2x (GFNI+AVX512)",
 	"CLMul (NEON)",
-	"CLMul (SVE2)"
+	"CLMul (SVE2)",
+	"CLMul (AVX2)",
+	"CLMul (AVX512)",
+	"Shuffle2x (AVX2, natural layout)",
+	"Shuffle2x (AVX512, natural layout)",
+	"Affine2x (GFNI+AVX2, natural layout)",
+	"Affine2x (GFNI+AVX512, natural layout)",
+	"Xor-Jit (AVX)",
+	"Lookup (fat table)",
+	"Shuffle (generic vector)"
 };
 
 typedef struct {
@@ -99,8 +117,10 @@ typedef struct {
 	size_t stride;
 	size_t idealChunkSize;
 	unsigned idealInputMultiple;
+	unsigned idealOutputMultiple; // number of outputs the output-blocked kernel accumulates at once; 0 if there's no such kernel
 	unsigned prefetchDownscale;
 	unsigned cksumSize;
+	size_t nonTemporalThreshold; // buffers larger than this should be prepared/finished with the _nt variants; 0 if the method has none
 } Galois16MethodInfo;
 
 class Galois16Mul {
@@ -116,6 +136,7 @@ private:
 	Galois16MulMultiFunc _mul_add_multi;
 	Galois16MulPackedFunc _mul_add_multi_packed;
 	Galois16MulPackPfFunc _mul_add_multi_packpf;
+	Galois16MulMultiOutFunc _mul_add_multiout_packed;
 	
 	static void _prepare_none(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen) {
 		memcpy(dst, src, srcLen);
@@ -123,6 +144,21 @@ private:
 	static void _finish_none(void *HEDLEY_RESTRICT, size_t) {}
 	static void _prepare_packed_none(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen, size_t sliceLen, unsigned inputPackSize, unsigned inputNum, size_t chunkLen);
 	
+	// multiplying by 1 is just an add, which is much cheaper than any multiply kernel
+	static inline bool _coeffs_all_one(unsigned regions, const uint16_t *HEDLEY_RESTRICT coefficients) {
+		for(unsigned region = 0; region<regions; region++)
+			if(coefficients[region] != 1) return false;
+		return true;
+	}
+	inline void _mul_add_region(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) const {
+		if(coefficient == 1) {
+			const void* srcList[] = {src};
+			add_multi(1, 0, dst, srcList, len);
+		}
+		else
+			_mul_add(scratch, dst, src, len, coefficient, mutScratch);
+	}
+	
 	
 	Galois16Methods _method;
 	void setupMethod(Galois16Methods method);
@@ -159,6 +195,9 @@ public:
 	inline bool hasMultiMulAddPacked() const {
 		return _mul_add_multi_packed != NULL;
 	};
+	inline bool hasMultiOutPacked() const {
+		return _mul_add_multiout_packed != NULL;
+	};
 	inline bool hasPowAdd() const {
 		return _pow_add != NULL;
 	};
@@ -172,6 +211,8 @@ public:
 		return _info;
 	}
 	static Galois16MethodInfo info(Galois16Methods _method);
+	// size of the last level cache in bytes, or 0 if unknown
+	static size_t llcSize();
 	
 	inline HEDLEY_CONST bool isMultipleOfStride(size_t len) const {
 #if defined(_M_ARM64) || defined(__aarch64__)
@@ -194,10 +235,12 @@ public:
 	Galois16MulTransform prepare;
 	Galois16MulTransformPacked prepare_packed;
 	Galois16MulTransformPacked prepare_packed_cksum;
+	Galois16MulTransformPacked prepare_packed_cksum_nt; // as above, but bypasses the cache; set to prepare_packed_cksum if the method has no such variant
 	Galois16MulTransformPackedPartial prepare_partial_packsum; // TODO: consider a nicer interface for this
 	Galois16MulUntransform finish;
 	Galois16MulUntransformPacked finish_packed;
 	Galois16MulUntransformPackedCksum finish_packed_cksum;
+	Galois16MulUntransformPackedCksum finish_packed_cksum_nt; // as above, but bypasses the cache; set to finish_packed_cksum if the method has no such variant
 	Galois16MulUntransformPackedCksumPartial finish_partial_packsum;
 	Galois16AddMultiFunc add_multi;
 	Galois16AddPackedFunc add_multi_packed;
@@ -207,6 +250,10 @@ public:
 	
 	HEDLEY_MALLOC void* mutScratch_alloc() const;
 	void mutScratch_free(void* mutScratch) const;
+	// for methods which cache generated code in the mutable scratch, indicates how many distinct coefficients the following calls will use, and how many times each is used; the cache is only used if it's expected to help
+	void mutScratch_hint_reuse(void* mutScratch, unsigned distinctCoeffs, unsigned reuse) const;
+	// for methods which cache generated code in the mutable scratch, returns the cache's hit/miss counts
+	bool mutScratch_cache_stats(const void* mutScratch, uint64_t& hits, uint64_t& misses) const;
 	
 	inline void mul(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) const {
 		assert(((uintptr_t)dst & (_info.alignment-1)) == 0);
@@ -290,11 +337,13 @@ public:
 		assert(len > 0);
 		assert(regions > 0);
 		
-		if(_mul_add_multi)
+		if(_coeffs_all_one(regions, coefficients))
+			add_multi(regions, offset, dst, src, len);
+		else if(_mul_add_multi)
 			_mul_add_multi(scratch, regions, offset, dst, src, len, coefficients, mutScratch);
 		else {
 			for(unsigned region = 0; region<regions; region++) {
-				_mul_add(scratch, (uint8_t*)dst+offset, ((const uint8_t*)src[region])+offset, len, coefficients[region], mutScratch);
+				_mul_add_region((uint8_t*)dst+offset, ((const uint8_t*)src[region])+offset, len, coefficients[region], mutScratch);
 			}
 		}
 	}
@@ -304,22 +353,43 @@ public:
 		assert(len > 0);
 		assert(regions > 0);
 		
-		if(_mul_add_multi_packed)
+		if(_coeffs_all_one(regions, coefficients))
+			add_multi_packed(packedRegions, regions, dst, src, len);
+		else if(_mul_add_multi_packed)
 			_mul_add_multi_packed(scratch, packedRegions, regions, dst, src, len, coefficients, mutScratch);
 		else {
 			for(unsigned region = 0; region<regions; region++) {
-				_mul_add(scratch, dst, (uint8_t*)src + region*len, len, coefficients[region], mutScratch);
+				_mul_add_region(dst, (uint8_t*)src + region*len, len, coefficients[region], mutScratch);
 			}
 		}
 	}
 	
-	inline void mul_add_multi_packpf(unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch, const void* HEDLEY_RESTRICT prefetchIn, const void* HEDLEY_RESTRICT prefetchOut) const {
+	// output-blocked counterpart to mul_add_multi_packed: computes `outputs` destinations, spaced `len` apart, with each destination's coefficients spaced `packedRegions` apart
+	inline void mul_add_multiout_packed(unsigned packedRegions, unsigned regions, unsigned outputs, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) const {
 		assert(isMultipleOfStride(len));
 		assert(len > 0);
 		assert(regions > 0);
+		assert(outputs > 0);
 		
-		// TODO: mul by 1?
+		if(_mul_add_multiout_packed)
+			_mul_add_multiout_packed(scratch, packedRegions, regions, outputs, dst, src, len, coefficients, mutScratch);
+		else {
+			for(unsigned out = 0; out<outputs; out++) {
+				mul_add_multi_packed(packedRegions, regions, (uint8_t*)dst + out*len, src, len, coefficients + out*packedRegions, mutScratch);
+			}
+		}
+	}
+	
+	inline void mul_add_multi_packpf(unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch, const void* HEDLEY_RESTRICT prefetchIn, const void* HEDLEY_RESTRICT prefetchOut) const {
+		assert(isMultipleOfStride(len));
+		assert(len > 0);
+		assert(regions > 0);
 		
+		// interleaved kernels process several regions per pass, so individual coefficients of 1 can't be skipped there; only divert if the whole row is 1
+		if(_coeffs_all_one(regions, coefficients)) {
+			add_multi_packpf(packedRegions, regions, dst, src, len, prefetchIn, prefetchOut);
+			return;
+		}
 		if(_mul_add_multi_packpf) {
 			_mul_add_multi_packpf(scratch, packedRegions, regions, dst, src, len, coefficients, mutScratch, prefetchIn, prefetchOut);
 			return;
@@ -348,7 +418,7 @@ public:
 			}
 		} else {
 			for(; region<regions; region++) {
-				_mul_add(scratch, dst, (uint8_t*)src + region*len, len, coefficients[region], mutScratch);
+				_mul_add_region(dst, (uint8_t*)src + region*len, len, coefficients[region], mutScratch);
 			}
 		}
 	}
@@ -53,7 +53,9 @@ PACKED_FUNC(1, 1, 6)
 PACKED_FUNC(1, 2, 8)
 PACKED_FUNC(1, 6, 18)
 PACKED_FUNC(2, 1, 6)
+PACKED_FUNC(2, 2, 8)
 PACKED_FUNC(2, 3, 12)
+PACKED_FUNC(2, 6, 18)
 PACKED_FUNC(16, 1, 6)
 
 #undef PACKED_FUNC
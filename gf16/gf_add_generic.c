@@ -93,3 +93,35 @@ void gf_add_multi_packpf_lookup3(unsigned packedRegions, unsigned regions, void
 	UNUSED(prefetchIn); UNUSED(prefetchOut);
 	gf16_muladd_multi_packed((void*)1, &gf_add_x_generic, 1, 4, packedRegions, regions, dst, src, len, gf16_lookup_stride(), NULL);
 }
+
+// for the generic vector shuffle method: 32 byte blocks, interleaved across two regions, so must be processed a block at a time
+static HEDLEY_ALWAYS_INLINE void gf_add_x_block32_generic(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const unsigned srcScale,
+	GF16_MULADD_MULTI_SRCLIST, size_t len,
+	const uint16_t *HEDLEY_RESTRICT coefficients,
+	const int doPrefetch, const char* _pf
+) {
+	GF16_MULADD_MULTI_SRC_UNUSED(4);
+	UNUSED(scratch); UNUSED(coefficients);
+	UNUSED(doPrefetch); UNUSED(_pf);
+	
+	for(intptr_t ptr = -(intptr_t)len; ptr; ptr += 32) {
+		for(unsigned i=0; i<32; i+=sizeof(uintptr_t)) {
+			uintptr_t data = readPtr(_src1+ptr*srcScale+i);
+			if(srcCount >= 2)
+				data ^= readPtr(_src2+ptr*srcScale+i);
+			if(srcCount >= 3)
+				data ^= readPtr(_src3+ptr*srcScale+i);
+			if(srcCount >= 4)
+				data ^= readPtr(_src4+ptr*srcScale+i);
+			writePtr(_dst+ptr+i, readPtr(_dst+ptr+i) ^ data);
+		}
+	}
+}
+void gf_add_multi_packed_shuffle_vec(unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len) {
+	gf16_muladd_multi_packed(NULL, &gf_add_x_block32_generic, 2, 4, packedRegions, regions, dst, src, len, 32, NULL);
+}
+void gf_add_multi_packpf_shuffle_vec(unsigned packedRegions, unsigned regions, void *HEDLEY_RESTRICT dst, const void* HEDLEY_RESTRICT src, size_t len, const void* HEDLEY_RESTRICT prefetchIn, const void* HEDLEY_RESTRICT prefetchOut) {
+	UNUSED(prefetchIn); UNUSED(prefetchOut);
+	gf16_muladd_multi_packed(NULL, &gf_add_x_block32_generic, 2, 4, packedRegions, regions, dst, src, len, 32, NULL);
+}
@@ -34,6 +34,7 @@
 # define condvar_signal(c) c->notify_one()
 #endif
 #include <queue>
+#include <vector>
 
 template<typename T>
 class ThreadMessageQueue {
@@ -175,6 +176,10 @@ public:
 		q.push(item);
 		uv_async_send(&a);
 	}
+	// takes back a notification which hasn't been delivered yet, for cleaning up once senders have stopped
+	bool trypop(void** item) {
+		return q.trypop(item);
+	}
 	
 	void close(void* data, void(*closeCb)(void*)) {
 		auto* d = new tnqCloseWrap;
@@ -299,6 +304,26 @@ class MessageThread {
 			#endif
 		}
 		
+		if(!self->affinity.empty()) {
+			// failures are ignored; an invalid CPU set just leaves the thread unrestricted
+			#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+			// only the current processor group can be targeted
+			DWORD_PTR mask = 0;
+			for(int cpu : self->affinity)
+				if(cpu >= 0 && cpu < (int)sizeof(DWORD_PTR)*8)
+					mask |= (DWORD_PTR)1 << cpu;
+			if(mask) SetThreadAffinityMask(GetCurrentThread(), mask);
+			#elif defined(__linux) || defined(__linux__)
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			for(int cpu : self->affinity)
+				if(cpu >= 0 && cpu < CPU_SETSIZE)
+					CPU_SET(cpu, &cpus);
+			pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+			#endif
+			// MacOS only supports affinity hints, so there's nothing to do there
+		}
+		
 		self->cb(self->q);
 	}
 	
@@ -318,6 +343,7 @@ class MessageThread {
 		cb = other.cb;
 		name = other.name;
 		lowPrio = other.lowPrio;
+		affinity = std::move(other.affinity);
 		
 		other.threadActive = false;
 		other.threadCreated = false;
@@ -326,6 +352,7 @@ class MessageThread {
 public:
 	bool lowPrio;
 	const char* name;
+	std::vector<int> affinity; // logical CPUs to restrict the thread to; empty means unrestricted; only applied when the thread is started
 	MessageThread() {
 		cb = NULL;
 		threadActive = false;
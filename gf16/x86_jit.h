@@ -384,6 +384,28 @@ static HEDLEY_ALWAYS_INLINE size_t _jit_vmovdqa_store(uint8_t* jit, uint_fast8_t
 	return p;
 }
 
+/** AVX (128-bit) VEX coded instructions; encoded as the 256-bit variant, with VEX.L cleared **/
+static HEDLEY_ALWAYS_INLINE size_t _jit_vex128(uint8_t* jit, size_t len) {
+	/* L is bit 2 of the last VEX byte: byte 1 for the 2-byte (C5) form, byte 2 for the 3-byte (C4) form */
+	jit[1 + (jit[0] == 0xC4)] &= ~4;
+	return len;
+}
+static HEDLEY_ALWAYS_INLINE size_t _jit_vpxor128_m(uint8_t* jit, uint_fast8_t xregD, uint_fast8_t xreg1, uint_fast8_t mreg, int32_t offs) {
+	return _jit_vex128(jit, _jit_vpxor_m(jit, xregD, xreg1, mreg, offs));
+}
+static HEDLEY_ALWAYS_INLINE size_t _jit_vpxor128_r(uint8_t* jit, uint_fast8_t xregD, uint_fast8_t xreg1, uint_fast8_t xreg2) {
+	return _jit_vex128(jit, _jit_vpxor_r(jit, xregD, xreg1, xreg2));
+}
+static HEDLEY_ALWAYS_INLINE size_t _jit_vmovdqa128(uint8_t* jit, uint_fast8_t xreg, uint_fast8_t xreg2) {
+	return _jit_vex128(jit, _jit_vmovdqa(jit, xreg, xreg2));
+}
+static HEDLEY_ALWAYS_INLINE size_t _jit_vmovdqa128_load(uint8_t* jit, uint_fast8_t xreg, uint_fast8_t mreg, int32_t offs) {
+	return _jit_vex128(jit, _jit_vmovdqa_load(jit, xreg, mreg, offs));
+}
+static HEDLEY_ALWAYS_INLINE size_t _jit_vmovdqa128_store(uint8_t* jit, uint_fast8_t mreg, int32_t offs, uint_fast8_t xreg) {
+	return _jit_vex128(jit, _jit_vmovdqa_store(jit, mreg, offs, xreg));
+}
+
 /** AVX3 (512-bit) EVEX coded instructions **/
 static HEDLEY_ALWAYS_INLINE size_t _jit_vpxord_m(uint8_t* jit, uint_fast8_t zregD, uint_fast8_t zreg1, uint_fast8_t mreg, int32_t offs) {
 	unsigned offsFlag = (offs != 0 || mreg == 13) << (int)(((offs+128*64) & ~0x3FC0) != 0);
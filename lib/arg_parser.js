@@ -175,7 +175,7 @@ module.exports = function(argv, opts) {
 	
 	for(var i=0; i<argv.length; i++) {
 		var arg = argv[i];
-		if(arg[0] === '-') {
+		if(arg[0] === '-' && arg.length > 1) { // a lone '-' is a value (typically meaning stdin)
 			if(arg[1] === '-') {
 				// long opt
 				if(arg.length === 2) {
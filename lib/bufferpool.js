@@ -3,7 +3,8 @@
 // a stack of buffers (prefer stack over queue to re-use memory, and if lucky, we won't use all the buffers)
 var allocBuffer = (Buffer.allocUnsafe || Buffer);
 
-function BufferPool(bufs, length, maxBufs) {
+function BufferPool(bufs, length, maxBufs, allocFn) {
+	this.allocBuffer = allocFn || allocBuffer;
 	this.length = length;
 	this.maxBufs = maxBufs;
 	this.pool = bufs;
@@ -13,6 +14,7 @@ function BufferPool(bufs, length, maxBufs) {
 
 BufferPool.prototype = {
 	endCb: null,
+	allocBuffer: null,
 	get: function(cb) {
 		while(this.pool.length) {
 			var buf = this.pool.pop();
@@ -24,7 +26,7 @@ BufferPool.prototype = {
 		if(this.poolSize < this.maxBufs) {
 			// allocate new buffer, since we're below the limit
 			this.poolSize++;
-			return cb(allocBuffer(this.length));
+			return cb(this.allocBuffer(this.length));
 		}
 		this.waitQueue.push(cb); // no available buffers
 	},
@@ -3,13 +3,15 @@
 var fs = require('fs');
 var async = require('async');
 var ProcQueue = require('./procqueue');
+var nodeReader = require('./fileseqreader').nodeReader;
 
-function FileChunkReader(files, sliceSize, chunkSize, chunkOffset, bufPool, concurrency, cbChunk, cb) {
+function FileChunkReader(files, sliceSize, chunkSize, chunkOffset, bufPool, concurrency, reader, cbChunk, cb) {
+	reader = reader || nodeReader;
 	var readQ = new ProcQueue(concurrency);
 	var readErr = null;
 	async.eachSeries(files, function(file, cb) {
 		if(file.size == 0) return cb();
-		fs.open(file.name, 'r', function(err, fd) {
+		reader.open(file.name, function(err, fd) {
 			if(err) return cb(err);
 			
 			var chunksLeft = file.numSlices;
@@ -29,9 +31,9 @@ function FileChunkReader(files, sliceSize, chunkSize, chunkOffset, bufPool, conc
 				bufPool.get(function(buffer) {
 					readQ.run(function(readDone) {
 						if(readErr) return cb(readErr);
-						fs.read(fd, buffer, 0, chunkSize, filePos, function(err, bytesRead) {
+						reader.read(fd, buffer, 0, chunkSize, filePos, function(err, bytesRead, view) {
 							if(err) readErr = err;
-							else cbChunk(file, buffer.slice(0, bytesRead), sliceNum, bufPool.put.bind(bufPool, buffer));
+							else cbChunk(file, (view || buffer).slice(0, bytesRead), sliceNum, bufPool.put.bind(bufPool, buffer));
 							
 							if(--chunksLeft == 0) {
 								// all chunks read from this file, so close it
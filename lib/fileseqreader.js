@@ -2,11 +2,17 @@
 
 var fs = require('fs');
 var allocBuffer = (Buffer.allocUnsafe || Buffer);
+var nodeReader = {
+	open: function(name, cb) {
+		fs.open(name, 'r', cb);
+	},
+	read: fs.read
+};
 
-function FileReaderData(file, buffer, len, pos, parent) {
+function FileReaderData(file, buffer, len, pos, parent, view) {
 	this._readerFile = file;
 	this.file = file.info;
-	this.buffer = buffer.slice(0, len);
+	this.buffer = (view || buffer).slice(0, len);
 	this._readerBuffer = buffer;
 	this.pos = pos;
 	this._parent = parent;
@@ -25,7 +31,9 @@ FileReaderData.prototype = {
 	}
 };
 
-function FileSeqReader(files, readSize, readBuffers) {
+function FileSeqReader(files, readSize, readBuffers, reader, allocFn) {
+	this.reader = reader || nodeReader;
+	this.allocBuffer = allocFn || allocBuffer;
 	this.fileQueue = files.filter(function(file) {
 		return file.size > 0;
 	});
@@ -45,6 +53,8 @@ FileSeqReader.prototype = {
 	fileQueue: null,
 	cb: null,
 	finishCb: null,
+	reader: null,
+	allocBuffer: null,
 	_isReading: false,
 	
 	// when doing sequential read with chunker, caller requires the first chunkLen bytes of every slice, so ensure that this always arrives as one piece
@@ -80,7 +90,7 @@ FileSeqReader.prototype = {
 		if(this.bufCount < this.maxBufs) {
 			// allocate new buffer, since we're below the limit
 			this.bufCount++;
-			return allocBuffer(this.readSize);
+			return this.allocBuffer(this.readSize);
 		}
 		return null; // no available buffers
 	},
@@ -110,7 +120,7 @@ FileSeqReader.prototype = {
 	_doRead: function(file, buffer) {
 		var self = this;
 		var readSize = this._readSize(file.pos, file.info.size);
-		fs.read(file.fd, buffer, 0, readSize[0], null, function(err, bytesRead) {
+		this.reader.read(file.fd, buffer, 0, readSize[0], file.pos, function(err, bytesRead, view) {
 			if(err) return self.cb(err);
 			
 			// file position/EOF tracking
@@ -123,7 +133,8 @@ FileSeqReader.prototype = {
 				return self.cb(new Error("Read failure - expected " + readSize[0] + " bytes, got " + bytesRead + " bytes instead."));
 			
 			// increase hashing count and wait for other end to signal when done
-			var ret = new FileReaderData(file, buffer, bytesRead, file.pos, self);
+			// some readers (e.g. memory mapped) supply their own view of the data instead of filling the buffer
+			var ret = new FileReaderData(file, buffer, bytesRead, file.pos, self, view);
 			if(readSize[1])
 				ret.chunks = readSize[1];
 			file.hashQueue++;
@@ -183,7 +194,7 @@ FileSeqReader.prototype = {
 		if(this.fileQueue.length) {
 			var self = this;
 			var file = this.fileQueue.shift();
-			fs.open(file.name, 'r', function(err, fd) {
+			this.reader.open(file.name, function(err, fd) {
 				if(err) return self.cb(err);
 				
 				// create new file entry; we put this at the end of the queue because if a hash completes during the open, we want to prioritize existing files
@@ -229,4 +240,5 @@ FileSeqReader.prototype = {
 	}
 };
 
+FileSeqReader.nodeReader = nodeReader;
 module.exports = FileSeqReader;
@@ -111,9 +111,15 @@ var GFWrapper = {
 		if(!this.gf) return null;
 		return this.gf.info();
 	},
+	// devices keep every traced command until it's retrieved, so this is done after each pass, rather than only at the end
+	_drainOclTrace: function() {
+		if(this._gfOpts.ocl_trace)
+			this._gfOpts.ocl_trace(this.gf.oclTrace());
+	},
 	close: function(cb) {
 		binding.hasher_clear();
 		if(this.gf) {
+			this._drainOclTrace();
 			this.gf.close(cb);
 			this.gf = null;
 			this.addQueue = null;
@@ -121,6 +127,18 @@ var GFWrapper = {
 			cb();
 	},
 	
+	// takes over another instance's processor, along with everything already added to it
+	// all adds must have completed; the other instance's progress handler stays attached, so its (empty) queue is kept
+	takeProcessor: function(other) {
+		if(other.addQueue && other.addQueue.length) throw new Error('Cannot take over processor with pending adds');
+		this.gf = other.gf;
+		this._allocSize = other._allocSize;
+		this.recoverySlices = other.recoverySlices;
+		this.addQueue = null;
+		other.gf = null;
+		other.recoverySlices = [];
+	},
+	
 	// TODO: add way to partially submit blocks (helps with handling very large slice sizes)
 	bufferedProcess: function(dataSlice, sliceNum, len, cb) {
 		if(!len || !dataSlice.length) return process.nextTick(cb);
@@ -187,6 +205,7 @@ var GFWrapper = {
 		
 		var self = this;
 		this.gf.end(function() {
+			self._drainOclTrace();
 			self._pullRecData();
 			cb();
 		});
@@ -408,6 +427,7 @@ function PAR2(files, sliceSize, opts) {
 	this.sliceSize = sliceSize;
 	this._allocSize = sliceSize;
 	this.chunkSize = sliceSize; // compatibility with PAR2Chunked
+	this._gfOpts = (opts = opts || {}); // files read hash_cpus from this
 	
 	var self = this;
 	
@@ -446,8 +466,13 @@ function PAR2(files, sliceSize, opts) {
 	
 	// -- other init
 	this.recoverySlices = [];
-	this._gfOpts = (opts = opts || {});
-	if(opts.proc_cpu && opts.proc_cpu.method)
+	if(Array.isArray(opts.proc_cpu)) {
+		// multiple CPU backends, each possibly pinned to a different set of cores
+		opts.proc_cpu.forEach(function(spec) {
+			if(spec.method)
+				spec.method = getMethodNum(GF_METHODS, spec.method);
+		});
+	} else if(opts.proc_cpu && opts.proc_cpu.method)
 		opts.proc_cpu.method = getMethodNum(GF_METHODS, opts.proc_cpu.method);
 	if(opts.proc_ocl) {
 		opts.proc_ocl.forEach(function(spec) {
@@ -679,7 +704,7 @@ function PAR2File(par2, file) {
 	if(file.size == 0) {
 		this.md5 = toBuffer('d41d8cd98f00b204e9800998ecf8427e', 'hex');
 	} else {
-		this._md5ctx = new binding.HasherInput(par2.sliceSize, this.pktCheck.slice(64 + 16));
+		this._md5ctx = new binding.HasherInput(par2.sliceSize, this.pktCheck.slice(64 + 16), par2._gfOpts.hash_cpus);
 	}
 }
 
@@ -888,12 +913,21 @@ var GF_METHODS = [
 	'xor-sse', 'xorjit-sse', 'xorjit-avx2', 'xorjit-avx512',
 	'affine-sse', 'affine-avx2', 'affine-avx512',
 	'affine2x-sse', 'affine2x-avx2', 'affine2x-avx512',
-	'clmul-neon', 'clmul-sve2'
+	'clmul-neon', 'clmul-sve2',
+	'clmul-avx2', 'clmul-avx512',
+	'shuffle2x-avx2-natural', 'shuffle2x-avx512-natural', 'affine2x-avx2-natural', 'affine2x-avx512-natural',
+	'xorjit-avx', 'lookup-fat', 'shuffle-vec'
 ];
 var GFOCL_METHODS = [
 	'' /*default*/, 'lookup', 'lookup_half', 'lookup_nc', 'lookup_half_nc',
 	'shuffle', 'log', 'log_small', 'log_small2', 'log_tiny', 'log_small_lm', 'log_tiny_lm',
-	'by2'
+	'lookup_wide', 'lookup_half_wide', 'lookup_async', 'lookup_half_async', 'log_wide', 'log_async', 'by2'
+];
+var READ_METHODS = [
+	'auto', 'pread', 'io_uring', 'mmap'
+];
+var WRITE_METHODS = [
+	'auto', 'pwrite', 'io_uring'
 ];
 var INHASH_METHODS = [
 	'scalar', 'simd', 'crc', 'simd-crc', 'bmi', 'avx512'
@@ -927,6 +961,14 @@ module.exports = {
 	gf_info: function(method) {
 		return binding.gf_info(getMethodNum(GF_METHODS, method));
 	},
+	gf_methods: function() {
+		return binding.gf_methods().map(function(method) {
+			return GF_METHODS[method];
+		});
+	},
+	cpu_cores: function() {
+		return binding.cpu_cores();
+	},
 	opencl_devices: function() {
 		return binding.opencl_devices();
 	},
@@ -937,6 +979,40 @@ module.exports = {
 			device = -1;
 		return binding.opencl_device_info(platform, device);
 	},
+	// tries configurations on a device, returning them fastest first; this blocks until complete, which can take a while
+	opencl_autotune: function(platform, device, cacheDir) {
+		if(platform === null || platform === undefined)
+			platform = -1;
+		if(device === null || device === undefined)
+			device = -1;
+		return binding.opencl_autotune(platform, device, cacheDir || '').map(function(result) {
+			result.method = GFOCL_METHODS[result.method];
+			return result;
+		});
+	},
+	
+	input_reader: function(method, queueDepth, directIO, sequential) {
+		var reader = new binding.InputReader(getMethodNum(READ_METHODS, method), queueDepth, !!directIO, sequential !== false);
+		if(method == 'mmap') {
+			// hand back a view into the mapping rather than filling the supplied buffer; callers use the third callback argument if supplied
+			reader.read = function(fd, buffer, offset, length, position, cb) {
+				var view;
+				try {
+					view = this.map(fd, position, length);
+				} catch(x) {
+					return process.nextTick(cb.bind(null, x));
+				}
+				process.nextTick(cb.bind(null, null, view.length, view));
+			};
+		}
+		return reader;
+	},
+	output_writer: function(method, queueDepth) {
+		return new binding.OutputWriter(getMethodNum(WRITE_METHODS, method), queueDepth);
+	},
+	alloc_aligned: function(size) {
+		return binding.alloc_aligned(size);
+	},
 	
 	set_inhash_method: function(method) {
 		return binding.set_HasherInput(getMethodNum(INHASH_METHODS, method));
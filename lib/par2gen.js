@@ -21,6 +21,87 @@ var friendlySize = function(s) {
 	return (Math.round(s *100)/100) + ' ' + units[i];
 };
 
+// resolves the OpenCL kernel cache directory, creating it if necessary; caching is disabled (empty string returned) if it can't be created
+var openclCacheDir = function(dir) {
+	if(dir === '') return '';
+	if(dir === null || dir === undefined) {
+		var os = require('os');
+		var home = os.homedir ? os.homedir() : (process.env.HOME || process.env.USERPROFILE);
+		var base;
+		if(process.platform == 'win32')
+			base = process.env.LOCALAPPDATA || os.tmpdir();
+		else if(process.platform == 'darwin')
+			base = home ? path.join(home, 'Library', 'Caches') : os.tmpdir();
+		else
+			base = process.env.XDG_CACHE_HOME || (home ? path.join(home, '.cache') : os.tmpdir());
+		dir = path.join(base, 'parpar', 'opencl');
+	}
+	var mkdir = function(d) {
+		try {
+			fs.mkdirSync(d);
+		} catch(x) {
+			if(x.code == 'EEXIST') return;
+			if(x.code != 'ENOENT' || path.dirname(d) == d) throw x;
+			mkdir(path.dirname(d));
+			fs.mkdirSync(d);
+		}
+	};
+	try {
+		mkdir(dir);
+	} catch(x) {
+		return '';
+	}
+	return dir;
+};
+
+// finds the fastest configuration for an OpenCL device, remembering it in the cache directory; entries are keyed by the driver version, as a driver update can change what works best (or at all)
+var openclTuned = function(devInfo, cacheDir, force) {
+	var key = [devInfo.vendor_id, devInfo.name, devInfo.driver_version].join('|');
+	var file = cacheDir ? path.join(cacheDir, 'tune.json') : null;
+	var saved = {};
+	if(file) {
+		try {
+			saved = JSON.parse(fs.readFileSync(file, 'utf8')) || {};
+		} catch(x) {}
+	}
+	if(!force && saved[key]) return saved[key];
+	
+	var best = Par2.opencl_autotune(devInfo.platform_id, devInfo.id, cacheDir)[0];
+	if(!best || !best.valid) return null;
+	saved[key] = {
+		method: best.method,
+		input_batchsize: best.input_batchsize,
+		target_iters: best.target_iters,
+		target_grouping: best.target_grouping,
+		target_workgroup: best.target_workgroup
+	};
+	if(file) {
+		try {
+			fs.writeFileSync(file, JSON.stringify(saved, null, '\t'));
+		} catch(x) {}
+	}
+	return saved[key];
+};
+
+// writes traced OpenCL commands in Chrome's trace event format (viewable in chrome://tracing or Perfetto), with transfers and compute on separate rows for each device, so that overlap between them is visible
+var writeOpenclTrace = function(file, spans) {
+	// a long job can have far too many spans to pass as arguments to Math.min
+	var base = spans.reduce(function(min, span) {
+		return Math.min(min, span.start);
+	}, Infinity);
+	var events = [], rows = {};
+	spans.forEach(function(span) {
+		var isCompute = span.stage == 'compute';
+		var tid = span.device*2 + (isCompute ? 0 : 1);
+		if(!(tid in rows)) {
+			rows[tid] = true;
+			events.push({name: 'thread_name', ph: 'M', pid: 1, tid: tid, args: {name: 'OpenCL device ' + span.device + (isCompute ? ' compute' : ' transfer')}});
+		}
+		events.push({name: span.stage, cat: 'opencl', ph: 'X', pid: 1, tid: tid, ts: span.start - base, dur: span.end - span.start});
+	});
+	fs.writeFileSync(file, JSON.stringify({traceEvents: events, displayTimeUnit: 'ms'}));
+};
+
 // normalize path for comparison purposes; this is very different to node's path.normalize()
 var pathNormalize, pathToPar2;
 if(path.sep == '\\') {
@@ -38,6 +119,7 @@ if(path.sep == '\\') {
 }
 
 var allocBuffer = (Buffer.allocUnsafe || Buffer);
+var MAX_PENDING_WRITES = 4; // maximum number of writes in flight per output file, when using the native writer
 
 var sumSize = function(ar) {
 	return ar.reduce(function(sum, e) {
@@ -212,12 +294,18 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 		displayNameBase: '.', // base path, only used if displayNameFormat is 'path'
 		seqReadSize: 4*1048576, // 4MB
 		chunkReadThreads: 2,
+		readMethod: 'auto', // auto, pread, io_uring, mmap or node
+		writeMethod: 'auto', // auto, pwrite, io_uring or node
+		readDirect: false, // bypass the OS' page cache when reading input
         readBuffers: 8,
 		readHashQueue: 5,
 		numThreads: null, // null => number of processors
+		cpuHybridSplit: 'auto', // on CPUs with multiple core types, process separately on each type (only if numThreads isn't set); 'auto' only does this if the OS reports each type's relative speed
 		gfMethod: null, // null => '' (auto)
 		loopTileSize: 0, // 0 = auto
-		openclDevices: [], // each device (defaults listed): {platform: null, device: null, ratio: null, memoryLimit: null, method: null, input_batchsize: 0, target_iters: 0, target_grouping: 0, minChunkSize: 32768}
+		openclDevices: [], // each device (defaults listed): {platform: null, device: null, ratio: null, memoryLimit: null, method: null, input_batchsize: 0, target_iters: 0, target_grouping: 0, target_workgroup: 0, tune: false, minChunkSize: 32768, max_alloc: 0, zero_copy: false}; tune can be 'force' to re-tune; max_alloc, if set, lowers the device's maximum buffer size; zero_copy uses host memory directly on devices which share it, instead of transferring to device buffers
+		openclCacheDir: null, // directory to cache compiled OpenCL kernels in; null => user's cache directory, '' to disable
+		openclTrace: null, // if set, file to write a timeline of OpenCL uploads/compute/downloads to, in Chrome's trace event format
 		cpuMinChunkSize: 65536, // must be even
 	};
 	if(opts) Par2._extend(o, opts);
@@ -394,6 +482,12 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 		throw new Error('Invalid processing batch size');
 	if(o.chunkReadThreads < 1 || o.chunkReadThreads > 32768)
 		throw new Error('Invalid number of chunk read threads');
+	if(['auto','pread','io_uring','mmap','node'].indexOf(o.readMethod) < 0)
+		throw new Error('Unknown read method "' + o.readMethod + '"');
+	if(['auto','pwrite','io_uring','node'].indexOf(o.writeMethod) < 0)
+		throw new Error('Unknown write method "' + o.writeMethod + '"');
+	if(o.readDirect && (o.readMethod == 'node' || o.readMethod == 'mmap'))
+		throw new Error('Direct I/O is not supported with the `' + o.readMethod + '` read method');
 	if(o.readBuffers < 1 || o.readBuffers > 32768)
 		throw new Error('Invalid number of read buffers');
 	if(o.chunkReadThreads > o.readBuffers)
@@ -522,9 +616,26 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 				throw new Error('Invalid OpenCL device iteration count (' + oclDev.target_iters + ')');
 			if(oclDev.target_grouping && (oclDev.target_grouping < 0 || oclDev.target_grouping > 65535))
 				throw new Error('Invalid OpenCL device grouping size (' + oclDev.target_grouping + ')');
+			if(oclDev.target_workgroup && oclDev.target_workgroup < 0)
+				throw new Error('Invalid OpenCL device workgroup size (' + oclDev.target_workgroup + ')');
+			
+			if(oclDev.tune) {
+				// tuned parameters only apply to the method they were tuned for, and only fill in what wasn't specified
+				var tuned = openclTuned(devInfo, openclCacheDir(o.openclCacheDir), oclDev.tune == 'force');
+				if(tuned && (!oclDev.method || oclDev.method == tuned.method)) {
+					['method', 'input_batchsize', 'target_iters', 'target_grouping', 'target_workgroup'].forEach(function(k) {
+						if(!oclDev[k]) oclDev[k] = tuned[k];
+					});
+				}
+			}
 			
 			// stuff for computing ratio
-			if(oclDev.ratio) {
+			if(oclDev.recovery && (oclDev.recovery < 0 || oclDev.recovery > 32768))
+				throw new Error('Invalid OpenCL device recovery slice count (' + oclDev.recovery + ')');
+			if(oclDev.dynamic || oclDev.recovery) {
+				// shares the CPU's portion, or computes its recovery slices across the whole chunk, instead of taking a fixed portion; plan memory for the case where it ends up processing everything
+				oclDev.ratio = 1;
+			} else if(oclDev.ratio) {
 				if(oclDev.ratio > 1 || oclDev.ratio <= 0)
 					throw new Error('Invalid OpenCL device processing ratio (' + (oclDev.ratio*100) + '%)');
 				if(oclDev.minChunkSize / oclDev.ratio > o.sliceSize)
@@ -555,6 +666,7 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 		// compute memory/ratio stuff
 		cpuRatio = 1; // re-compute this as the list may be different
 		o.openclDevices.forEach(function(oclDev) {
+			if(oclDev.dynamic || oclDev.recovery) return;
 			if(oclDev.ratio)
 				cpuRatio -= oclDev.ratio;
 			else
@@ -679,20 +791,88 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 	
 	// break up chunks across devices
 	var procCpu = {method: gfInfo.id, chunk_size: o.loopTileSize, input_batchsize: o.processBatchSize};
+	// devices allocated recovery slices compute those across the whole chunk; everything else computes the remaining recovery slices
+	var recoveryOffset = 0;
+	o.openclDevices.forEach(function(oclDev) {
+		if(!oclDev.recovery) return;
+		oclDev.slice_offset = 0;
+		oclDev.slice_size = this._chunkSize;
+		oclDev.recovery_offset = recoveryOffset;
+		oclDev.recovery_count = oclDev.recovery;
+		recoveryOffset += oclDev.recovery;
+	}.bind(this));
 	var sliceOffset = 0;
 	o.openclDevices.forEach(function(oclDev) {
+		oclDev.cksum_method = gfInfo.id;
+		if(oclDev.dynamic || oclDev.recovery) return;
+		oclDev.recovery_offset = recoveryOffset;
 		oclDev.slice_offset = sliceOffset;
 		oclDev.slice_size = Math.round(oclDev.ratio * this._chunkSize / 2) * 2;
 		sliceOffset += oclDev.slice_size;
-		oclDev.cksum_method = gfInfo.id;
+	}.bind(this));
+	// dynamic devices are given the same portion as the CPU; each input for it is then sent to whichever is free
+	o.openclDevices.forEach(function(oclDev) {
+		if(!oclDev.dynamic || oclDev.recovery) return;
+		oclDev.recovery_offset = recoveryOffset;
+		oclDev.slice_offset = sliceOffset;
+		oclDev.slice_size = this._chunkSize - sliceOffset;
 	}.bind(this));
 	o.openclDevices = o.openclDevices.filter(function(oclDev) {
 		return oclDev.slice_size > 0;
 	});
+	if(o.openclDevices.length) {
+		var cacheDir = openclCacheDir(o.openclCacheDir);
+		o.openclDevices.forEach(function(oclDev) {
+			oclDev.cache_dir = cacheDir;
+			oclDev.trace = !!o.openclTrace;
+		});
+	}
+	this._oclTrace = [];
 	procCpu.slice_offset = sliceOffset;
 	procCpu.slice_size = this._chunkSize - sliceOffset;
+	procCpu.recovery_offset = recoveryOffset;
 	if(procCpu.slice_size < 1) procCpu = null; // no CPU processing
 	
+	// on hybrid CPUs, give each core type its own backend, pinned to those cores, and split the CPU's portion by their throughput, so that slow cores don't hold up every batch
+	// if a dynamic device shares the CPU's portion, each core type instead joins it with the same portion, so that work is shared out by how fast each actually runs
+	var hashCpus = null;
+	if(procCpu && o.cpuHybridSplit && !o.numThreads) {
+		var sharedRange = o.openclDevices.some(function(oclDev) {
+			return oclDev.dynamic && !oclDev.recovery;
+		});
+		var coreClasses = Par2.cpu_cores();
+		if(o.cpuHybridSplit === 'auto' && !sharedRange && coreClasses.some(function(cls) {
+			return cls.capacity_estimated;
+		}))
+			coreClasses = []; // relative speed is only a guess from the core type, so don't split unless explicitly requested
+		// SMT siblings share a core's execution units, so weight by physical cores
+		var totalWeight = coreClasses.reduce(function(sum, cls) {
+			return sum + cls.capacity * cls.cores;
+		}, 0);
+		if(coreClasses.length > 1 && totalWeight > 0) {
+			var cpuStart = procCpu.slice_offset, cpuSize = procCpu.slice_size;
+			var weight = 0, classOffset = cpuStart;
+			procCpu = coreClasses.map(function(cls) {
+				weight += cls.capacity * cls.cores;
+				var classEnd = cpuStart + Math.round(cpuSize * weight / totalWeight / 2) * 2;
+				if(weight >= totalWeight) classEnd = cpuStart + cpuSize;
+				var spec = Par2._extend({}, procCpu);
+				if(!sharedRange) {
+					spec.slice_offset = classOffset;
+					spec.slice_size = classEnd - classOffset;
+				}
+				spec.cpus = cls.cpus;
+				// serial work (transfers and hashing) goes to the fastest cores
+				spec.transfer_cpus = coreClasses[0].cpus;
+				classOffset = classEnd;
+				return spec;
+			}).filter(function(spec) {
+				return spec.slice_size > 0;
+			});
+			hashCpus = coreClasses[0].cpus;
+		}
+	}
+	
 	// generate display filenames
 	if(o.displayNameFormat == 'outrel') {
 		// if we want paths relative to the output file, it's the same as specifying the path of the file explicitly
@@ -762,7 +942,12 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 		stagingCount: stagingCount,
 		hashBatchSize: o.hashBatchSize,
 		proc_cpu: procCpu,
-		proc_ocl: o.openclDevices
+		proc_ocl: o.openclDevices,
+		hash_cpus: hashCpus,
+		ocl_trace: o.openclTrace ? function(spans) {
+			for(var i=0; i<spans.length; i++)
+				this._oclTrace.push(spans[i]);
+		}.bind(this) : null
 	});
 	this.files = par.getFiles();
 	
@@ -1005,11 +1190,18 @@ PAR2Gen.prototype = {
 		return fns;
 	},
 	
+	_getWriter: function() {
+		if(this.opts.writeMethod == 'node') return null;
+		if(!this._writer)
+			this._writer = Par2.output_writer(this.opts.writeMethod, MAX_PENDING_WRITES);
+		return this._writer;
+	},
 	_initOutputFiles: function(cb) {
 		var sliceOffset = 0;
 		var self = this;
 		async.eachSeries(this.recoveryFiles, function(rf, cb) {
 			sliceOffset += rf.recoverySlices;
+			rf.writer = self._getWriter();
 			rf.open(self.opts.outputOverwrite, function(err) {
 				if(err) return cb(err);
 				// TODO: may wish to be careful that prealloc doesn't screw with the reading I/O
@@ -1071,6 +1263,10 @@ PAR2Gen.prototype = {
 		}
 		this.par2.setRecoverySlices(0);
 		this.par2.close();
+		if(this.opts.openclTrace && this._oclTrace.length) {
+			writeOpenclTrace(this.opts.openclTrace, this._oclTrace);
+			this._oclTrace = [];
+		}
 	},
 	
 	// process some input
@@ -1127,6 +1323,21 @@ PAR2Gen.prototype = {
 		var relRecIdx = rf.recoveryIndex - this.sliceOffset -1;
 		var slices = this._sliceNums.slice(this.sliceOffset, this.sliceOffset+this._slicesPerPass);
 		var self = this;
+		
+		// the native writer doesn't go through libuv's threadpool, so allow a few writes to be in flight whilst the next packet is being fetched
+		rf.writer = this._getWriter();
+		var pendingWrites = 0, writeErr = null, writeWaitCb = null;
+		var onWriteDone = function(recData, err) {
+			if(err && !writeErr) writeErr = err;
+			if(recData) recData.release();
+			pendingWrites--;
+			if(writeWaitCb) {
+				var _cb = writeWaitCb;
+				writeWaitCb = null;
+				_cb(writeErr);
+			}
+		};
+		
 		async.timesSeries(rf.packets.length, function(pktI, cb) {
 			var pkt = rf.packets[pktI];
 			var recData;
@@ -1162,7 +1373,16 @@ PAR2Gen.prototype = {
 				rf.open.bind(rf, self.opts.outputOverwrite),
 				function(cb) {
 					if(cbProgress) cbProgress('writing_file_pos', rf, cPos + pkt.dataChunkOffset);
-					rf.writePackets(pktI, cPos, cb);
+					if(!rf.writer)
+						return rf.writePackets(pktI, cPos, cb);
+					
+					pendingWrites++;
+					rf.writePackets(pktI, cPos, onWriteDone.bind(null, recData));
+					recData = null; // released once the write completes
+					if(pendingWrites >= MAX_PENDING_WRITES)
+						writeWaitCb = cb;
+					else
+						cb(writeErr);
 				}
 			], function(err) {
 				if(err && err !== true)
@@ -1172,7 +1392,14 @@ PAR2Gen.prototype = {
 				setImmediate(cb); // if there's a lot of empty packets in this file, prevent the call stack from growing too big
 			});
 			
-		}, cb);
+		}, function(err) {
+			// wait for all writes to complete
+			var finish = function() {
+				if(pendingWrites) writeWaitCb = finish;
+				else cb(err || writeErr);
+			};
+			finish();
+		});
 	},
 	// TODO: consider avoid writing all critical packets at once
 	writeFiles: function(cbProgress, cb) {
@@ -1183,9 +1410,16 @@ PAR2Gen.prototype = {
 	},
 	closeFiles: function(cb) {
 		var sync = this.opts.outputSync;
+		var self = this;
 		async.eachSeries(this.recoveryFiles, function(rf, cb) {
 			rf.close(sync, cb);
-		}, cb);
+		}, function(err) {
+			if(self._writer) {
+				self._writer.close();
+				self._writer = null;
+			}
+			cb(err);
+		});
 	},
 	// throw away any buffered data, if not needed
 	discardData: function() {
@@ -1203,10 +1437,37 @@ PAR2Gen.prototype = {
 		// TODO: perhaps we should dealloc though - to give .finish more RAM?
 		if(!this._buf) this._buf = [];
 		var seeking = (chunkSize != this.opts.sliceSize) && !firstPass;
+		
+		// native reader avoids libuv's threadpool, which limits how many reads can be in flight
+		var reader = null;
+		if(this.opts.readMethod != 'node') {
+			reader = Par2.input_reader(this.opts.readMethod, seeking ? this.opts.chunkReadThreads : 1, this.opts.readDirect, !seeking);
+			var _cb = cb;
+			var readerOpen = true;
+			cb = function(err) {
+				// on error, reads may still be in flight, in which case the reader closes once they complete
+				if(readerOpen) {
+					readerOpen = false;
+					reader.close();
+				}
+				_cb(err);
+			};
+		}
+		// direct reads can go straight into the buffer if it's suitably aligned, otherwise they need to be bounced
+		var allocFn = this.opts.readDirect ? Par2.alloc_aligned : null;
+		var bufs = this._buf;
+		if(this.opts.readMethod == 'mmap') {
+			// mapped reads return views into the file instead of filling buffers, so just hand out placeholders to limit how many reads are outstanding
+			allocFn = function(size) {
+				return {length: size};
+			};
+			bufs = [];
+		}
+		
 		if(seeking) {
 			if(!self._chunker) return cb(new Error('Trying to perform chunked reads without a chunker'));
-			var bufPool = new BufferPool(this._buf, chunkSize, this.opts.readBuffers);
-			FileChunkReader(this.files, this.opts.sliceSize, chunkSize, this.chunkOffset, bufPool, this.opts.chunkReadThreads, function(file, buffer, sliceNum, cb) {
+			var bufPool = new BufferPool(bufs, chunkSize, this.opts.readBuffers, allocFn);
+			FileChunkReader(this.files, this.opts.sliceSize, chunkSize, this.chunkOffset, bufPool, this.opts.chunkReadThreads, reader, function(file, buffer, sliceNum, cb) {
 				if(cbProgress) cbProgress('processing_slice', file, sliceNum);
 				self._chunker.processData(file.sliceOffset+sliceNum, buffer, cb);
 			}, function(err) {
@@ -1214,20 +1475,20 @@ PAR2Gen.prototype = {
 				else bufPool.end(cb);
 			});
 		} else {
-			var reader = new FileSeqReader(this.files, this.readSize, this.opts.readBuffers);
-			reader.setBuffers(this._buf);
-			reader.maxQueuePerFile = this.opts.readHashQueue;
+			var seqReader = new FileSeqReader(this.files, this.readSize, this.opts.readBuffers, reader, allocFn);
+			seqReader.setBuffers(bufs);
+			seqReader.maxQueuePerFile = this.opts.readHashQueue;
 			
 			var slicesPerRead;
 			if(this._chunker)
-				reader.requireChunk(this.opts.sliceSize, chunkSize);
+				seqReader.requireChunk(this.opts.sliceSize, chunkSize);
 			else if(this.opts.recoverySlices > 0) {
 				slicesPerRead = this.readSize / this.opts.sliceSize;
 				if(slicesPerRead != Math.floor(slicesPerRead))
 					throw new Error('Expected read size (' + this.readSize + ') to be a multiple of slice size (' + this.opts.sliceSize + ')');
 			}
 			
-			reader.run(function(err, data) {
+			seqReader.run(function(err, data) {
 				if(err) return cb(err);
 				if(firstPass)
 					data.file.processHash(data.buffer, data.hashed.bind(data));
@@ -1376,6 +1637,36 @@ PAR2Gen.prototype = {
 		});
 	},
 	
+	// writes out recovery for data which has already been fed through in a single pass, such as when streaming input (see PAR2GenStream)
+	runStreamed: function(cbProgress, cb) {
+		var self = this;
+		if(!cb) {
+			cb = cbProgress;
+			cbProgress = null;
+		}
+		
+		this._slicesPerPass = this.opts.recoverySlices;
+		async.series([
+			this._initOutputFiles.bind(this),
+			function(cb) {
+				if(cbProgress) cbProgress('chunk_pass_write', 0, 0);
+				self.finish(cb);
+			},
+			function(cb) {
+				self.writeFiles(cbProgress, cb);
+			}
+		], function(err) {
+			if(!err) {
+				if(cbProgress) cbProgress('chunk_pass_complete', 0, 0);
+				self.freeMemory();
+			}
+			if(cbProgress) cbProgress('closing_files');
+			self.closeFiles(function(err2) {
+				cb(err || err2);
+			});
+		});
+	},
+	
 	// TODO: improve events system
 	run: function(cbProgress, cb) {
 		var self = this;
@@ -1408,8 +1699,221 @@ PAR2Gen.prototype = {
 };
 
 
+// generates recovery from a stream of unknown length (e.g. a pipe), reading it only once
+// as the input's size (and hence file ID and recovery set ID) isn't known until the stream ends, the data is processed using a provisional generator, which assumes the largest input possible; once the stream ends, the real generator is created and takes over the processed recovery data
+// all recovery must fit in memory, and the amount of recovery must be determinable without knowing the input size
+var MAX_INPUT_SLICES = 32768;
+function PAR2GenStream(stream, displayName, sliceSize, opts) {
+	if(!(this instanceof PAR2GenStream))
+		return new PAR2GenStream(stream, displayName, sliceSize, opts);
+	
+	if(!(sliceSize > 0))
+		throw new Error('Streaming requires the slice size to be specified in bytes');
+	if(!displayName)
+		throw new Error('A name must be specified for the streamed file');
+	opts = opts || {};
+	if((opts.minSliceSize && opts.minSliceSize != sliceSize) || (opts.maxSliceSize && opts.maxSliceSize != sliceSize))
+		throw new Error('Slice size limits are not supported when streaming');
+	['recoverySlices', 'minRecoverySlices', 'maxRecoverySlices'].forEach(function(k) {
+		if(!opts[k]) return;
+		(Array.isArray(opts[k]) ? opts[k] : [opts[k]]).forEach(function(s) {
+			if(typeof s == 'object' && ['slices', 'count', 'bytes'].indexOf(s.unit) < 0)
+				throw new Error('Recovery amount must be specified as a slice count or size when streaming');
+		});
+	});
+	
+	this.stream = stream;
+	this.displayName = displayName;
+	this._opts = opts;
+	this._gen = new PAR2Gen([this._fileInfo(sliceSize * MAX_INPUT_SLICES, null)], sliceSize, this._genOpts(sliceSize));
+	this.opts = this._gen.opts;
+	this.recoveryFiles = this._gen.recoveryFiles;
+	if(this.opts.recoverySlices < 1)
+		throw new Error('Recovery must be generated when streaming');
+	if(this._gen.passes > 1 || this._gen.chunks > 1)
+		throw new Error('Streaming requires all recovery data to be held in memory, but ' + friendlySize(this.opts.recoverySlices * this.opts.sliceSize) + ' of recovery exceeds the memory limit; consider raising the memory limit or reducing the amount of recovery');
+	this.slicesPerPass = this._gen.slicesPerPass;
+	this._chunkSize = this._gen._chunkSize;
+	this.procInStagingBufferCount = this._gen.procInStagingBufferCount;
+	this.readSize = sliceSize;
+	this.totalSize = 0;
+	this.inputSlices = 0;
+}
+PAR2GenStream.prototype = {
+	passes: 1,
+	chunks: 1,
+	passNum: 0,
+	passChunkNum: 0,
+	
+	_fileInfo: function(size, md5_16k) {
+		if(!md5_16k) {
+			md5_16k = allocBuffer(16);
+			md5_16k.fill(0);
+		}
+		return {displayName: this.displayName, size: size, md5_16k: md5_16k};
+	},
+	// the generator may alter some options, so give each instance its own copy
+	_genOpts: function(sliceSize) {
+		var o = Par2._extend({}, this._opts);
+		if(o.openclDevices) o.openclDevices = o.openclDevices.map(function(dev) {
+			return Par2._extend({}, dev);
+		});
+		// every read needs to be a whole slice
+		o.seqReadSize = Math.max(o.seqReadSize || 0, sliceSize);
+		return o;
+	},
+	
+	run: function(cbProgress, cb) {
+		var self = this;
+		if(!cb) {
+			cb = cbProgress;
+			cbProgress = null;
+		}
+		var gen = this._gen, stream = this.stream;
+		var file = gen.files[0];
+		var sliceSize = this.opts.sliceSize;
+		gen._setSlices(0);
+		if(cbProgress) cbProgress('begin_chunk_pass', 0, 0);
+		
+		var md5_16k = require('crypto').createHash('md5'), md5_16kLen = 0;
+		var bufPool = new BufferPool([], sliceSize, this.opts.readBuffers);
+		var curBuf = null, curLen = 0, error = null;
+		
+		// slices are fed to the backend and hashed concurrently; the buffer is reused once both complete
+		var submit = function(buf, len) {
+			var data = buf.slice(0, len);
+			var sliceNum = self.inputSlices++;
+			if(cbProgress) cbProgress('processing_slice', file, sliceNum);
+			async.parallel([
+				gen.par2.processSlice.bind(gen.par2, data, sliceNum),
+				file.processHash.bind(file, data)
+			], function() {
+				bufPool.put(buf);
+			});
+		};
+		var ended = false;
+		var done = function() {
+			if(ended) return;
+			ended = true;
+			if(curBuf) {
+				if(curLen && !error) submit(curBuf, curLen);
+				else bufPool.put(curBuf);
+				curBuf = null;
+			}
+			bufPool.end(function() {
+				if(!error && !self.totalSize)
+					error = new Error('No data received from input stream');
+				if(error) return self._abort(error, cb);
+				self._finalize(md5_16k.digest(), cbProgress, cb);
+			});
+		};
+		var fail = function(err) {
+			if(error) return;
+			error = err;
+			stream.removeListener('data', onData);
+			stream.pause();
+			done();
+		};
+		var fill = function(chunk) {
+			while(chunk.length) {
+				if(!curBuf) {
+					var waiting = true;
+					bufPool.get(function(buf) {
+						if(error) return bufPool.put(buf);
+						curBuf = buf;
+						curLen = 0;
+						// if the buffer was freed up later, continue where we left off
+						if(!waiting && fill(chunk) && !error)
+							stream.resume();
+					});
+					waiting = false;
+					if(!curBuf) {
+						// no free buffers: hold back the stream until one is available
+						stream.pause();
+						return false;
+					}
+				}
+				var len = Math.min(chunk.length, sliceSize - curLen);
+				chunk.copy(curBuf, curLen, 0, len);
+				curLen += len;
+				chunk = chunk.slice(len);
+				if(curLen == sliceSize) {
+					submit(curBuf, curLen);
+					curBuf = null;
+				}
+			}
+			return true;
+		};
+		var onData = function(chunk) {
+			if(self.totalSize + chunk.length > sliceSize * MAX_INPUT_SLICES)
+				return fail(new Error('Input stream exceeds the maximum of ' + MAX_INPUT_SLICES + ' slices; please increase the slice size'));
+			self.totalSize += chunk.length;
+			if(md5_16kLen < 16384) {
+				var part = chunk.slice(0, 16384 - md5_16kLen);
+				md5_16k.update(part);
+				md5_16kLen += part.length;
+			}
+			fill(chunk);
+		};
+		
+		stream.on('data', onData);
+		stream.once('error', fail);
+		stream.once('end', done);
+		if(stream.isPaused && stream.isPaused()) stream.resume();
+	},
+	_abort: function(err, cb) {
+		var gen = this._gen, file = gen.files[0];
+		if(file._md5ctx) {
+			file._md5ctx.end(allocBuffer(16));
+			file._md5ctx = null;
+		}
+		// all adds have completed by now, so just wait for processing to finish, without retrieving any recovery
+		gen.par2.gf.end(function() {
+			gen.freeMemory();
+			cb(err);
+		});
+	},
+	// create the real generator and pass over everything that has been computed
+	_finalize: function(md5_16k, cbProgress, cb) {
+		var gen = this._gen, file = gen.files[0];
+		if(!file.md5) {
+			file.md5 = allocBuffer(16);
+			file._md5ctx.end(file.md5);
+			file._md5ctx = null;
+		}
+		
+		var gen2;
+		try {
+			gen2 = new PAR2Gen([this._fileInfo(this.totalSize, md5_16k)], this.opts.sliceSize, this._genOpts(this.opts.sliceSize));
+		} catch(x) {
+			return this._abort(x, cb);
+		}
+		if(gen2._sliceNums.join(',') != gen._sliceNums.join(','))
+			return this._abort(new Error('Recovery slice assignment changed after streaming'), cb);
+		
+		var file2 = gen2.files[0];
+		// the final generator's hasher is unused, but needs to be closed off
+		file2._md5ctx.end(allocBuffer(16));
+		file2._md5ctx = null;
+		file2.md5 = file.md5;
+		file.pktCheck.copy(file2.pktCheck, 64+16, 64+16, file2.pktCheck.length); // block checksums
+		gen2.par2.takeProcessor(gen.par2);
+		
+		this._gen = gen2;
+		this.opts = gen2.opts;
+		this.recoveryFiles = gen2.recoveryFiles;
+		gen2.runStreamed(cbProgress, cb);
+	},
+	
+	gf_info: function() {
+		return this._gen.gf_info();
+	}
+};
+
+
 module.exports = {
 	PAR2Gen: PAR2Gen,
+	PAR2GenStream: PAR2GenStream,
 	run: function(files, sliceSize, opts, cb) {
 		if(typeof opts == 'function' && cb === undefined) {
 			cb = opts;
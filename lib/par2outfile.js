@@ -40,23 +40,31 @@ PAR2OutFile.prototype = {
 	totalSize: 0,
 	
 	fd: null,
+	writer: null, // native writer, if used
 	
 	open: function(overwrite, cb) {
 		if(this.fd) return cb();
 		var self = this;
-		fs.open(this.name, overwrite ? 'w' : 'wx', function(err, fd) {
+		var onOpen = function(err, fd) {
 			if(!err)
 				self.fd = fd;
 			cb(err);
-		});
+		};
+		if(this.writer)
+			this.writer.open(this.name, overwrite, onOpen);
+		else
+			fs.open(this.name, overwrite ? 'w' : 'wx', onOpen);
 	},
 	prealloc: function(cb) {
-		// unfortunately node doesn't give us fallocate, so try to emulate it with ftruncate and writing a junk byte at the end
-		// at least on Windows, this significantly improves performance
 		var totalSize = this.totalSize;
 		if(!totalSize) return cb(); // should never happen
 		
 		var fd = this.fd;
+		if(this.writer) // uses fallocate where available
+			return this.writer.allocate(fd, totalSize, cb);
+		
+		// unfortunately node doesn't give us fallocate, so try to emulate it with ftruncate and writing a junk byte at the end
+		// at least on Windows, this significantly improves performance
 		try {
 			fs.ftruncate(fd, totalSize, function(err) {
 				if(err) cb(err);
@@ -76,12 +84,14 @@ PAR2OutFile.prototype = {
 		// try to combine writes if possible
 		var pkt = this.packets[pktI];
 		var writeToPktI = pktI+1, writeLen = pkt.dataLen();
-		if(writev && pkt.dataChunkOffset + writeLen == pkt.size) {
+		// the native writer handles gather writes of any length
+		var maxWriteLen = this.writer ? Infinity : MAX_WRITE_SIZE;
+		if((this.writer || writev) && pkt.dataChunkOffset + writeLen == pkt.size) {
 			while(writeToPktI < this.packets.length) {
 				var nPkt = this.packets[writeToPktI];
 				if(!nPkt.data || nPkt.dataChunkOffset) break; // if no data to write, exit
 				var nPkt_dataLen = nPkt.dataLen();
-				if(writeLen + nPkt_dataLen > MAX_WRITE_SIZE) break; // if this packet will overflow, bail
+				if(writeLen + nPkt_dataLen > maxWriteLen) break; // if this packet will overflow, bail
 				writeToPktI++; // include this packet for writing
 				writeLen += nPkt_dataLen;
 				if(nPkt_dataLen != nPkt.size) // different write/packet length, requires a seek = cannot write combine
@@ -93,13 +103,16 @@ PAR2OutFile.prototype = {
 		// - on MacOS, libuv uses a mutex around writes, so can't be concurrent
 		// - on Windows, writev is not supported, so may be less desirable (concurrent writes may interleave with emulation)
 		var pos = curPos + pkt.dataChunkOffset;
-		if(writev && writeLen <= MAX_WRITE_SIZE) {
+		if(this.writer || (writev && writeLen <= MAX_WRITE_SIZE)) {
 			// can write combine
 			var wPkt = this.packets.slice(pktI, writeToPktI);
 			var wBufs = Array.prototype.concat.apply([], wPkt.map(function(pkt) {
 				return pkt.takeData();
 			}));
-			writev(this.fd, wBufs, pos, cb);
+			if(this.writer)
+				this.writer.write(this.fd, wBufs, pos, cb);
+			else
+				writev(this.fd, wBufs, pos, cb);
 			return wPkt.length;
 		} else {
 			var pktData = pkt.takeData();
@@ -0,0 +1,201 @@
+#ifndef PP_CPU_CORES_H
+#define PP_CPU_CORES_H
+
+#include "platform.h"
+#include "cpuid.h"
+#include <vector>
+#include <map>
+#include <set>
+#include <functional>
+
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#elif defined(__linux) || defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# include <stdio.h>
+#endif
+
+// a set of logical CPUs with the same core type, for hybrid CPUs (e.g. Intel P/E cores or ARM big.LITTLE)
+struct CpuCoreClass {
+	std::vector<int> cpus;
+	unsigned cores; // number of physical cores; less than the number of CPUs if SMT is enabled
+	unsigned capacity; // relative per-core throughput; the fastest class is 1024
+	bool efficiency; // true for all but the fastest class
+	bool estimated; // if true, the capacity is a rough guess from the core type, rather than reported by the OS
+};
+
+// relative throughput of an Intel E-core vs a P-core; the cores themselves don't report this, so this is a rough figure for SIMD heavy work (half width vector units + lower clocks)
+// as it's only a guess, classes using it are flagged as `estimated`, and the caller doesn't split work by it unless asked to
+#define CPU_CORE_INTEL_ATOM_CAPACITY 512
+
+#if defined(__linux) || defined(__linux__)
+// kernels with a CPU topology driver (ARM, RISC-V) expose each core's capacity, scaled so that the fastest is 1024
+static inline bool cpu_cores_from_sysfs(std::map<int, unsigned>& capacity) {
+	long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+	for(int cpu=0; cpu<numCpus; cpu++) {
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+		FILE* f = fopen(path, "r");
+		if(!f) continue;
+		unsigned cap;
+		if(fscanf(f, "%u", &cap) == 1 && cap)
+			capacity[cpu] = cap;
+		fclose(f);
+	}
+	return !capacity.empty();
+}
+#endif
+
+// maps each logical CPU to an identifier for the physical core it's on, so that SMT siblings can be counted once
+// CPUs missing from the map are assumed to be separate cores
+static inline void cpu_cores_physical_ids(std::map<int, int>& coreIds) {
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+	// only covers the current processor group, like cpu_cores_visit_each
+	DWORD len = 0;
+	GetLogicalProcessorInformation(NULL, &len);
+	if(!len) return;
+	std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+	if(!GetLogicalProcessorInformation(info.data(), &len)) return;
+	int coreId = 0;
+	for(const auto& proc : info) {
+		if(proc.Relationship != RelationProcessorCore) continue;
+		for(int cpu=0; cpu<(int)sizeof(ULONG_PTR)*8; cpu++)
+			if(proc.ProcessorMask & ((ULONG_PTR)1 << cpu))
+				coreIds[cpu] = coreId;
+		coreId++;
+	}
+#elif defined(__linux) || defined(__linux__)
+	// SMT siblings share the same list, so its first entry identifies the core
+	long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+	for(int cpu=0; cpu<numCpus; cpu++) {
+		char path[80];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+		FILE* f = fopen(path, "r");
+		if(!f) continue;
+		int firstSibling;
+		if(fscanf(f, "%d", &firstSibling) == 1)
+			coreIds[cpu] = firstSibling;
+		fclose(f);
+	}
+#else
+	(void)coreIds;
+#endif
+}
+
+#ifdef PLATFORM_X86
+// calls `fn` whilst running on each CPU this process is allowed to run on, then restores the thread's original affinity
+static inline bool cpu_cores_visit_each(std::function<void(int)> fn) {
+# if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+	// only covers the current processor group
+	DWORD_PTR procMask, sysMask;
+	if(!GetProcessAffinityMask(GetCurrentProcess(), &procMask, &sysMask))
+		return false;
+	HANDLE hThread = GetCurrentThread();
+	DWORD_PTR origMask = 0;
+	for(int cpu=0; cpu<(int)sizeof(DWORD_PTR)*8; cpu++) {
+		DWORD_PTR mask = (DWORD_PTR)1 << cpu;
+		if(!(procMask & mask)) continue;
+		DWORD_PTR prevMask = SetThreadAffinityMask(hThread, mask); // moves the thread immediately if it isn't running on an allowed CPU
+		if(!prevMask) continue;
+		if(!origMask) origMask = prevMask;
+		fn(cpu);
+	}
+	if(origMask) SetThreadAffinityMask(hThread, origMask);
+	return origMask != 0;
+# elif defined(__linux) || defined(__linux__)
+	pthread_t self = pthread_self();
+	cpu_set_t origSet;
+	if(pthread_getaffinity_np(self, sizeof(origSet), &origSet))
+		return false;
+	bool visited = false;
+	for(int cpu=0; cpu<CPU_SETSIZE; cpu++) {
+		if(!CPU_ISSET(cpu, &origSet)) continue;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if(pthread_setaffinity_np(self, sizeof(set), &set)) continue; // the kernel migrates the calling thread before returning
+		fn(cpu);
+		visited = true;
+	}
+	pthread_setaffinity_np(self, sizeof(origSet), &origSet);
+	return visited;
+# else
+	// MacOS can't pin threads, and there's no x86 hybrid Mac anyway
+	(void)fn;
+	return false;
+# endif
+}
+
+// CPUID leaf 0x1A gives the type of the core it's executed on
+static inline bool cpu_cores_from_cpuid(std::map<int, unsigned>& capacity) {
+	int cpuInfo[4];
+	_cpuid(cpuInfo, 0);
+	if(cpuInfo[0] < 0x1A) return false;
+	_cpuidX(cpuInfo, 7, 0);
+	if(!(cpuInfo[3] & 0x8000)) return false; // not a hybrid processor
+
+	return cpu_cores_visit_each([&](int cpu) {
+		int info[4];
+		_cpuidX(info, 0x1A, 0);
+		int coreType = (info[0] >> 24) & 0xff;
+		capacity[cpu] = (coreType == 0x20 /*Atom*/) ? CPU_CORE_INTEL_ATOM_CAPACITY : 1024;
+	}) && !capacity.empty();
+}
+#endif
+
+// returns the core classes, fastest first; an empty list is returned if the CPU isn't hybrid (or it couldn't be determined)
+static inline std::vector<CpuCoreClass> cpu_core_classes_detect() {
+	std::map<int, unsigned> capacity;
+	bool found = false, estimated = false;
+#if defined(__linux) || defined(__linux__)
+	found = cpu_cores_from_sysfs(capacity);
+#endif
+#ifdef PLATFORM_X86
+	if(!found) {
+		capacity.clear();
+		found = estimated = cpu_cores_from_cpuid(capacity);
+	}
+#endif
+
+	std::vector<CpuCoreClass> classes;
+	if(!found) return classes;
+
+	std::map<unsigned, std::vector<int>, std::greater<unsigned>> byCapacity;
+	for(const auto& cpu : capacity)
+		byCapacity[cpu.second].push_back(cpu.first);
+	if(byCapacity.size() < 2) return classes;
+
+	std::map<int, int> coreIds;
+	cpu_cores_physical_ids(coreIds);
+	unsigned maxCapacity = byCapacity.begin()->first;
+	for(const auto& cls : byCapacity) {
+		std::set<int> cores;
+		for(int cpu : cls.second) {
+			auto coreId = coreIds.find(cpu);
+			// offset unknown CPUs so that they can't collide with a known core's ID
+			cores.insert(coreId == coreIds.end() ? -1-cpu : coreId->second);
+		}
+		classes.push_back({
+			cls.second,
+			(unsigned)cores.size(),
+			(unsigned)((uint64_t)cls.first * 1024 / maxCapacity),
+			cls.first < maxCapacity,
+			estimated
+		});
+	}
+	return classes;
+}
+
+// detection migrates the calling thread across all CPUs, so is only done once
+static inline const std::vector<CpuCoreClass>& cpu_core_classes() {
+	static const std::vector<CpuCoreClass> classes = cpu_core_classes_detect();
+	return classes;
+}
+
+#endif // defined(PP_CPU_CORES_H)
@@ -0,0 +1,842 @@
+#include "file_reader.h"
+#include "platform.h"
+#include <cstring>
+#include <cerrno>
+
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+#include <fcntl.h>
+#include <limits.h>
+
+#ifdef FILE_READER_HAS_MMAP
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+#ifdef FILE_READER_HAS_URING
+# include <linux/io_uring.h>
+# include <sys/eventfd.h>
+#endif
+
+#ifndef MIN
+# define MIN(a, b) ((a)<(b) ? (a) : (b))
+#endif
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
+#define IS_DIRECT_ALIGNED(n) (((n) & (FILE_READER_DIRECT_ALIGN-1)) == 0)
+
+// cap the number of pread threads; beyond this, extra requests just queue up on existing threads
+#define FILE_READER_MAX_THREADS 128
+// io_uring can cope with much deeper queues, but there's little point going beyond this
+#define FILE_READER_MAX_URING_ENTRIES 4096
+// how many times (1ms apart) submission is retried when the kernel is out of resources and there's nothing else in flight
+#define FILE_READER_URING_RETRIES 100
+
+FileReader::FileReader(uv_loop_t* _loop)
+: loop(_loop), method(FILE_READER_AUTO), queueDepth(0), pendingReads(0), directIO(false), sequential(true), _queueDone(_loop, this, &FileReader::_notifyDone)
+#ifdef FILE_READER_HAS_URING
+, ringFd(-1), ringEventFd(-1), ringPoll(nullptr), sqRingPtr(nullptr), cqRingPtr(nullptr), sqes(nullptr), ringEntries(0), ringInFlight(0), ringUnsubmitted(0)
+#endif
+{}
+
+FileReader::~FileReader() {
+	deinit();
+}
+
+bool FileReader::init(FileReaderMethods _method, unsigned _queueDepth, bool _directIO, bool _sequential) {
+	if(!loop) return false;
+	if(_queueDepth < 1) _queueDepth = 1;
+	queueDepth = _queueDepth;
+	directIO = _directIO;
+	sequential = _sequential;
+
+	if(_method == FILE_READER_MMAP) {
+#ifdef FILE_READER_HAS_MMAP
+		// mapping bypasses the page cache copy, so makes no sense with direct I/O
+		if(directIO) return false;
+		method = FILE_READER_MMAP;
+		return true;
+#else
+		return false;
+#endif
+	}
+
+#ifdef FILE_READER_HAS_URING
+	if(_method == FILE_READER_AUTO || _method == FILE_READER_URING) {
+		if(init_uring()) {
+			method = FILE_READER_URING;
+			return true;
+		}
+		if(_method == FILE_READER_URING) return false;
+	}
+#else
+	if(_method == FILE_READER_URING) return false;
+#endif
+
+	method = FILE_READER_PREAD;
+	return init_pread();
+}
+
+void FileReader::open(const char* path, const FileReaderOpenCb& cb) {
+	struct file_open_req* req = new struct file_open_req;
+	req->path = path;
+#ifdef UV_FS_O_RDONLY
+	req->flags = UV_FS_O_RDONLY;
+#else
+	req->flags = O_RDONLY;
+#endif
+#ifdef UV_FS_O_DIRECT
+	if(directIO) req->flags |= UV_FS_O_DIRECT;
+#endif
+	req->forWrite = false;
+	req->cb = cb;
+	req->parent = this;
+	req->fs.data = static_cast<void*>(req);
+	pendingReads++;
+	uv_fs_open(loop, &req->fs, req->path.c_str(), req->flags, 0, FileReader::after_open);
+}
+
+void FileReader::after_open(uv_fs_t* fsReq) {
+	struct file_open_req* req = static_cast<struct file_open_req*>(fsReq->data);
+	int result = (int)fsReq->result;
+	uv_fs_req_cleanup(fsReq);
+#ifdef UV_FS_O_DIRECT
+	if(result == UV_EINVAL && UV_FS_O_DIRECT && (req->flags & UV_FS_O_DIRECT)) {
+		// filesystem doesn't support direct I/O (e.g. tmpfs), so fall back to a regular open
+		req->flags &= ~UV_FS_O_DIRECT;
+		uv_fs_open(req->parent->loop, &req->fs, req->path.c_str(), req->flags, 0, FileReader::after_open);
+		return;
+	}
+#endif
+#ifdef F_NOCACHE
+	// macOS has no O_DIRECT, but can disable caching on the descriptor
+	if(result >= 0 && req->parent->directIO && !req->forWrite)
+		fcntl(result, F_NOCACHE, 1);
+#endif
+	if(result >= 0 && req->parent->method == FILE_READER_MMAP && !req->forWrite) {
+		int err = req->parent->map_file(result);
+		if(err) {
+			uv_fs_t closeReq;
+			uv_fs_close(req->parent->loop, &closeReq, result, NULL);
+			uv_fs_req_cleanup(&closeReq);
+			result = err;
+		}
+	}
+	req->parent->pendingReads--;
+	req->cb(result);
+	delete req;
+}
+
+void FileReader::create(const char* path, bool overwrite, const FileReaderOpenCb& cb) {
+	struct file_open_req* req = new struct file_open_req;
+	req->path = path;
+#ifdef UV_FS_O_WRONLY
+	req->flags = UV_FS_O_WRONLY | UV_FS_O_CREAT | (overwrite ? (int)UV_FS_O_TRUNC : (int)UV_FS_O_EXCL);
+#else
+	req->flags = O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : O_EXCL);
+#endif
+	req->forWrite = true;
+	req->cb = cb;
+	req->parent = this;
+	req->fs.data = static_cast<void*>(req);
+	pendingReads++;
+	uv_fs_open(loop, &req->fs, req->path.c_str(), req->flags, 0666, FileReader::after_open);
+}
+
+void FileReader::read(uv_file fd, uint64_t pos, void* buf, size_t len, const FileReaderCb& cb) {
+	struct file_read_req* req = new struct file_read_req;
+	req->fd = fd;
+	req->pos = pos;
+	req->buf = static_cast<char*>(buf);
+	req->len = len;
+	req->done = 0;
+	req->result = 0;
+	req->worker = 0;
+	req->isWrite = false;
+	req->direct = directIO;
+	req->userBuf = nullptr;
+	req->userLen = 0;
+	req->bounceSkip = 0;
+	req->cb = cb;
+	req->parent = this;
+	pendingReads++;
+	
+	if(method == FILE_READER_MMAP) {
+		// mapped files are accessed through map(), which avoids copying the data
+		req->result = UV_ENOTSUP;
+		complete(req);
+		return;
+	}
+	
+	if(directIO && !(IS_DIRECT_ALIGNED(pos) && IS_DIRECT_ALIGNED(len) && IS_DIRECT_ALIGNED((uintptr_t)buf))) {
+		// expand the read to cover aligned boundaries
+		uint64_t alignedPos = pos & ~(uint64_t)(FILE_READER_DIRECT_ALIGN-1);
+		uint64_t alignedEnd = (pos + len + FILE_READER_DIRECT_ALIGN-1) & ~(uint64_t)(FILE_READER_DIRECT_ALIGN-1);
+		req->userBuf = req->buf;
+		req->userLen = len;
+		req->bounceSkip = (size_t)(pos - alignedPos);
+		req->pos = alignedPos;
+		req->len = (size_t)(alignedEnd - alignedPos);
+		req->buf = bounce_get(req->len);
+		if(!req->buf) {
+			req->result = UV_ENOMEM;
+			complete(req);
+			return;
+		}
+	}
+	submit(req);
+}
+
+void FileReader::write(uv_file fd, uint64_t pos, const std::vector<uv_buf_t>& bufs, const FileReaderCb& cb) {
+	struct file_read_req* req = new struct file_read_req;
+	req->fd = fd;
+	req->pos = pos;
+	req->buf = nullptr;
+	req->len = 0;
+	for(const auto& buf : bufs)
+		req->len += buf.len;
+	req->done = 0;
+	req->result = 0;
+	req->worker = 0;
+	req->isWrite = true;
+	req->direct = false;
+	req->userBuf = nullptr;
+	req->userLen = 0;
+	req->bounceSkip = 0;
+	req->bufs = bufs;
+	req->cb = cb;
+	req->parent = this;
+	pendingReads++;
+	
+	if(method == FILE_READER_MMAP) {
+		req->result = UV_ENOTSUP;
+		complete(req);
+		return;
+	}
+	submit(req);
+}
+
+static int allocate_file(uv_file fd, uint64_t size) {
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+	// NTFS allocates space when the end of file is set
+	HANDLE hFile = (HANDLE)_get_osfhandle(fd);
+	FILE_END_OF_FILE_INFO eof;
+	eof.EndOfFile.QuadPart = (LONGLONG)size;
+	if(!SetFileInformationByHandle(hFile, FileEndOfFileInfo, &eof, sizeof(eof)))
+		return uv_translate_sys_error(GetLastError());
+	return 0;
+#else
+# if defined(__linux__)
+	if(fallocate(fd, 0, 0, (off_t)size) == 0) return 0;
+	if(errno != EOPNOTSUPP && errno != ENOSYS) return -errno;
+# elif defined(F_PREALLOCATE)
+	// macOS' preallocation doesn't change the file size, so this is always followed by a truncate
+	fstore_t store;
+	memset(&store, 0, sizeof(store));
+	store.fst_flags = F_ALLOCATECONTIG;
+	store.fst_posmode = F_PEOFPOSMODE;
+	store.fst_length = (off_t)size;
+	if(fcntl(fd, F_PREALLOCATE, &store) == -1) {
+		store.fst_flags = F_ALLOCATEALL;
+		fcntl(fd, F_PREALLOCATE, &store);
+	}
+# endif
+	// filesystem can't preallocate, so just extend the file
+	if(ftruncate(fd, (off_t)size)) return -errno;
+	return 0;
+#endif
+}
+
+void FileReader::allocate(uv_file fd, uint64_t size, const FileReaderStatusCb& cb) {
+	// this is a one-off per file, so just use libuv's threadpool
+	struct file_alloc_req* req = new struct file_alloc_req;
+	req->fd = fd;
+	req->size = size;
+	req->result = 0;
+	req->cb = cb;
+	req->parent = this;
+	req->work.data = static_cast<void*>(req);
+	pendingReads++;
+	uv_queue_work(loop, &req->work, [](uv_work_t* work) {
+		struct file_alloc_req* req = static_cast<struct file_alloc_req*>(work->data);
+		req->result = allocate_file(req->fd, req->size);
+	}, [](uv_work_t* work, int) {
+		struct file_alloc_req* req = static_cast<struct file_alloc_req*>(work->data);
+		req->parent->pendingReads--;
+		req->cb(req->result);
+		delete req;
+	});
+}
+
+void FileReader::submit(struct file_read_req* req) {
+#ifdef FILE_READER_HAS_URING
+	if(method == FILE_READER_URING) {
+		if(ringInFlight < ringEntries) {
+			submit_uring(req);
+			enter_uring();
+		} else
+			ringBacklog.push(req);
+		return;
+	}
+#endif
+	submit_pread(req);
+}
+
+// called once the read has finished, from whichever thread performed it
+void FileReader::finish_req(struct file_read_req* req) {
+	if(req->result < 0) return;
+	if(req->isWrite) {
+		// writes should never be short
+		req->result = req->done < req->len ? (int64_t)UV_EIO : (int64_t)req->done;
+		return;
+	}
+	req->result = req->done;
+	if(req->userBuf) {
+		size_t copyLen = req->done > req->bounceSkip ? req->done - req->bounceSkip : 0;
+		if(copyLen > req->userLen) copyLen = req->userLen;
+		memcpy(req->userBuf, req->buf + req->bounceSkip, copyLen);
+		req->result = copyLen;
+	}
+}
+
+char* FileReader::bounce_get(size_t size) {
+	for(auto it = bounceBufs.begin(); it != bounceBufs.end(); ++it) {
+		if(it->second >= size) {
+			char* buf = it->first;
+			bounceBufs.erase(it);
+			return buf;
+		}
+	}
+	char* buf;
+	ALIGN_ALLOC(buf, size, FILE_READER_DIRECT_ALIGN);
+	return buf;
+}
+void FileReader::bounce_put(char* buf, size_t size) {
+	// only keep around as many buffers as could be in use at once
+	if(bounceBufs.size() >= queueDepth) {
+		ALIGN_FREE(buf);
+		return;
+	}
+	bounceBufs.push_back(std::make_pair(buf, size));
+}
+
+void FileReader::complete(struct file_read_req* req) {
+	pendingReads--;
+	if(req->userBuf && req->buf)
+		bounce_put(req->buf, req->len);
+	req->cb(req->result);
+	delete req;
+}
+
+// drops a request without invoking its callback; only used when tearing down with I/O still outstanding
+void FileReader::abandon(struct file_read_req* req) {
+	pendingReads--;
+	if(req->userBuf && req->buf)
+		ALIGN_FREE(req->buf);
+	delete req;
+}
+
+void FileReader::deinit() {
+	if(!loop) return;
+
+	// MessageThread's destructor waits for the thread to exit, after it has worked through any requests queued to it, so no worker can still be writing into a buffer past this point
+	workers.clear();
+	workerPending.clear();
+	void* req;
+	while(_queueDone.trypop(&req))
+		abandon(static_cast<struct file_read_req*>(req));
+	_queueDone.close();
+	for(auto& bounce : bounceBufs)
+		ALIGN_FREE(bounce.first);
+	bounceBufs.clear();
+	// views handed out may still be referenced, in which case the mapping will be freed when they're released
+	for(auto& mapping : mappings)
+		unref_mapping(mapping.second);
+	mappings.clear();
+#ifdef FILE_READER_HAS_URING
+	deinit_uring();
+#endif
+	loop = nullptr;
+}
+
+
+/** memory mapped input **/
+#ifdef FILE_READER_HAS_MMAP
+int FileReader::map_file(uv_file fd) {
+	// the caller closes files itself, so if a descriptor is reused, the old file must have been closed
+	unmap_file(fd);
+
+	struct stat st;
+	if(fstat(fd, &st)) return -errno;
+	// empty files can't be mapped, but also never need to be read
+	if(st.st_size <= 0) return 0;
+	if((uint64_t)st.st_size > (uint64_t)SIZE_MAX) return UV_EFBIG;
+
+	size_t size = (size_t)st.st_size;
+	void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if(base == MAP_FAILED) return -errno;
+# ifdef MADV_SEQUENTIAL
+	// aggressive readahead for sequential passes; chunked passes only ever touch small pieces of each slice
+	madvise(base, size, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+# endif
+
+	struct file_mapping* mapping = new struct file_mapping;
+	mapping->base = static_cast<char*>(base);
+	mapping->size = size;
+	mapping->refs = 1;
+	mapping->lastEnd = 0;
+	mapping->dropPos = 0;
+	mappings[fd] = mapping;
+	return 0;
+}
+
+void FileReader::unmap_file(uv_file fd) {
+	auto it = mappings.find(fd);
+	if(it == mappings.end()) return;
+	unref_mapping(it->second);
+	mappings.erase(it);
+}
+
+const char* FileReader::map(uv_file fd, uint64_t pos, size_t& len, struct file_mapping*& mapping) {
+	auto it = mappings.find(fd);
+	if(it == mappings.end()) return NULL;
+	mapping = it->second;
+	if(pos >= mapping->size) len = 0;
+	else if(len > mapping->size - pos) len = (size_t)(mapping->size - pos);
+
+	if(len) {
+		static size_t pageSize = 0;
+		if(!pageSize) pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		size_t pageMask = ~(pageSize-1);
+		bool isSequential = (pos == mapping->lastEnd);
+
+# ifdef MADV_WILLNEED
+		// start faulting in the requested range, plus the following window if reading sequentially, so that the consumer (hasher or GF transfer thread) is less likely to stall on a page fault
+		size_t adviseStart = (size_t)pos & pageMask;
+		size_t adviseEnd = (size_t)pos + (isSequential ? len*2 : len);
+		if(adviseEnd > mapping->size) adviseEnd = mapping->size;
+		madvise(mapping->base + adviseStart, adviseEnd - adviseStart, MADV_WILLNEED);
+# endif
+# ifdef MADV_DONTNEED
+		// release pages well behind the cursor, so that mapped pages don't build up in our RSS; this is lagged by a window, as data behind the cursor may still be in use
+		// for a read-only shared mapping, this doesn't evict anything from the page cache, and any data still in use simply gets faulted back in
+		if(isSequential && pos > len) {
+			uint64_t dropEnd = (pos - len) & pageMask;
+			if(dropEnd > mapping->dropPos) {
+				madvise(mapping->base + mapping->dropPos, (size_t)(dropEnd - mapping->dropPos), MADV_DONTNEED);
+				mapping->dropPos = dropEnd;
+			}
+		}
+# endif
+	}
+	mapping->lastEnd = pos + len;
+	mapping->refs++;
+	return mapping->base + pos;
+}
+
+void FileReader::unref_mapping(struct file_mapping* mapping) {
+	if(--mapping->refs) return;
+	munmap(mapping->base, mapping->size);
+	delete mapping;
+}
+#else
+int FileReader::map_file(uv_file) {
+	return UV_ENOSYS;
+}
+void FileReader::unmap_file(uv_file) {}
+const char* FileReader::map(uv_file, uint64_t, size_t&, struct file_mapping*&) {
+	return NULL;
+}
+void FileReader::unref_mapping(struct file_mapping*) {}
+#endif
+
+
+/** pread threadpool **/
+bool FileReader::init_pread() {
+	unsigned numThreads = MIN(queueDepth, FILE_READER_MAX_THREADS);
+	workers.clear();
+	workers.reserve(numThreads);
+	for(unsigned i=0; i<numThreads; i++) {
+		workers.emplace_back(FileReader::pread_worker);
+		workers.back().name = "parpar_reader";
+	}
+	workerPending.assign(numThreads, 0);
+	return true;
+}
+
+void FileReader::submit_pread(struct file_read_req* req) {
+	// send to the least busy thread
+	unsigned worker = 0;
+	for(unsigned i=1; i<workerPending.size(); i++) {
+		if(workerPending[i] < workerPending[worker])
+			worker = i;
+	}
+	req->worker = worker;
+	workerPending[worker]++;
+	workers[worker].send(req);
+}
+
+void FileReader::pread_worker(ThreadMessageQueue<void*>& q) {
+	struct file_read_req* req;
+	while((req = static_cast<struct file_read_req*>(q.pop())) != NULL) {
+		if(req->isWrite) write_bufs(req);
+		else while(req->done < req->len) {
+			uint64_t pos = req->pos + req->done;
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+			HANDLE hFile = (HANDLE)_get_osfhandle(req->fd);
+			OVERLAPPED ov;
+			memset(&ov, 0, sizeof(ov));
+			ov.Offset = (DWORD)(pos & 0xffffffff);
+			ov.OffsetHigh = (DWORD)(pos >> 32);
+			DWORD bytesRead = 0;
+			DWORD readLen = (DWORD)MIN(req->len - req->done, (size_t)1<<30);
+			if(!ReadFile(hFile, req->buf + req->done, readLen, &bytesRead, &ov)) {
+				DWORD err = GetLastError();
+				if(err != ERROR_HANDLE_EOF)
+					req->result = uv_translate_sys_error(err);
+				break;
+			}
+#else
+			ssize_t bytesRead = pread(req->fd, req->buf + req->done, req->len - req->done, pos);
+			if(bytesRead < 0) {
+				if(errno == EINTR) continue;
+				req->result = -errno;
+				break;
+			}
+#endif
+			if(bytesRead == 0) break; // EOF
+			req->done += bytesRead;
+			// a partial direct read means we hit EOF; the file position is no longer aligned, so we can't continue anyway
+			if(req->direct && !IS_DIRECT_ALIGNED(bytesRead)) break;
+		}
+		finish_req(req);
+
+		req->parent->_queueDone.notify(req);
+	}
+}
+
+// determines the buffers left to be written, after `done` bytes have been written
+void FileReader::pending_write_bufs(struct file_read_req* req) {
+	req->pendingBufs.clear();
+	size_t skip = req->done;
+	for(const auto& buf : req->bufs) {
+		if(skip >= buf.len) {
+			skip -= buf.len;
+			continue;
+		}
+		uv_buf_t pending;
+		pending.base = buf.base + skip;
+		pending.len = buf.len - skip;
+		req->pendingBufs.push_back(pending);
+		skip = 0;
+		if(req->pendingBufs.size() >= IOV_MAX) break;
+	}
+}
+
+void FileReader::write_bufs(struct file_read_req* req) {
+	while(req->done < req->len) {
+		pending_write_bufs(req);
+		uint64_t pos = req->pos + req->done;
+#if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
+		// no gather writes for regular files on Windows, so write each buffer separately
+		const uv_buf_t& buf = req->pendingBufs[0];
+		HANDLE hFile = (HANDLE)_get_osfhandle(req->fd);
+		OVERLAPPED ov;
+		memset(&ov, 0, sizeof(ov));
+		ov.Offset = (DWORD)(pos & 0xffffffff);
+		ov.OffsetHigh = (DWORD)(pos >> 32);
+		DWORD written = 0;
+		if(!WriteFile(hFile, buf.base, (DWORD)MIN((size_t)buf.len, (size_t)1<<30), &written, &ov)) {
+			req->result = uv_translate_sys_error(GetLastError());
+			break;
+		}
+#else
+# ifdef __APPLE__
+		// pwritev is only available on macOS 11 onwards
+		const uv_buf_t& buf = req->pendingBufs[0];
+		ssize_t written = pwrite(req->fd, buf.base, buf.len, (off_t)pos);
+# else
+		// uv_buf_t is compatible with struct iovec on POSIX platforms
+		ssize_t written = pwritev(req->fd, reinterpret_cast<const struct iovec*>(req->pendingBufs.data()), (int)req->pendingBufs.size(), (off_t)pos);
+# endif
+		if(written < 0) {
+			if(errno == EINTR) continue;
+			req->result = -errno;
+			break;
+		}
+#endif
+		if(written == 0) {
+			req->result = UV_EIO;
+			break;
+		}
+		req->done += written;
+	}
+}
+
+void FileReader::_notifyDone(void* _req) {
+	struct file_read_req* req = static_cast<struct file_read_req*>(_req);
+	workerPending[req->worker]--;
+	complete(req);
+}
+
+
+/** io_uring **/
+#ifdef FILE_READER_HAS_URING
+// liburing isn't available everywhere, so use the syscalls directly
+static inline int uring_setup(unsigned entries, struct io_uring_params* p) {
+	return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+static inline int uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+	return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+static inline int uring_register(int fd, unsigned opcode, void* arg, unsigned nrArgs) {
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+bool FileReader::init_uring() {
+	unsigned entries = 1;
+	while(entries < queueDepth && entries < FILE_READER_MAX_URING_ENTRIES)
+		entries <<= 1;
+
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	ringFd = uring_setup(entries, &p);
+	if(ringFd < 0) { // not supported by kernel, or blocked by seccomp policy
+		ringFd = -1;
+		return false;
+	}
+	ringEntries = p.sq_entries;
+
+	sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	bool singleMmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if(singleMmap) {
+		if(cqRingSize > sqRingSize) sqRingSize = cqRingSize;
+		cqRingSize = sqRingSize;
+	}
+	sqRingPtr = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if(sqRingPtr == MAP_FAILED) {
+		sqRingPtr = nullptr;
+		deinit_uring();
+		return false;
+	}
+	if(singleMmap)
+		cqRingPtr = sqRingPtr;
+	else {
+		cqRingPtr = mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+		if(cqRingPtr == MAP_FAILED) {
+			cqRingPtr = nullptr;
+			deinit_uring();
+			return false;
+		}
+	}
+	sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+	sqes = static_cast<struct io_uring_sqe*>(mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+	if(sqes == MAP_FAILED) {
+		sqes = nullptr;
+		deinit_uring();
+		return false;
+	}
+
+	char* sq = static_cast<char*>(sqRingPtr);
+	char* cq = static_cast<char*>(cqRingPtr);
+	sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+	sqMask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+	sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+	cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+	cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+	cqMask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+	cqes = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+
+	// completions are signalled via an eventfd, which is polled on the event loop
+	ringEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(ringEventFd < 0 || uring_register(ringFd, IORING_REGISTER_EVENTFD, &ringEventFd, 1) < 0) {
+		deinit_uring();
+		return false;
+	}
+	ringPoll = new uv_poll_t;
+	if(uv_poll_init(loop, ringPoll, ringEventFd)) {
+		delete ringPoll;
+		ringPoll = nullptr;
+		deinit_uring();
+		return false;
+	}
+	ringPoll->data = static_cast<void*>(this);
+	uv_poll_start(ringPoll, UV_READABLE, [](uv_poll_t* handle, int, int) {
+		static_cast<FileReader*>(handle->data)->reap_uring();
+	});
+
+	ringInFlight = 0;
+	ringUnsubmitted = 0;
+	return true;
+}
+
+void FileReader::deinit_uring() {
+	if(sqes && cqRingPtr) {
+		// anything not yet handed to the kernel can just be dropped
+		unsigned tail = *sqTail;
+		for(unsigned i=ringUnsubmitted; i; i--)
+			abandon(reinterpret_cast<struct file_read_req*>(static_cast<uintptr_t>(sqes[(tail - i) & *sqMask].user_data)));
+		ringInFlight -= ringUnsubmitted;
+		ringUnsubmitted = 0;
+		while(!ringBacklog.empty()) {
+			abandon(ringBacklog.front());
+			ringBacklog.pop();
+		}
+		// ...but submitted I/O must be waited on, otherwise the kernel may still write into buffers after they've been freed
+		while(ringInFlight) {
+			unsigned head = *cqHead;
+			unsigned cqTailPos = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+			if(head == cqTailPos) {
+				if(uring_enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+					break;
+				continue;
+			}
+			for(; head != cqTailPos; head++) {
+				struct io_uring_cqe* cqe = cqes + (head & *cqMask);
+				abandon(reinterpret_cast<struct file_read_req*>(static_cast<uintptr_t>(cqe->user_data)));
+				ringInFlight--;
+			}
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+		}
+	}
+	ringInFlight = 0;
+	if(ringPoll) {
+		uv_poll_stop(ringPoll);
+		uv_close(reinterpret_cast<uv_handle_t*>(ringPoll), [](uv_handle_t* handle) {
+			delete reinterpret_cast<uv_poll_t*>(handle);
+		});
+		ringPoll = nullptr;
+	}
+	if(ringEventFd >= 0) {
+		close(ringEventFd);
+		ringEventFd = -1;
+	}
+	if(sqes) munmap(sqes, sqesSize);
+	if(cqRingPtr && cqRingPtr != sqRingPtr) munmap(cqRingPtr, cqRingSize);
+	if(sqRingPtr) munmap(sqRingPtr, sqRingSize);
+	sqes = nullptr;
+	sqRingPtr = cqRingPtr = nullptr;
+	if(ringFd >= 0) {
+		close(ringFd);
+		ringFd = -1;
+	}
+	ringEntries = 0;
+}
+
+void FileReader::submit_uring(struct file_read_req* req) {
+	unsigned tail = *sqTail;
+	unsigned idx = tail & *sqMask;
+	struct io_uring_sqe* sqe = sqes + idx;
+
+	memset(sqe, 0, sizeof(*sqe));
+	if(req->isWrite) {
+		pending_write_bufs(req);
+		sqe->opcode = IORING_OP_WRITEV;
+		sqe->addr = reinterpret_cast<uintptr_t>(req->pendingBufs.data());
+		sqe->len = (unsigned)req->pendingBufs.size();
+	} else {
+		// READV is used over READ, as the latter requires kernel 5.6
+		req->iov.iov_base = req->buf + req->done;
+		req->iov.iov_len = req->len - req->done;
+		sqe->opcode = IORING_OP_READV;
+		sqe->addr = reinterpret_cast<uintptr_t>(&req->iov);
+		sqe->len = 1;
+	}
+	sqe->fd = req->fd;
+	sqe->off = req->pos + req->done;
+	sqe->user_data = reinterpret_cast<uintptr_t>(req);
+	sqArray[idx] = idx;
+
+	__atomic_store_n(sqTail, tail+1, __ATOMIC_RELEASE);
+	ringInFlight++;
+	ringUnsubmitted++;
+}
+
+void FileReader::enter_uring() {
+	unsigned retries = 0;
+	while(ringUnsubmitted) {
+		int ret = uring_enter(ringFd, ringUnsubmitted, 0, 0);
+		if(ret > 0) {
+			ringUnsubmitted -= ret;
+			retries = 0;
+			continue;
+		}
+		int err = ret < 0 ? errno : EAGAIN;
+		if(err == EINTR) continue;
+		if(err == EAGAIN || err == EBUSY) {
+			// kernel is out of resources; if other I/O is outstanding, the remainder is submitted once its completions are reaped
+			if(ringInFlight > ringUnsubmitted) return;
+			// ...otherwise nothing would trigger a resubmit, so back off and try again here
+			if(++retries < FILE_READER_URING_RETRIES) {
+				usleep(1000);
+				continue;
+			}
+		}
+		fail_unsubmitted(-err);
+		return;
+	}
+}
+
+// pulls back everything not yet consumed by the kernel, and fails it with `err`
+void FileReader::fail_unsubmitted(int err) {
+	// the kernel only reads the submission queue during io_uring_enter, so entries past what it consumed can be taken back
+	unsigned tail = *sqTail;
+	std::vector<struct file_read_req*> failed;
+	failed.reserve(ringUnsubmitted);
+	for(unsigned i=ringUnsubmitted; i; i--) {
+		struct file_read_req* req = reinterpret_cast<struct file_read_req*>(static_cast<uintptr_t>(sqes[(tail - i) & *sqMask].user_data));
+		req->result = err;
+		failed.push_back(req);
+	}
+	__atomic_store_n(sqTail, tail - ringUnsubmitted, __ATOMIC_RELEASE);
+	ringInFlight -= ringUnsubmitted;
+	ringUnsubmitted = 0;
+
+	for(auto req : failed)
+		complete(req);
+}
+
+void FileReader::reap_uring() {
+	uint64_t evCount;
+	(void)!::read(ringEventFd, &evCount, sizeof(evCount));
+
+	std::vector<struct file_read_req*> done;
+	unsigned head = *cqHead;
+	unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+	while(head != tail) {
+		struct io_uring_cqe* cqe = cqes + (head & *cqMask);
+		struct file_read_req* req = reinterpret_cast<struct file_read_req*>(static_cast<uintptr_t>(cqe->user_data));
+		int res = cqe->res;
+		head++;
+		ringInFlight--;
+
+		if(res == -EINTR || res == -EAGAIN) {
+			ringBacklog.push(req);
+		} else if(res < 0) {
+			req->result = res; // on Linux, libuv error codes are negated errno values
+			done.push_back(req);
+		} else {
+			req->done += res;
+			if(res == 0 || req->done >= req->len || (req->direct && !IS_DIRECT_ALIGNED(res))) {
+				finish_req(req);
+				done.push_back(req);
+			} else // short read, request the remainder
+				ringBacklog.push(req);
+		}
+	}
+	__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+	while(!ringBacklog.empty() && ringInFlight < ringEntries) {
+		submit_uring(ringBacklog.front());
+		ringBacklog.pop();
+	}
+	enter_uring();
+
+	for(auto req : done)
+		complete(req);
+}
+#endif
@@ -0,0 +1,199 @@
+#ifndef __FILE_READER_H
+#define __FILE_READER_H
+
+#include "stdint.h"
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+#include <string>
+#include <uv.h>
+#include "../gf16/threadqueue.h"
+
+#if defined(__linux__) && defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  ifdef __NR_io_uring_setup
+#   define FILE_READER_HAS_URING 1
+#  endif
+# endif
+#endif
+#if !defined(_WINDOWS) && !defined(__WINDOWS__) && !defined(_WIN32) && !defined(_WIN64)
+# define FILE_READER_HAS_MMAP 1
+#endif
+
+// result is the number of bytes read (which will only be short at EOF), or a negative libuv error code
+typedef std::function<void(int64_t)> FileReaderCb;
+// result is the file descriptor, or a negative libuv error code
+typedef std::function<void(int)> FileReaderOpenCb;
+// result is 0, or a negative libuv error code
+typedef std::function<void(int)> FileReaderStatusCb;
+
+// O_DIRECT requires the file offset, length and memory address to be aligned to the device's logical block size; 4KB covers all common devices
+#define FILE_READER_DIRECT_ALIGN 4096
+
+enum FileReaderMethods {
+	FILE_READER_AUTO,
+	FILE_READER_PREAD,
+	FILE_READER_URING,
+	FILE_READER_MMAP
+};
+static const char* FileReaderMethodsText[] = {
+	"Auto",
+	"Thread pool",
+	"io_uring",
+	"Memory mapped"
+};
+
+class FileReader;
+struct file_read_req {
+	uv_file fd;
+	uint64_t pos;
+	char* buf;
+	size_t len;
+	size_t done;
+	int64_t result;
+	unsigned worker;
+	bool isWrite;
+	bool direct;
+	// if the caller's buffer cannot be used for direct I/O, the read goes into an aligned bounce buffer and is copied across afterwards
+	char* userBuf;
+	size_t userLen;
+	size_t bounceSkip;
+#ifdef FILE_READER_HAS_URING
+	struct iovec iov;
+#endif
+	// for writes, the list of buffers to write out (`buf` is unused)
+	std::vector<uv_buf_t> bufs;
+	std::vector<uv_buf_t> pendingBufs; // what's left of `bufs` after the last partial write
+	FileReaderCb cb;
+	FileReader* parent;
+};
+// a mapping stays alive whilst the file is open, or any views into it are still referenced
+struct file_mapping {
+	char* base;
+	size_t size;
+	unsigned refs;
+	// used to detect sequential access, and track how much has been dropped behind the cursor
+	uint64_t lastEnd;
+	uint64_t dropPos;
+};
+struct file_open_req {
+	uv_fs_t fs;
+	std::string path;
+	int flags;
+	bool forWrite;
+	FileReaderOpenCb cb;
+	FileReader* parent;
+};
+struct file_alloc_req {
+	uv_work_t work;
+	uv_file fd;
+	uint64_t size;
+	int result;
+	FileReaderStatusCb cb;
+	FileReader* parent;
+};
+
+// reads from files asynchronously, bypassing libuv's threadpool, so that queue depth isn't limited by UV_THREADPOOL_SIZE
+// also handles output writes, using the same backends
+class FileReader {
+	uv_loop_t* loop; // is NULL when closed
+	FileReaderMethods method;
+	unsigned queueDepth;
+	unsigned pendingReads;
+	bool directIO;
+	bool sequential;
+	
+	// pool of aligned buffers for unaligned direct reads
+	std::vector<std::pair<char*, size_t>> bounceBufs;
+	char* bounce_get(size_t size);
+	void bounce_put(char* buf, size_t size);
+	static void finish_req(struct file_read_req* req);
+	static void after_open(uv_fs_t* fsReq);
+	static void pending_write_bufs(struct file_read_req* req);
+	static void write_bufs(struct file_read_req* req);
+	void submit(struct file_read_req* req);
+
+	// pread threadpool
+	std::vector<MessageThread> workers;
+	std::vector<unsigned> workerPending;
+	ThreadNotifyQueue<FileReader> _queueDone;
+	static void pread_worker(ThreadMessageQueue<void*>& q);
+	void _notifyDone(void* _req);
+	bool init_pread();
+	void submit_pread(struct file_read_req* req);
+
+#ifdef FILE_READER_HAS_URING
+	int ringFd;
+	int ringEventFd;
+	uv_poll_t* ringPoll;
+	void* sqRingPtr;
+	void* cqRingPtr;
+	size_t sqRingSize, cqRingSize;
+	struct io_uring_sqe* sqes;
+	size_t sqesSize;
+	unsigned *sqTail, *sqMask, *sqArray;
+	unsigned *cqHead, *cqTail, *cqMask;
+	struct io_uring_cqe* cqes;
+	unsigned ringEntries, ringInFlight, ringUnsubmitted;
+	std::queue<struct file_read_req*> ringBacklog;
+	bool init_uring();
+	void deinit_uring();
+	void submit_uring(struct file_read_req* req);
+	void enter_uring();
+	void fail_unsubmitted(int err);
+	void reap_uring();
+#endif
+
+	// memory mapped input; keyed by file descriptor, as the caller closes files itself
+	std::unordered_map<uv_file, struct file_mapping*> mappings;
+	int map_file(uv_file fd);
+	void unmap_file(uv_file fd);
+
+	void complete(struct file_read_req* req);
+	void abandon(struct file_read_req* req);
+
+	// disable copy constructor
+	FileReader(const FileReader&);
+	FileReader& operator=(const FileReader&);
+
+public:
+	explicit FileReader(uv_loop_t* _loop);
+	~FileReader();
+	// `_sequential` only serves as an access pattern hint for memory mapped input
+	bool init(FileReaderMethods _method, unsigned _queueDepth, bool _directIO = false, bool _sequential = true);
+	void open(const char* path, const FileReaderOpenCb& cb);
+	// not supported for memory mapped input, which is accessed via `map` instead
+	void read(uv_file fd, uint64_t pos, void* buf, size_t len, const FileReaderCb& cb);
+	// opens a file for writing, creating it if necessary; unless `overwrite` is set, fails if the file already exists
+	void create(const char* path, bool overwrite, const FileReaderOpenCb& cb);
+	// gather write; `bufs` must remain valid until the callback is invoked, which receives the number of bytes written
+	void write(uv_file fd, uint64_t pos, const std::vector<uv_buf_t>& bufs, const FileReaderCb& cb);
+	// reserves disk space for the file and extends it to `size` bytes
+	void allocate(uv_file fd, uint64_t size, const FileReaderStatusCb& cb);
+	// for memory mapped input, returns a pointer to the file's data instead of copying it; a reference is added to `mapping`, which must be released via `unref_mapping` once done
+	// returns NULL if the file isn't mapped; `len` is truncated at EOF
+	const char* map(uv_file fd, uint64_t pos, size_t& len, struct file_mapping*& mapping);
+	static void unref_mapping(struct file_mapping* mapping);
+	void deinit();
+
+	inline FileReaderMethods getMethod() const {
+		return method;
+	}
+	inline unsigned getQueueDepth() const {
+		return queueDepth;
+	}
+	inline unsigned getPending() const {
+		return pendingReads;
+	}
+	inline bool isDirectIO() const {
+		return directIO;
+	}
+	static inline const char* methodToText(FileReaderMethods m) {
+		return FileReaderMethodsText[(int)m];
+	}
+};
+
+#endif
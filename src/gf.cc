@@ -14,6 +14,7 @@
 #include <v8.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <uv.h>
 #include <node_object_wrap.h>
 
@@ -26,6 +27,8 @@
 #include "../gf16/controller_ocl.h"
 #include "../gf16/threadqueue.h"
 #include "../hasher/hasher.h"
+#include "file_reader.h"
+#include "cpu_cores.h"
 
 
 using namespace v8;
@@ -214,14 +217,46 @@ struct CallbackWrapper {
 };
 
 
+struct GfCpuSpec {
+	size_t sliceOffset, sliceSize;
+	unsigned recOffset, recCount;
+	
+	Galois16Methods method;
+	unsigned inputGrouping, inputMinGrouping;
+	size_t chunkLen;
+	int threads;
+	std::vector<int> cpus;
+	std::vector<int> transferCpus;
+};
 struct GfOclSpec {
 	int platformId, deviceId;
 	size_t sliceOffset, sliceSize;
+	unsigned recOffset, recCount;
 	
 	Galois16OCLMethods method;
 	Galois16Methods cksumMethod;
-	unsigned inputGrouping, inputMinGrouping, targetIters, targetGrouping;
+	unsigned inputGrouping, inputMinGrouping, targetIters, targetGrouping, targetWorkGroup;
+	size_t maxAlloc;
+	std::string cacheDir;
+	bool trace;
+	bool zeroCopy;
 };
+// reads an optional list of CPU indices, as used for thread affinity
+static bool CpuListFromJS(
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	  Isolate* isolate,
+#endif
+	  Local<Value> v, std::vector<int>& cpus) {
+	if(v->IsUndefined() || v->IsNull()) return true;
+	if(!v->IsArray()) return false;
+	Local<Array> list = Local<Array>::Cast(v);
+	for(unsigned i=0; i<list->Length(); i++) {
+		int cpu = ARG_TO_NUM(Int32, GET_ARR(list, i));
+		if(cpu < 0) return false;
+		cpus.push_back(cpu);
+	}
+	return true;
+}
 static bool load_ocl() {
 	static bool oclLoaded = false;
 	if(!oclLoaded) {
@@ -245,6 +280,7 @@ public:
 		NODE_SET_PROTOTYPE_METHOD(t, "setNumThreads", SetNumThreads);
 		NODE_SET_PROTOTYPE_METHOD(t, "setProgressCb", SetProgressCb);
 		NODE_SET_PROTOTYPE_METHOD(t, "info", GetInfo);
+		NODE_SET_PROTOTYPE_METHOD(t, "oclTrace", GetOclTrace);
 		NODE_SET_PROTOTYPE_METHOD(t, "add", AddSlice);
 		NODE_SET_PROTOTYPE_METHOD(t, "end", EndInput);
 		NODE_SET_PROTOTYPE_METHOD(t, "get", GetOutputSlice);
@@ -263,39 +299,54 @@ public:
 			RETURN_ERROR("Slice size is invalid");
 		
 		
-		bool useCpu = true;
 		int stagingAreas = 2;
-		int cpuMethod = GF16_AUTO;
-		unsigned cpuInputGrouping = 0, cpuInputMinGrouping = 0;
-		size_t cpuChunkLen = 0;
-		size_t cpuOffset = 0, cpuSliceSize = sliceSize;
 #define ASSIGN_INT_VAL(prop, key, var, type) \
 	if(OBJ_HAS(prop, key)) { \
 		Local<Value> v = GET_OBJ(prop, key); \
 		if(!v->IsUndefined() && !v->IsNull()) \
 			var = ARG_TO_NUM(type, v); \
 	}
-		if(args.Length() >= 2) { // CPU processing props
-			if(args[1]->IsNull()) {
-				useCpu = false;
-				cpuSliceSize = 0;
+		std::vector<struct GfCpuSpec> useCpu;
+		if(args.Length() < 2 || !args[1]->IsNull()) { // CPU processing props
+			// accepts a single set of props, or an array of them to run multiple CPU backends (e.g. one per core type)
+			std::vector<Local<Object>> cpuProps;
+			if(args.Length() >= 2 && args[1]->IsArray()) {
+				Local<Array> props = Local<Array>::Cast(args[1]);
+				for(unsigned i=0; i<props->Length(); i++)
+					cpuProps.push_back(ARG_TO_OBJ(GET_ARR(props, i)));
+			} else if(args.Length() >= 2 && !args[1]->IsUndefined()) {
+				cpuProps.push_back(ARG_TO_OBJ(args[1]));
 			} else {
-				Local<Object> prop = ARG_TO_OBJ(args[1]);
-				ASSIGN_INT_VAL(prop, "method", cpuMethod, Int32)
-				// TODO: check validity of cpuMethod
-				ASSIGN_INT_VAL(prop, "input_batchsize", cpuInputGrouping, Uint32)
-				if(cpuInputGrouping > 32768)
+				cpuProps.push_back(NEW_OBJ(Object));
+			}
+			for(const auto& prop : cpuProps) {
+				struct GfCpuSpec spec{0, sliceSize, 0, 0, GF16_AUTO, 0, 0, 0, -1, {}, {}};
+				int method = 0;
+				ASSIGN_INT_VAL(prop, "method", method, Int32)
+				if(method) spec.method = (Galois16Methods)method;
+				// TODO: check validity of method
+				ASSIGN_INT_VAL(prop, "input_batchsize", spec.inputGrouping, Uint32)
+				if(spec.inputGrouping > 32768)
 					RETURN_ERROR("Input batchsize is invalid");
-				ASSIGN_INT_VAL(prop, "input_minbatchsize", cpuInputMinGrouping, Uint32)
-				ASSIGN_INT_VAL(prop, "chunk_size", cpuChunkLen, Uint32)
-				ASSIGN_INT_VAL(prop, "slice_offset", cpuOffset, Integer)
-				if(cpuOffset & 1 || cpuOffset > sliceSize)
+				ASSIGN_INT_VAL(prop, "input_minbatchsize", spec.inputMinGrouping, Uint32)
+				ASSIGN_INT_VAL(prop, "chunk_size", spec.chunkLen, Uint32)
+				ASSIGN_INT_VAL(prop, "slice_offset", spec.sliceOffset, Integer)
+				if(spec.sliceOffset & 1 || spec.sliceOffset > sliceSize)
 					RETURN_ERROR("Invalid CPU slice offset");
-				ASSIGN_INT_VAL(prop, "slice_size", cpuSliceSize, Integer)
-				if(cpuSliceSize < 2 || cpuSliceSize & 1)
+				ASSIGN_INT_VAL(prop, "slice_size", spec.sliceSize, Integer)
+				if(spec.sliceSize < 2 || spec.sliceSize & 1)
 					RETURN_ERROR("CPU slice size must be a multiple of 2");
-				if(cpuOffset+cpuSliceSize > sliceSize)
+				if(spec.sliceOffset+spec.sliceSize > sliceSize)
 					RETURN_ERROR("CPU slice offset+size cannot exceed the slice size");
+				ASSIGN_INT_VAL(prop, "recovery_offset", spec.recOffset, Uint32)
+				ASSIGN_INT_VAL(prop, "recovery_count", spec.recCount, Uint32)
+				ASSIGN_INT_VAL(prop, "threads", spec.threads, Int32)
+				if(OBJ_HAS(prop, "cpus") && !CpuListFromJS(ISOLATE GET_OBJ(prop, "cpus"), spec.cpus))
+					RETURN_ERROR("Invalid CPU list specified");
+				// cores to run the transfer thread on; left unpinned if not specified
+				if(OBJ_HAS(prop, "transfer_cpus") && !CpuListFromJS(ISOLATE GET_OBJ(prop, "transfer_cpus"), spec.transferCpus))
+					RETURN_ERROR("Invalid transfer CPU list specified");
+				useCpu.push_back(spec);
 			}
 		}
 		std::vector<struct GfOclSpec> useOcl;
@@ -303,17 +354,19 @@ public:
 			Local<Array> props = Local<Array>::Cast(args[2]);
 			for(unsigned i=0; i<props->Length(); i++) {
 				Local<Object> prop = ARG_TO_OBJ(GET_ARR(props, i));
-				struct GfOclSpec spec{-1, -1, 0, 0, GF16OCL_AUTO, GF16_AUTO, 0, 0, 0, 0};
+				struct GfOclSpec spec{-1, -1, 0, 0, 0, 0, GF16OCL_AUTO, GF16_AUTO, 0, 0, 0, 0, 0, 0, {}, false, false};
 				// TODO: validate platform/device
 				ASSIGN_INT_VAL(prop, "platform", spec.platformId, Int32)
 				ASSIGN_INT_VAL(prop, "device", spec.deviceId, Int32)
 				ASSIGN_INT_VAL(prop, "slice_size", spec.sliceSize, Integer)
 				ASSIGN_INT_VAL(prop, "slice_offset", spec.sliceOffset, Integer)
+				ASSIGN_INT_VAL(prop, "recovery_offset", spec.recOffset, Uint32)
+				ASSIGN_INT_VAL(prop, "recovery_count", spec.recCount, Uint32)
 				int method = 0;
 				ASSIGN_INT_VAL(prop, "method", method, Int32)
 				if(method) spec.method = (Galois16OCLMethods)method;
 				// TODO: check validity of method
-				spec.cksumMethod = (Galois16Methods)cpuMethod;
+				spec.cksumMethod = useCpu.empty() ? GF16_AUTO : useCpu[0].method;
 				method = 0;
 				ASSIGN_INT_VAL(prop, "cksum_method", method, Int32)
 				if(method) spec.cksumMethod = (Galois16Methods)method;
@@ -325,6 +378,24 @@ public:
 				ASSIGN_INT_VAL(prop, "target_grouping", spec.targetGrouping, Uint32)
 				if(spec.targetGrouping > 65535)
 					RETURN_ERROR("OpenCL target grouping is invalid");
+				ASSIGN_INT_VAL(prop, "target_workgroup", spec.targetWorkGroup, Uint32)
+				ASSIGN_INT_VAL(prop, "max_alloc", spec.maxAlloc, Integer)
+				if(OBJ_HAS(prop, "cache_dir")) {
+					Local<Value> v = GET_OBJ(prop, "cache_dir");
+					if(v->IsString()) {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+						String::Utf8Value dir(isolate, v);
+#else
+						String::Utf8Value dir(v);
+#endif
+						if(*dir) spec.cacheDir = *dir;
+					} else if(!v->IsUndefined() && !v->IsNull())
+						RETURN_ERROR("OpenCL cache directory must be a string");
+				}
+				if(OBJ_HAS(prop, "trace"))
+					spec.trace = GET_OBJ(prop, "trace")->IsTrue();
+				if(OBJ_HAS(prop, "zero_copy"))
+					spec.zeroCopy = GET_OBJ(prop, "zero_copy")->IsTrue();
 				useOcl.push_back(spec);
 			}
 		}
@@ -335,27 +406,30 @@ public:
 		}
 #undef ASSIGN_INT_VAL
 		
-		if(cpuInputGrouping * stagingAreas > 65536)
-			RETURN_ERROR("Staging area too large");
+		for(const auto& cpuSpec : useCpu)
+			if(cpuSpec.inputGrouping * stagingAreas > 65536)
+				RETURN_ERROR("Staging area too large");
 		
 		if(!useOcl.empty()) {
 			if(!load_ocl()) {
 				RETURN_ERROR("Could not load OpenCL runtime");
 			}
-		} else if(!useCpu) {
+		} else if(useCpu.empty()) {
 			RETURN_ERROR("At least the CPU or one OpenCL device must be enabled");
 		}
 		
-		GfProc *self = new GfProc(sliceSize, stagingAreas, cpuOffset, cpuSliceSize, useOcl, getCurrentLoop(ISOLATE 0));
-		size_t usedSliceSize = 0;
-		if(useCpu && !self->init_cpu((Galois16Methods)cpuMethod, cpuInputGrouping, cpuChunkLen)) {
-			delete self;
-			RETURN_ERROR("Failed to allocate memory");
+		GfProc *self = new GfProc(sliceSize, stagingAreas, useCpu, useOcl, getCurrentLoop(ISOLATE 0));
+		int cpuI = 0;
+		for(const auto& cpuSpec : useCpu) {
+			if(!self->init_cpu(cpuI, cpuSpec.method, cpuSpec.inputGrouping, cpuSpec.chunkLen)) {
+				delete self;
+				RETURN_ERROR("Failed to allocate memory");
+			}
+			self->par2cpu[cpuI]->setMinInputBatchSize(cpuSpec.inputMinGrouping);
+			cpuI++;
 		}
-		if(useCpu) self->par2cpu->setMinInputBatchSize(cpuInputMinGrouping);
 		int oclI = 0;
 		for(const auto& oclSpec : useOcl) {
-			usedSliceSize += oclSpec.sliceSize;
 			if(oclSpec.sliceSize == 0 || (oclSpec.sliceSize & 1)) {
 				delete self;
 				RETURN_ERROR("Invalid slice size allocated to OpenCL device");
@@ -368,14 +442,15 @@ public:
 				delete self;
 				RETURN_ERROR("Invalid slice offset+size allocated to OpenCL device");
 			}
-			if(!self->init_ocl(oclI, oclSpec.method, oclSpec.inputGrouping, oclSpec.targetIters, oclSpec.targetGrouping, oclSpec.cksumMethod)) {
+			if(!self->init_ocl(oclI, oclSpec.method, oclSpec.inputGrouping, oclSpec.targetIters, oclSpec.targetGrouping, oclSpec.cksumMethod, oclSpec.targetWorkGroup)) {
 				delete self;
 				RETURN_ERROR("Failed to initialise OpenCL device"); // TODO: add device info
 			}
 			self->par2ocl[oclI]->setMinInputBatchSize(oclSpec.inputMinGrouping);
 			oclI++;
 		}
-		if((useCpu && usedSliceSize >= sliceSize) || (!useCpu && usedSliceSize != sliceSize)) {
+		// backends must cover the whole slice for every recovery slice; ones allocated an identical portion share it dynamically
+		if(!self->allocValid) {
 			delete self;
 			RETURN_ERROR("Slice portions allocated to OpenCL devices is invalid");
 		}
@@ -389,9 +464,10 @@ private:
 	bool isClosed;
 	bool pendingDiscardOutput;
 	bool hasOutput;
+	bool allocValid;
 	CallbackWrapper progressCb;
 	PAR2Proc par2;
-	std::unique_ptr<PAR2ProcCPU> par2cpu;
+	std::vector<std::unique_ptr<PAR2ProcCPU>> par2cpu;
 	std::vector<std::unique_ptr<PAR2ProcOCL>> par2ocl;
 	
 	// disable copy constructor
@@ -498,14 +574,25 @@ protected:
 			RETURN_ERROR("Cannot change params whilst running");
 		if(self->isClosed)
 			RETURN_ERROR("Already closed");
-		if(!self->par2cpu.get())
+		if(self->par2cpu.empty())
 			RETURN_ERROR("CPU processing not enabled");
 		
 		if(args.Length() < 1)
 			RETURN_ERROR("Integer required");
-		self->par2cpu->setNumThreads(ARG_TO_NUM(Int32, args[0]));
+		int threads = ARG_TO_NUM(Int32, args[0]);
+		if(args.Length() >= 2 && !args[1]->IsUndefined() && !args[1]->IsNull()) {
+			int idx = ARG_TO_NUM(Int32, args[1]);
+			if(idx < 0 || idx >= (int)self->par2cpu.size())
+				RETURN_ERROR("Invalid CPU backend index");
+			self->par2cpu[idx]->setNumThreads(threads);
+		} else {
+			// backends pinned to a set of CPUs keep their own thread count
+			for(auto& proc : self->par2cpu)
+				if(self->par2cpu.size() == 1 || proc->getAffinity().empty())
+					proc->setNumThreads(threads);
+		}
 		
-		RETURN_VAL(Integer::New(ISOLATE self->par2cpu->getNumThreads()));
+		RETURN_VAL(Integer::New(ISOLATE self->totalCpuThreads()));
 	}
 	
 	FUNC(SetProgressCb) {
@@ -534,16 +621,63 @@ protected:
 			RETURN_ERROR("setRecoverySlices not yet called");
 		
 		Local<Object> ret = NEW_OBJ(Object);
-		if(self->par2cpu.get()) {
-			SET_OBJ(ret, "threads", Integer::New(ISOLATE self->par2cpu->getNumThreads()));
-			SET_OBJ(ret, "method_desc", NEW_STRING(self->par2cpu->getMethodName()));
-			SET_OBJ(ret, "chunk_size", Number::New(ISOLATE self->par2cpu->getChunkLen()));
-			SET_OBJ(ret, "staging_count", Integer::New(ISOLATE self->par2cpu->getStagingAreas()));
-			SET_OBJ(ret, "staging_size", Integer::New(ISOLATE self->par2cpu->getInputBatchSize()));
-			SET_OBJ(ret, "alignment", Integer::New(ISOLATE self->par2cpu->getAlignment()));
-			SET_OBJ(ret, "stride", Integer::New(ISOLATE self->par2cpu->getStride()));
-			SET_OBJ(ret, "slice_mem", Number::New(ISOLATE self->par2cpu->getAllocSliceSize()));
-			SET_OBJ(ret, "num_output_slices", Integer::New(ISOLATE self->par2cpu->getNumRecoverySlices()));
+		if(!self->par2cpu.empty()) {
+			// if there's multiple CPU backends, each holds a part of every slice, so the top level thread count, slice memory and staging areas are totals across all of them
+			// other fields describe the first backend; `cpu_backends` has the details of each
+			const auto& cpu = self->par2cpu[0];
+			size_t sliceMem = 0;
+			unsigned stagingCount = 0;
+			for(const auto& proc : self->par2cpu) {
+				sliceMem += proc->getAllocSliceSize();
+				stagingCount += proc->getStagingAreas();
+			}
+			SET_OBJ(ret, "threads", Integer::New(ISOLATE self->totalCpuThreads()));
+			SET_OBJ(ret, "method_desc", NEW_STRING(cpu->getMethodName()));
+			SET_OBJ(ret, "chunk_size", Number::New(ISOLATE cpu->getChunkLen()));
+			SET_OBJ(ret, "staging_count", Integer::New(ISOLATE stagingCount));
+			SET_OBJ(ret, "staging_size", Integer::New(ISOLATE cpu->getInputBatchSize()));
+			SET_OBJ(ret, "alignment", Integer::New(ISOLATE cpu->getAlignment()));
+			SET_OBJ(ret, "stride", Integer::New(ISOLATE cpu->getStride()));
+			SET_OBJ(ret, "slice_mem", Number::New(ISOLATE sliceMem));
+			SET_OBJ(ret, "num_output_slices", Integer::New(ISOLATE cpu->getNumRecoverySlices()));
+			uint64_t cacheHits = 0, cacheMisses = 0;
+			bool hasCacheStats = false;
+			for(const auto& proc : self->par2cpu) {
+				uint64_t h, m;
+				if(proc->getCodeCacheStats(h, m)) {
+					cacheHits += h;
+					cacheMisses += m;
+					hasCacheStats = true;
+				}
+			}
+			if(hasCacheStats) {
+				SET_OBJ(ret, "code_cache_hits", Number::New(ISOLATE (double)cacheHits));
+				SET_OBJ(ret, "code_cache_misses", Number::New(ISOLATE (double)cacheMisses));
+			}
+			
+			if(self->par2cpu.size() > 1) {
+				Local<Array> cpuInfo = Array::New(ISOLATE self->par2cpu.size());
+				int i = 0;
+				for(const auto& proc : self->par2cpu) {
+					Local<Object> info = NEW_OBJ(Object);
+					SET_OBJ(info, "threads", Integer::New(ISOLATE proc->getNumThreads()));
+					SET_OBJ(info, "method_desc", NEW_STRING(proc->getMethodName()));
+					SET_OBJ(info, "chunk_size", Number::New(ISOLATE proc->getChunkLen()));
+					SET_OBJ(info, "staging_count", Integer::New(ISOLATE proc->getStagingAreas()));
+					SET_OBJ(info, "staging_size", Integer::New(ISOLATE proc->getInputBatchSize()));
+					SET_OBJ(info, "slice_mem", Number::New(ISOLATE proc->getAllocSliceSize()));
+					SET_OBJ(info, "num_output_slices", Integer::New(ISOLATE proc->getNumRecoverySlices()));
+					const auto& affinity = proc->getAffinity();
+					if(!affinity.empty()) {
+						Local<Array> cpus = Array::New(ISOLATE affinity.size());
+						for(unsigned j=0; j<affinity.size(); j++)
+							SET_ARR(cpus, j, Integer::New(ISOLATE affinity[j]));
+						SET_OBJ(info, "cpus", cpus);
+					}
+					SET_ARR(cpuInfo, i++, info);
+				}
+				SET_OBJ(ret, "cpu_backends", cpuInfo);
+			}
 		}
 		if(!self->par2ocl.empty()) {
 			Local<Array> oclDevInfo = Array::New(ISOLATE self->par2ocl.size());
@@ -559,6 +693,10 @@ protected:
 				SET_OBJ(oclInfo, "output_chunks", Integer::New(ISOLATE proc->getOutputGrouping()));
 				SET_OBJ(oclInfo, "slice_mem", Number::New(ISOLATE proc->getAllocSliceSize()));
 				SET_OBJ(oclInfo, "num_output_slices", Integer::New(ISOLATE proc->getNumRecoverySlices()));
+				SET_OBJ(oclInfo, "zero_copy", Boolean::New(ISOLATE proc->isZeroCopy()));
+				SET_OBJ(oclInfo, "output_buffers", Integer::New(ISOLATE proc->getOutputBuffers()));
+				SET_OBJ(oclInfo, "kernel_build_time", Number::New(ISOLATE proc->getBuildTime()));
+				SET_OBJ(oclInfo, "kernel_cached", Boolean::New(ISOLATE proc->isBuildCached()));
 				SET_ARR(oclDevInfo, i++, oclInfo);
 			}
 			SET_OBJ(ret, "opencl_devices", oclDevInfo);
@@ -567,6 +705,30 @@ protected:
 		RETURN_VAL(ret);
 	}
 	
+	// returns (and clears) commands traced on OpenCL devices, as an array of {device, stage, start, end}; times are in microseconds
+	FUNC(GetOclTrace) {
+		FUNC_START;
+		GfProc* self = node::ObjectWrap::Unwrap<GfProc>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		if(self->isRunning)
+			RETURN_ERROR("Cannot retrieve trace whilst running");
+		
+		Local<Array> ret = Array::New(ISOLATE 0);
+		int i = 0;
+		for(unsigned dev=0; dev<self->par2ocl.size(); dev++) {
+			for(const auto& span : self->par2ocl[dev]->getTrace()) {
+				Local<Object> item = NEW_OBJ(Object);
+				SET_OBJ(item, "device", Integer::New(ISOLATE dev));
+				SET_OBJ(item, "stage", NEW_STRING(span.stage));
+				SET_OBJ(item, "start", Number::New(ISOLATE (double)span.start));
+				SET_OBJ(item, "end", Number::New(ISOLATE (double)span.end));
+				SET_ARR(ret, i++, item);
+			}
+		}
+		RETURN_VAL(ret);
+	}
+	
 	FUNC(AddSlice) {
 		FUNC_START;
 		GfProc* self = node::ObjectWrap::Unwrap<GfProc>(args.This());
@@ -694,20 +856,31 @@ protected:
 		RETURN_UNDEF;
 	}
 	
-	explicit GfProc(size_t sliceSize, int stagingAreas, size_t cpuOffset, size_t cpuSliceSize, std::vector<struct GfOclSpec> useOcl, uv_loop_t* loop)
+	explicit GfProc(size_t sliceSize, int stagingAreas, const std::vector<struct GfCpuSpec>& useCpu, const std::vector<struct GfOclSpec>& useOcl, uv_loop_t* loop)
 	: ObjectWrap(), isRunning(false), isClosed(false), pendingDiscardOutput(true), hasOutput(false) {
 		std::vector<struct PAR2ProcBackendAlloc> procs;
 		for(const auto& spec : useOcl) {
 			auto proc = new PAR2ProcOCL(loop, spec.platformId, spec.deviceId, stagingAreas);
+			proc->setCacheDir(spec.cacheDir);
+			if(spec.trace) proc->setTrace(true);
+			if(spec.maxAlloc) proc->setMaxAllocation(spec.maxAlloc);
+			if(spec.zeroCopy) proc->enableZeroCopy();
 			par2ocl.push_back(std::unique_ptr<PAR2ProcOCL>(proc));
-			procs.push_back({static_cast<IPAR2ProcBackend*>(proc), spec.sliceOffset, spec.sliceSize});
+			procs.push_back({static_cast<IPAR2ProcBackend*>(proc), spec.sliceOffset, spec.sliceSize, spec.recOffset, spec.recCount});
 		}
-		if(cpuSliceSize) {
-			par2cpu.reset(new PAR2ProcCPU(loop, stagingAreas));
-			procs.push_back({static_cast<IPAR2ProcBackend*>(par2cpu.get()), cpuOffset, cpuSliceSize});
+		for(const auto& spec : useCpu) {
+			auto proc = new PAR2ProcCPU(loop, stagingAreas);
+			if(!spec.cpus.empty())
+				proc->setAffinity(spec.cpus);
+			if(!spec.cpus.empty() || spec.threads >= 0)
+				proc->setNumThreads(spec.threads);
+			// the transfer thread is serial, so it can be kept off slow cores to avoid holding up the workers
+			if(!spec.transferCpus.empty())
+				proc->setTransferAffinity(spec.transferCpus);
+			par2cpu.push_back(std::unique_ptr<PAR2ProcCPU>(proc));
+			procs.push_back({static_cast<IPAR2ProcBackend*>(proc), spec.sliceOffset, spec.sliceSize, spec.recOffset, spec.recCount});
 		}
-		// TODO: handle init returning false (currently, it can't)
-		par2.init(sliceSize, procs, [&](unsigned numInputs) {
+		allocValid = par2.init(sliceSize, procs, [&](unsigned numInputs) {
 			if(progressCb.hasCallback) {
 #if NODE_VERSION_AT_LEAST(0, 11, 0)
 				HandleScope scope(progressCb.isolate);
@@ -720,11 +893,17 @@ protected:
 		});
 	}
 	
-	bool init_cpu(Galois16Methods method, unsigned inputGrouping, size_t chunkLen) {
-		return par2cpu->init(method, inputGrouping, chunkLen);
+	bool init_cpu(int idx, Galois16Methods method, unsigned inputGrouping, size_t chunkLen) {
+		return par2cpu[idx]->init(method, inputGrouping, chunkLen);
 	}
-	bool init_ocl(int idx, Galois16OCLMethods method, unsigned inputGrouping, unsigned targetIters, unsigned targetGrouping, Galois16Methods cksumMethod) {
-		return par2ocl[idx]->init(method, inputGrouping, targetIters, targetGrouping, cksumMethod);
+	int totalCpuThreads() const {
+		int threads = 0;
+		for(const auto& proc : par2cpu)
+			threads += proc->getNumThreads();
+		return threads;
+	}
+	bool init_ocl(int idx, Galois16OCLMethods method, unsigned inputGrouping, unsigned targetIters, unsigned targetGrouping, Galois16Methods cksumMethod, unsigned targetWorkGroup) {
+		return par2ocl[idx]->init(method, inputGrouping, targetIters, targetGrouping, cksumMethod, targetWorkGroup);
 	}
 	
 	~GfProc() {
@@ -755,6 +934,39 @@ FUNC(GfInfo) {
 	RETURN_VAL(ret);
 }
 
+FUNC(GfMethods) {
+	FUNC_START;
+	
+	// methods usable on this CPU
+	auto methods = PAR2ProcCPU::availableMethods();
+	Local<Array> ret = Array::New(ISOLATE methods.size());
+	for(unsigned i=0; i<methods.size(); i++)
+		SET_ARR(ret, i, Integer::New(ISOLATE (int)methods[i]));
+	
+	RETURN_VAL(ret);
+}
+
+FUNC(CpuCores) {
+	FUNC_START;
+	
+	const auto& classes = cpu_core_classes();
+	Local<Array> ret = Array::New(ISOLATE classes.size());
+	int i = 0;
+	for(const auto& cls : classes) {
+		Local<Object> info = NEW_OBJ(Object);
+		Local<Array> cpus = Array::New(ISOLATE cls.cpus.size());
+		for(unsigned j=0; j<cls.cpus.size(); j++)
+			SET_ARR(cpus, j, Integer::New(ISOLATE cls.cpus[j]));
+		SET_OBJ(info, "cpus", cpus);
+		SET_OBJ(info, "cores", Integer::New(ISOLATE cls.cores));
+		SET_OBJ(info, "capacity", Integer::New(ISOLATE cls.capacity));
+		SET_OBJ(info, "efficiency", Boolean::New(ISOLATE cls.efficiency));
+		SET_OBJ(info, "capacity_estimated", Boolean::New(ISOLATE cls.estimated));
+		SET_ARR(ret, i++, info);
+	}
+	RETURN_VAL(ret);
+}
+
 static void OclDeviceToJS(
 #if NODE_VERSION_AT_LEAST(0, 11, 0)
 	  Isolate* isolate,
@@ -763,6 +975,7 @@ static void OclDeviceToJS(
 	dev = NEW_OBJ(Object);
 	SET_OBJ(dev, "id", Integer::New(ISOLATE device.id));
 	SET_OBJ(dev, "name", NEW_STRING(device.name.c_str()));
+	SET_OBJ(dev, "driver_version", NEW_STRING(device.driverVersion.c_str()));
 	SET_OBJ(dev, "vendor_id", Integer::New(ISOLATE device.vendorId));
 	SET_OBJ(dev, "available", Boolean::New(ISOLATE device.available));
 	SET_OBJ(dev, "supported", Boolean::New(ISOLATE device.supported));
@@ -840,6 +1053,46 @@ FUNC(OclDeviceInfo) {
 	RETURN_VAL(dev);
 }
 
+FUNC(OclAutotune) {
+	FUNC_START;
+	
+	if(args.Length() < 2)
+		RETURN_ERROR("Requires 2 arguments");
+	
+	int platformId = ARG_TO_NUM(Int32, args[0]);
+	int deviceId = ARG_TO_NUM(Int32, args[1]);
+	std::string cacheDir;
+	if(args.Length() >= 3 && args[2]->IsString()) {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		String::Utf8Value dir(isolate, args[2]);
+#else
+		String::Utf8Value dir(args[2]);
+#endif
+		if(*dir) cacheDir = *dir;
+	}
+	
+	if(!load_ocl()) {
+		RETURN_ERROR("Could not load OpenCL runtime");
+	}
+	
+	const auto results = PAR2ProcOCL::autotune(platformId, deviceId, cacheDir);
+	Local<Array> ret = Array::New(ISOLATE results.size());
+	for(unsigned i=0; i<results.size(); i++) {
+		const auto& result = results[i];
+		Local<Object> obj = NEW_OBJ(Object);
+		SET_OBJ(obj, "method", Integer::New(ISOLATE result.method));
+		SET_OBJ(obj, "input_batchsize", Integer::New(ISOLATE result.inputBatch));
+		SET_OBJ(obj, "target_iters", Integer::New(ISOLATE result.iters));
+		SET_OBJ(obj, "target_grouping", Integer::New(ISOLATE result.grouping));
+		SET_OBJ(obj, "target_workgroup", Integer::New(ISOLATE result.workGroup));
+		SET_OBJ(obj, "valid", Boolean::New(ISOLATE result.valid));
+		if(result.valid)
+			SET_OBJ(obj, "time", Number::New(ISOLATE result.time));
+		SET_ARR(ret, i, obj);
+	}
+	RETURN_VAL(ret);
+}
+
 
 
 class HasherInput;
@@ -875,6 +1128,9 @@ public:
 		
 		if(args.Length() < 2 || !node::Buffer::HasInstance(args[1]))
 			RETURN_ERROR("Requires a size and buffer");
+		std::vector<int> cpus;
+		if(args.Length() >= 3 && !CpuListFromJS(ISOLATE args[2], cpus))
+			RETURN_ERROR("Invalid CPU list specified");
 
 		// grab slice size + buffer to write hashes into
 		double sliceSize = 0; // double ensures enough range even if int is 32-bit
@@ -891,6 +1147,7 @@ public:
 		self->bh.count = node::Buffer::Length(args[1]) / 20;
 		self->bh.ptr = node::Buffer::Data(args[1]);
 		PERSIST_VALUE(self->ifscData, args[1]);
+		self->affinity = cpus;
 		
 		self->Wrap(args.This());
 		RETURN_UNDEF;
@@ -902,6 +1159,7 @@ private:
 	int queueCount;
 	
 	std::unique_ptr<MessageThread> thread;
+	std::vector<int> affinity;
 	uv_async_t threadSignal;
 	ThreadMessageQueue<struct input_work_data*> hashesDone;
 	
@@ -967,6 +1225,8 @@ protected:
 			if(HasherInputThreadPool.empty()) {
 				thread.reset(new MessageThread(thread_func));
 				thread->name = "par2_hash_input";
+				// hashing is on the critical path for reading input, so it can be pinned to the fastest cores
+				thread->affinity = affinity;
 			} else {
 				thread.reset(HasherInputThreadPool.back());
 				HasherInputThreadPool.pop_back();
@@ -1218,6 +1478,465 @@ protected:
 	}
 };
 
+// creates an Error object resembling those from the fs module
+static Local<Value> MakeUVError(
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Isolate* isolate,
+#endif
+	int err, const char* syscall
+) {
+	const char* errName = uv_err_name(err);
+	std::string msg = std::string(errName) + ": " + uv_strerror(err) + ", " + syscall;
+	Local<Object> ret = ARG_TO_OBJ(Exception::Error(NEW_STRING(msg.c_str())));
+	SET_OBJ(ret, "code", NEW_STRING(errName));
+	SET_OBJ(ret, "syscall", NEW_STRING(syscall));
+	return ret;
+}
+
+class InputReader : public node::ObjectWrap {
+public:
+	static inline void AttachMethods(Local<FunctionTemplate>& t) {
+		t->InstanceTemplate()->SetInternalFieldCount(1);
+		
+		NODE_SET_PROTOTYPE_METHOD(t, "open", Open);
+		NODE_SET_PROTOTYPE_METHOD(t, "read", Read);
+		NODE_SET_PROTOTYPE_METHOD(t, "map", Map);
+		NODE_SET_PROTOTYPE_METHOD(t, "info", GetInfo);
+		NODE_SET_PROTOTYPE_METHOD(t, "close", Close);
+	}
+	
+	FUNC(New) {
+		FUNC_START;
+		if(!args.IsConstructCall())
+			RETURN_ERROR("Class must be constructed with 'new'");
+		
+		int method = FILE_READER_AUTO;
+		unsigned queueDepth = 2;
+		if(args.Length() >= 1 && !args[0]->IsUndefined() && !args[0]->IsNull())
+			method = ARG_TO_NUM(Int32, args[0]);
+		if(method < FILE_READER_AUTO || method > FILE_READER_MMAP)
+			RETURN_ERROR("Invalid read method");
+		if(args.Length() >= 2 && !args[1]->IsUndefined() && !args[1]->IsNull())
+			queueDepth = ARG_TO_NUM(Uint32, args[1]);
+		if(queueDepth < 1 || queueDepth > 32768)
+			RETURN_ERROR("Invalid queue depth");
+		bool directIO = false;
+		if(args.Length() >= 3)
+			directIO = args[2]->IsTrue();
+		bool sequential = true;
+		if(args.Length() >= 4)
+			sequential = !args[3]->IsFalse();
+		
+		InputReader *self = new InputReader(getCurrentLoop(ISOLATE 0));
+		if(!self->reader.init((FileReaderMethods)method, queueDepth, directIO, sequential)) {
+			delete self;
+			RETURN_ERROR("Selected read method is not available");
+		}
+		self->Wrap(args.This());
+		RETURN_UNDEF;
+	}
+	
+private:
+	FileReader reader;
+	bool isClosed;
+	bool closeRequested;
+	
+	// disable copy constructor
+	InputReader(const InputReader&);
+	InputReader& operator=(const InputReader&);
+	
+protected:
+	// mirrors fs.open(path, 'r', callback); if direct I/O was requested, tries to open with O_DIRECT
+	FUNC(Open) {
+		FUNC_START;
+		InputReader* self = node::ObjectWrap::Unwrap<InputReader>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		
+		if(args.Length() < 2 || !args[1]->IsFunction())
+			RETURN_ERROR("Requires a path and callback");
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		String::Utf8Value path(isolate, args[0]);
+#else
+		String::Utf8Value path(args[0]);
+#endif
+		if(!*path)
+			RETURN_ERROR("Invalid path");
+		
+		CallbackWrapper* cb = new CallbackWrapper(ISOLATE Local<Function>::Cast(args[1]));
+		self->Ref();
+		self->reader.open(*path, [ISOLATE cb, self](int result) {
+			HANDLE_SCOPE;
+			if(result < 0) {
+				cb->call({ MakeUVError(ISOLATE result, "open") });
+			} else {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+				cb->call({ Null(cb->isolate), Integer::New(cb->isolate, result) });
+#else
+				cb->call({ Local<Value>::New(Null()), Local<Value>::New(Integer::New(result)) });
+#endif
+			}
+			delete cb;
+			self->requestDone();
+		});
+		RETURN_UNDEF;
+	}
+	
+	// mirrors fs.read(fd, buffer, offset, length, position, callback)
+	FUNC(Read) {
+		FUNC_START;
+		InputReader* self = node::ObjectWrap::Unwrap<InputReader>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		if(self->reader.getMethod() == FILE_READER_MMAP)
+			RETURN_ERROR("Reader is memory mapped");
+		
+		if(args.Length() < 6)
+			RETURN_ERROR("Requires 6 arguments");
+		if(!node::Buffer::HasInstance(args[1]))
+			RETURN_ERROR("Buffer required");
+		if(!args[5]->IsFunction())
+			RETURN_ERROR("Callback required");
+		
+		int fd = ARG_TO_NUM(Int32, args[0]);
+		size_t offset = (size_t)ARG_TO_NUM(Integer, args[2]);
+		size_t length = (size_t)ARG_TO_NUM(Integer, args[3]);
+		double position = 0;
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+		position = args[4].As<Number>()->Value();
+#else
+		position = args[4]->NumberValue();
+#endif
+		if(fd < 0)
+			RETURN_ERROR("Invalid file descriptor");
+		if(position < 0)
+			RETURN_ERROR("Position must be specified");
+		if(offset > node::Buffer::Length(args[1]) || length > node::Buffer::Length(args[1]) - offset)
+			RETURN_ERROR("Read exceeds buffer length");
+		
+		CallbackWrapper* cb = new CallbackWrapper(ISOLATE Local<Function>::Cast(args[5]));
+		cb->attachValue(args[1]);
+		
+		self->Ref();
+		self->reader.read(fd, (uint64_t)position, node::Buffer::Data(args[1]) + offset, length, [ISOLATE cb, self](int64_t result) {
+			HANDLE_SCOPE;
+			if(result < 0) {
+				cb->call({ MakeUVError(ISOLATE (int)result, "read") });
+			} else {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+				cb->call({ Null(cb->isolate), Number::New(cb->isolate, (double)result) });
+#else
+				cb->call({ Local<Value>::New(Null()), Local<Value>::New(Number::New((double)result)) });
+#endif
+			}
+			delete cb;
+			self->requestDone();
+		});
+		RETURN_UNDEF;
+	}
+	
+	// for memory mapped input: map(fd, position, length) returns a Buffer referencing the file's contents, without copying
+	// the Buffer must not be written to, and is truncated at EOF
+	FUNC(Map) {
+		FUNC_START;
+		InputReader* self = node::ObjectWrap::Unwrap<InputReader>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		if(self->reader.getMethod() != FILE_READER_MMAP)
+			RETURN_ERROR("Reader is not memory mapped");
+		
+		if(args.Length() < 3)
+			RETURN_ERROR("Requires 3 arguments");
+		int fd = ARG_TO_NUM(Int32, args[0]);
+		double position = 0;
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+		position = args[1].As<Number>()->Value();
+#else
+		position = args[1]->NumberValue();
+#endif
+		size_t length = (size_t)ARG_TO_NUM(Integer, args[2]);
+		if(fd < 0)
+			RETURN_ERROR("Invalid file descriptor");
+		if(position < 0)
+			RETURN_ERROR("Invalid position");
+		
+		struct file_mapping* mapping;
+		const char* data = self->reader.map(fd, (uint64_t)position, length, mapping);
+		if(!data)
+			RETURN_ERROR("File is not mapped");
+		// the view holds a reference to the mapping, so it outlives the file being closed
+		RETURN_BUFFER(BUFFER_NEW(const_cast<char*>(data), length, [](char*, void* hint) {
+			FileReader::unref_mapping(static_cast<struct file_mapping*>(hint));
+		}, static_cast<void*>(mapping)));
+	}
+	
+	FUNC(GetInfo) {
+		FUNC_START;
+		InputReader* self = node::ObjectWrap::Unwrap<InputReader>(args.This());
+		
+		Local<Object> ret = NEW_OBJ(Object);
+		SET_OBJ(ret, "method_desc", NEW_STRING(FileReader::methodToText(self->reader.getMethod())));
+		SET_OBJ(ret, "queue_depth", Integer::New(ISOLATE self->reader.getQueueDepth()));
+		SET_OBJ(ret, "direct_io", Boolean::New(ISOLATE self->reader.isDirectIO()));
+		RETURN_VAL(ret);
+	}
+	
+	FUNC(Close) {
+		FUNC_START;
+		InputReader* self = node::ObjectWrap::Unwrap<InputReader>(args.This());
+		if(self->closeRequested)
+			RETURN_ERROR("Already closed");
+		
+		// if reads are still pending (e.g. closing after an error), the reader is closed once it goes idle; like fs, reads already underway may issue further reads in the meantime
+		self->closeRequested = true;
+		if(!self->reader.getPending()) {
+			self->reader.deinit();
+			self->isClosed = true;
+		}
+		RETURN_UNDEF;
+	}
+	
+	explicit InputReader(uv_loop_t* loop) : ObjectWrap(), reader(loop), isClosed(false), closeRequested(false) {}
+	
+	// every request holds a reference to this object, so it can't be garbage collected whilst the reader still has I/O in flight
+	void requestDone() {
+		if(closeRequested && !isClosed && !reader.getPending()) {
+			reader.deinit();
+			isClosed = true;
+		}
+		Unref();
+	}
+	
+	~InputReader() {
+		reader.deinit();
+	}
+};
+
+class OutputWriter : public node::ObjectWrap {
+public:
+	static inline void AttachMethods(Local<FunctionTemplate>& t) {
+		t->InstanceTemplate()->SetInternalFieldCount(1);
+		
+		NODE_SET_PROTOTYPE_METHOD(t, "open", Open);
+		NODE_SET_PROTOTYPE_METHOD(t, "allocate", Allocate);
+		NODE_SET_PROTOTYPE_METHOD(t, "write", Write);
+		NODE_SET_PROTOTYPE_METHOD(t, "info", GetInfo);
+		NODE_SET_PROTOTYPE_METHOD(t, "close", Close);
+	}
+	
+	FUNC(New) {
+		FUNC_START;
+		if(!args.IsConstructCall())
+			RETURN_ERROR("Class must be constructed with 'new'");
+		
+		int method = FILE_READER_AUTO;
+		unsigned queueDepth = 4;
+		if(args.Length() >= 1 && !args[0]->IsUndefined() && !args[0]->IsNull())
+			method = ARG_TO_NUM(Int32, args[0]);
+		// memory mapped output isn't supported
+		if(method < FILE_READER_AUTO || method > FILE_READER_URING)
+			RETURN_ERROR("Invalid write method");
+		if(args.Length() >= 2 && !args[1]->IsUndefined() && !args[1]->IsNull())
+			queueDepth = ARG_TO_NUM(Uint32, args[1]);
+		if(queueDepth < 1 || queueDepth > 32768)
+			RETURN_ERROR("Invalid queue depth");
+		
+		OutputWriter *self = new OutputWriter(getCurrentLoop(ISOLATE 0));
+		if(!self->writer.init((FileReaderMethods)method, queueDepth)) {
+			delete self;
+			RETURN_ERROR("Selected write method is not available");
+		}
+		self->Wrap(args.This());
+		RETURN_UNDEF;
+	}
+	
+private:
+	FileReader writer;
+	bool isClosed;
+	
+	// disable copy constructor
+	OutputWriter(const OutputWriter&);
+	OutputWriter& operator=(const OutputWriter&);
+	
+protected:
+	// mirrors fs.open(path, overwrite ? 'w' : 'wx', callback)
+	FUNC(Open) {
+		FUNC_START;
+		OutputWriter* self = node::ObjectWrap::Unwrap<OutputWriter>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		
+		if(args.Length() < 3 || !args[2]->IsFunction())
+			RETURN_ERROR("Requires a path, overwrite flag and callback");
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		String::Utf8Value path(isolate, args[0]);
+#else
+		String::Utf8Value path(args[0]);
+#endif
+		if(!*path)
+			RETURN_ERROR("Invalid path");
+		
+		CallbackWrapper* cb = new CallbackWrapper(ISOLATE Local<Function>::Cast(args[2]));
+		self->writer.create(*path, args[1]->IsTrue(), [ISOLATE cb](int result) {
+			HANDLE_SCOPE;
+			if(result < 0) {
+				cb->call({ MakeUVError(ISOLATE result, "open") });
+			} else {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+				cb->call({ Null(cb->isolate), Integer::New(cb->isolate, result) });
+#else
+				cb->call({ Local<Value>::New(Null()), Local<Value>::New(Integer::New(result)) });
+#endif
+			}
+			delete cb;
+		});
+		RETURN_UNDEF;
+	}
+	
+	// allocate(fd, size, callback): reserves space for, and extends the file to, `size` bytes
+	FUNC(Allocate) {
+		FUNC_START;
+		OutputWriter* self = node::ObjectWrap::Unwrap<OutputWriter>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		
+		if(args.Length() < 3 || !args[2]->IsFunction())
+			RETURN_ERROR("Requires a file descriptor, size and callback");
+		int fd = ARG_TO_NUM(Int32, args[0]);
+		double size = 0;
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+		size = args[1].As<Number>()->Value();
+#else
+		size = args[1]->NumberValue();
+#endif
+		if(fd < 0)
+			RETURN_ERROR("Invalid file descriptor");
+		if(size < 0)
+			RETURN_ERROR("Invalid size");
+		
+		CallbackWrapper* cb = new CallbackWrapper(ISOLATE Local<Function>::Cast(args[2]));
+		self->writer.allocate(fd, (uint64_t)size, [ISOLATE cb](int result) {
+			HANDLE_SCOPE;
+			if(result < 0) {
+				cb->call({ MakeUVError(ISOLATE result, "fallocate") });
+			} else {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+				cb->call({ Null(cb->isolate) });
+#else
+				cb->call({ Local<Value>::New(Null()) });
+#endif
+			}
+			delete cb;
+		});
+		RETURN_UNDEF;
+	}
+	
+	// mirrors fs.writev(fd, buffers, position, callback), but without any limit on the total length
+	FUNC(Write) {
+		FUNC_START;
+		OutputWriter* self = node::ObjectWrap::Unwrap<OutputWriter>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		
+		if(args.Length() < 4)
+			RETURN_ERROR("Requires 4 arguments");
+		if(!args[1]->IsArray())
+			RETURN_ERROR("Requires an array of buffers");
+		if(!args[3]->IsFunction())
+			RETURN_ERROR("Callback required");
+		
+		int fd = ARG_TO_NUM(Int32, args[0]);
+		double position = 0;
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+		position = args[2].As<Number>()->Value();
+#else
+		position = args[2]->NumberValue();
+#endif
+		if(fd < 0)
+			RETURN_ERROR("Invalid file descriptor");
+		if(position < 0)
+			RETURN_ERROR("Position must be specified");
+		
+		int numBufs = Local<Array>::Cast(args[1])->Length();
+		Local<Object> oBufs = ARG_TO_OBJ(args[1]);
+		std::vector<uv_buf_t> bufs;
+		bufs.reserve(numBufs);
+		for(int i = 0; i < numBufs; i++) {
+			Local<Value> buffer = GET_ARR(oBufs, i);
+			if(!node::Buffer::HasInstance(buffer))
+				RETURN_ERROR("All items must be Buffers");
+			uv_buf_t buf;
+			buf.base = node::Buffer::Data(buffer);
+			buf.len = node::Buffer::Length(buffer);
+			if(buf.len) bufs.push_back(buf);
+		}
+		
+		CallbackWrapper* cb = new CallbackWrapper(ISOLATE Local<Function>::Cast(args[3]));
+		cb->attachValue(args[1]);
+		
+		self->writer.write(fd, (uint64_t)position, bufs, [ISOLATE cb](int64_t result) {
+			HANDLE_SCOPE;
+			if(result < 0) {
+				cb->call({ MakeUVError(ISOLATE (int)result, "write") });
+			} else {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+				cb->call({ Null(cb->isolate), Number::New(cb->isolate, (double)result) });
+#else
+				cb->call({ Local<Value>::New(Null()), Local<Value>::New(Number::New((double)result)) });
+#endif
+			}
+			delete cb;
+		});
+		RETURN_UNDEF;
+	}
+	
+	FUNC(GetInfo) {
+		FUNC_START;
+		OutputWriter* self = node::ObjectWrap::Unwrap<OutputWriter>(args.This());
+		
+		Local<Object> ret = NEW_OBJ(Object);
+		SET_OBJ(ret, "method_desc", NEW_STRING(FileReader::methodToText(self->writer.getMethod())));
+		SET_OBJ(ret, "queue_depth", Integer::New(ISOLATE self->writer.getQueueDepth()));
+		RETURN_VAL(ret);
+	}
+	
+	FUNC(Close) {
+		FUNC_START;
+		OutputWriter* self = node::ObjectWrap::Unwrap<OutputWriter>(args.This());
+		if(self->isClosed)
+			RETURN_ERROR("Already closed");
+		if(self->writer.getPending())
+			RETURN_ERROR("Cannot close whilst writes are pending");
+		
+		self->writer.deinit();
+		self->isClosed = true;
+		RETURN_UNDEF;
+	}
+	
+	explicit OutputWriter(uv_loop_t* loop) : ObjectWrap(), writer(loop), isClosed(false) {}
+	
+	~OutputWriter() {
+		writer.deinit();
+	}
+};
+
+// allocates a buffer suitably aligned for direct I/O
+FUNC(AllocAligned) {
+	FUNC_START;
+	
+	if(args.Length() < 1)
+		RETURN_ERROR("Size required");
+	size_t size = (size_t)ARG_TO_NUM(Integer, args[0]);
+	
+	char* data;
+	ALIGN_ALLOC(data, size ? size : 1, FILE_READER_DIRECT_ALIGN);
+	if(!data)
+		RETURN_ERROR("Failed to allocate memory");
+	RETURN_BUFFER(BUFFER_NEW(data, size, [](char* data, void*) {
+		ALIGN_FREE(data);
+	}, nullptr));
+}
+
 FUNC(SetHasherInput) {
 	FUNC_START;
 	
@@ -1258,8 +1977,11 @@ void parpar_gf_init(
 	SET_OBJ_FUNC(target, "GfProc", t);
 	
 	NODE_SET_METHOD(target, "gf_info", GfInfo);
+	NODE_SET_METHOD(target, "gf_methods", GfMethods);
+	NODE_SET_METHOD(target, "cpu_cores", CpuCores);
 	NODE_SET_METHOD(target, "opencl_devices", OclDevices);
 	NODE_SET_METHOD(target, "opencl_device_info", OclDeviceInfo);
+	NODE_SET_METHOD(target, "opencl_autotune", OclAutotune);
 	
 	t = FunctionTemplate::New(ISOLATE HasherInput::New);
 	HasherInput::AttachMethods(t);
@@ -1271,6 +1993,15 @@ void parpar_gf_init(
 	HasherOutput::AttachMethods(t);
 	SET_OBJ_FUNC(target, "HasherOutput", t);
 	
+	t = FunctionTemplate::New(ISOLATE InputReader::New);
+	InputReader::AttachMethods(t);
+	SET_OBJ_FUNC(target, "InputReader", t);
+	
+	t = FunctionTemplate::New(ISOLATE OutputWriter::New);
+	OutputWriter::AttachMethods(t);
+	SET_OBJ_FUNC(target, "OutputWriter", t);
+	NODE_SET_METHOD(target, "alloc_aligned", AllocAligned);
+	
 	NODE_SET_METHOD(target, "set_HasherInput", SetHasherInput);
 	NODE_SET_METHOD(target, "set_HasherOutput", SetHasherOutput);
 	
@@ -84,6 +84,9 @@
 #if defined(__SSE2__) && _MSC_VER >= 1920
 	#define __GFNI__ 1
 #endif
+#if defined(__AVX2__) && _MSC_VER >= 1920
+	#define __VPCLMULQDQ__ 1
+#endif
 
 #endif /* _MSC_VER */
 
@@ -0,0 +1,262 @@
+"use strict";
+/*
+ * Tests processing split across multiple backends, which the command line doesn't otherwise set up
+ * The recovery computed must be identical to that of a single CPU backend, regardless of how the work is split up
+ */
+
+
+// Change these variables if necessary
+var tmpDir = (process.env.TMP || process.env.TEMP || '.') + require('path').sep;
+
+
+var Par2 = require('../lib/par2.js');
+var ParPar = require('../lib/par2gen.js');
+var async = require('async');
+var fs = require('fs');
+
+var allocBuffer = function(size) {
+	return Buffer.alloc ? Buffer.alloc(size) : new Buffer(size).fill(0);
+};
+var range = function(from, to) {
+	var ret = [];
+	for(var i=from; i<to; i++)
+		ret.push(i);
+	return ret;
+};
+
+// inputs are filled from a simple LCG, so that they're consistent across runs
+var sliceSize = 65536 + 1036; // not a multiple of any method's stride
+var numInputs = 37;
+var inputs = (function() {
+	var state = 12345;
+	return range(0, numInputs).map(function() {
+		var buf = allocBuffer(sliceSize);
+		for(var i=0; i<sliceSize; i+=4) {
+			state = (Math.imul(state, 1103515245) + 12345) >>> 0;
+			buf.writeUInt32LE(state, i);
+		}
+		return buf;
+	});
+})();
+
+
+// computes recovery for each set of slices in `passes`, optionally in chunks of `chunkSize`
+// `procCpu` is given the size allocated for processing (chunk size if chunking), and returns the CPU backend specs
+function genRecovery(procCpu, passes, chunkSize, cb) {
+	// the file list only matters for packets, which aren't generated here; an empty file avoids creating an input hasher which is never used
+	var par2 = new Par2.PAR2([{md5_16k: allocBuffer(16), size: 0, name: 'input'}], sliceSize, {
+		proc_cpu: procCpu(chunkSize || sliceSize),
+		recDataSize: 12 // as the generator defaults to, 1.5x the hash batch size
+	});
+	var output = {};
+
+	// processes a chunk of each input, then fetches the recovery for it
+	var processChunk = function(proc, recSlices, offset, len, cb) {
+		async.times(numInputs, function(i, cb) {
+			var data = inputs[i];
+			if(chunkSize) proc.processData(i, data.slice(offset, offset+len), cb);
+			else proc.processSlice(data, i, cb);
+		}, function(err) {
+			if(err) return cb(err);
+			proc.finish(function() {
+				async.timesSeries(recSlices.length, function(_, cb) {
+					proc.getNextRecoveryData(function(idx, recData) {
+						var rec = recSlices[idx];
+						if(!output[rec]) output[rec] = allocBuffer(sliceSize);
+						recData.data.copy(output[rec], offset);
+						// like the generator, wait for the MD5, which also frees the hasher once all of its batch is done
+						recData.getMD5(function() {
+							recData.release();
+							cb();
+						});
+					});
+				}, cb);
+			});
+		});
+	};
+
+	async.eachSeries(passes, function(recSlices, cb) {
+		if(!chunkSize) {
+			par2.setRecoverySlices(recSlices);
+			return processChunk(par2, recSlices, 0, sliceSize, cb);
+		}
+		var chunker = par2.startChunking(recSlices);
+		async.timesSeries(Math.ceil(sliceSize / chunkSize), function(chunk, cb) {
+			var offset = chunk * chunkSize;
+			var len = Math.min(chunkSize, sliceSize - offset);
+			if(len != chunker.chunkSize)
+				chunker.setChunkSize(len);
+			processChunk(chunker, recSlices, offset, len, cb);
+		}, function(err) {
+			if(err) return cb(err);
+			chunker.close(cb);
+		});
+	}, function(err) {
+		if(err) return cb(err);
+		// wait for the backends to be torn down, as they can't be freed until then
+		par2.close(function() {
+			cb(null, output);
+		});
+	});
+}
+
+function compareRecovery(ref, test) {
+	var refKeys = Object.keys(ref), testKeys = Object.keys(test);
+	if(refKeys.join(',') != testKeys.join(','))
+		throw new Error('Recovery slices mismatch: expected ' + refKeys.join(',') + ', got ' + testKeys.join(','));
+	refKeys.forEach(function(k) {
+		if(!ref[k].equals(test[k]))
+			throw new Error('Recovery slice ' + k + ' differs from the reference');
+	});
+}
+
+
+var oclDeviceCount = 0;
+try {
+	Par2.opencl_devices().forEach(function(platform) {
+		oclDeviceCount += platform.devices.length;
+	});
+} catch(x) {}
+
+var tests = [];
+
+// runs genRecovery with each of `procCpu` and the same passes, both in a single pass and chunked, comparing against a single default backend
+var addRecoveryTests = function(name, procCpu, passes) {
+	[0, 16384].forEach(function(chunkSize) {
+		var desc = name + (chunkSize ? ' (chunked)' : '');
+		tests.push(function(cb) {
+			async.series([
+				genRecovery.bind(null, function() { return {}; }, passes, chunkSize),
+				genRecovery.bind(null, procCpu, passes, chunkSize)
+			], function(err, results) {
+				if(err) return cb(err);
+				compareRecovery(results[0], results[1]);
+				console.log(desc + ': OK');
+				cb();
+			});
+		});
+	});
+};
+
+// backends with identical ranges share work, each computing a partial sum over the inputs it was sent, which are merged on output
+addRecoveryTests('Two CPU backends, shared range', function() {
+	return [{}, {}];
+}, [range(0, 40)]);
+addRecoveryTests('Three CPU backends, shared range, two passes', function() {
+	return [{}, {}, {}];
+}, [range(0, 20), range(20, 33)]);
+
+
+// backends can instead be allocated a range of recovery slices, computing those across the whole of their slice range
+// the last partition is open-ended; with fewer recovery slices than its offset, it has nothing to compute
+var recoverySplitPasses = [range(0, 40), range(40, 50), range(50, 60)];
+addRecoveryTests('Recovery split [0,15) [15,-)', function() {
+	return [
+		{recovery_offset: 0, recovery_count: 15},
+		{recovery_offset: 15}
+	];
+}, recoverySplitPasses);
+// split by recovery, then split the second partition's slice range between two backends, one of which is shared with a third
+addRecoveryTests('Recovery and slice split', function(size) {
+	var half = Math.round(size / 4) * 2;
+	return [
+		{recovery_offset: 0, recovery_count: 15},
+		{recovery_offset: 15, slice_offset: 0, slice_size: half},
+		{recovery_offset: 15, slice_offset: half, slice_size: size - half},
+		{recovery_offset: 15, slice_offset: half, slice_size: size - half}
+	];
+}, recoverySplitPasses);
+
+// each CPU backend can be pinned to its own cores, and use its own method and chunk size
+// methods differ in their internal layout, so partial results must be converted before they're merged
+var pinnedBackends = (function() {
+	var gfMethods = Par2.gf_methods().filter(function(method) {
+		return method != 'lookup';
+	});
+	var lastCpu = require('os').cpus().length - 1;
+	return function(offsetA, sizeA, offsetB, sizeB) {
+		return [
+			{method: 'lookup', chunk_size: 32768, cpus: [0], slice_offset: offsetA, slice_size: sizeA},
+			{method: gfMethods[gfMethods.length-1], chunk_size: 4096, cpus: [lastCpu], slice_offset: offsetB, slice_size: sizeB}
+		];
+	};
+})();
+addRecoveryTests('Pinned CPU backends with different methods, split range', function(size) {
+	var half = Math.round(size / 4) * 2;
+	return pinnedBackends(0, half, half, size - half);
+}, [range(0, 40)]);
+addRecoveryTests('Pinned CPU backends with different methods, shared range', function(size) {
+	return pinnedBackends(0, size, 0, size);
+}, [range(0, 40)]);
+
+// generates PAR2 files through the full generator with `opts`, returning their contents
+function genFiles(name, opts, cb) {
+	var inFile = tmpDir + 'backend-compare.bin';
+	if(!fs.existsSync(inFile))
+		fs.writeFileSync(inFile, Buffer.concat(inputs));
+	var outBase = tmpDir + 'backend-compare-' + name;
+	ParPar.run([inFile], sliceSize, Par2._extend({
+		outputBase: outBase,
+		outputOverwrite: true,
+		gfMethod: '',
+		displayNameFormat: 'basename',
+		recoverySlices: {unit: 'slices', value: 40}
+	}, opts), function(err) {
+		if(err) return cb(err);
+		var dir = require('path').dirname(outBase), base = require('path').basename(outBase);
+		var ret = {};
+		fs.readdirSync(dir).forEach(function(f) {
+			if(f.substr(0, base.length+1) != base + '.') return;
+			ret[f.substr(base.length)] = fs.readFileSync(dir + require('path').sep + f);
+			fs.unlinkSync(dir + require('path').sep + f);
+		});
+		cb(null, ret);
+	});
+}
+
+// on a hybrid CPU, each core type gets its own backend; with a dynamic OpenCL device, these must all share the device's range
+var hybridCpuCores = function() {
+	// pretend that this is a hybrid CPU; speeds are marked as estimated, which 'auto' only ignores if work is shared dynamically
+	var cpus = range(0, require('os').cpus().length);
+	return [
+		{cpus: cpus, cores: cpus.length, capacity: 1024, efficiency: false, capacity_estimated: true},
+		{cpus: cpus, cores: cpus.length, capacity: 512, efficiency: true, capacity_estimated: true}
+	];
+};
+[true, 'auto'].forEach(function(hybridSplit) {
+	tests.push(function(cb) {
+		if(!oclDeviceCount) {
+			console.log('Skipping hybrid split (' + hybridSplit + ') with dynamic OpenCL test: no OpenCL devices found');
+			return cb();
+		}
+		var realCpuCores = Par2.cpu_cores;
+		async.series([
+			genFiles.bind(null, 'ref', {}),
+			function(cb) {
+				Par2.cpu_cores = hybridCpuCores;
+				genFiles('hybrid', {cpuHybridSplit: hybridSplit, openclDevices: [{dynamic: true}]}, function(err, files) {
+					Par2.cpu_cores = realCpuCores;
+					cb(err, files);
+				});
+			}
+		], function(err, results) {
+			if(err) return cb(err);
+			var ref = results[0], test = results[1];
+			if(Object.keys(ref).sort().join(',') != Object.keys(test).sort().join(','))
+				throw new Error('Output files mismatch');
+			for(var k in ref)
+				if(!ref[k].equals(test[k]))
+					throw new Error('Output file ' + k + ' differs from the reference');
+			console.log('Hybrid split (' + hybridSplit + ') with dynamic OpenCL: OK');
+			cb();
+		});
+	});
+});
+
+async.series(tests, function(err) {
+	try {
+		fs.unlinkSync(tmpDir + 'backend-compare.bin');
+	} catch(x) {}
+	if(err) throw err;
+	console.log('All tests passed');
+});
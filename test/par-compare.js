@@ -234,6 +234,16 @@ function parpar_args(o) {
 	if(o.readSize) a.push('--seq-read-size='+o.readSize);
 	if(o.procBatch) a.push('--proc-batch-size='+o.procBatch);
 	if(o.recBufs) a.push('--recovery-buffers='+o.recBufs);
+	if(o.method) a.push('--method='+o.method);
+	if(o.cpuMinChunk) a.push('--cpu-minchunk='+o.cpuMinChunk);
+	if(o.oclMinChunk) a.push('--opencl-minchunk='+o.oclMinChunk);
+	if(o.oclProcess) a.push('--opencl-process='+o.oclProcess);
+	if(o.oclMethod) a.push('--opencl-method='+o.oclMethod);
+	if(o.oclMaxAlloc) a.push('--opencl-max-alloc='+o.oclMaxAlloc);
+	if(o.oclRecovery) a.push('--opencl-recovery='+o.oclRecovery);
+	if(o.oclZeroCopy) a.push('--opencl-zero-copy');
+	if(o.oclTune) a.push('--opencl-tune='+o.oclTune);
+	if(o.oclCache) a.push('--opencl-cache='+o.oclCache);
 	
 	return a.concat(['-o', o.out], o.in);
 }
@@ -537,6 +547,27 @@ var allTests = [
 		cacheKey: '19'
 	},
 	
+	{ // staging areas (2*6*16M) larger than most LLCs, to use the non-temporal prepare path if supported
+		in: [tmpDir + 'test2200m.bin'],
+		blockSize: 16*1048576,
+		blocks: 4,
+		procBatch: 6,
+		readSize: '16M',
+		memory: 1024*1048576,
+		singleFile: true,
+		cacheKey: '24'
+	},
+	{ // recovery (8*16M) larger than most LLCs, to use the non-temporal finish path if supported
+		in: [tmpDir + 'test2200m.bin'],
+		blockSize: 16*1048576,
+		blocks: 8,
+		procBatch: 1,
+		readSize: '16M',
+		memory: 1024*1048576,
+		singleFile: true,
+		cacheKey: '25'
+	},
+	
 ];
 if(is64bPlatform) {
 	allTests.push({ // recovery > 4GB in memory [https://github.com/animetosho/par2cmdline-turbo/issues/7]
@@ -550,6 +581,82 @@ if(is64bPlatform) {
 	});
 }
 
+// the default method is usually the only one exercised above, so re-run a few tests with each method that wouldn't otherwise be picked
+// output doesn't depend on the method, so these share the reference of the test they're based on
+var gfMethods = require('../lib/par2.js').gf_methods();
+var methodTests = [];
+var addMethodTests = function(methods, testKeys) {
+	methods.forEach(function(method) {
+		if(gfMethods.indexOf(method) < 0)
+			return console.log('Skipping tests for method ' + method + ': not supported on this CPU');
+		allTests.forEach(function(test) {
+			if(testKeys.indexOf(test.cacheKey) > -1)
+				methodTests.push(merge(test, {method: method}));
+		});
+	});
+};
+addMethodTests([
+	'clmul-avx2', 'clmul-avx512',
+	'shuffle2x-avx2-natural', 'shuffle2x-avx512-natural', 'affine2x-avx2-natural', 'affine2x-avx512-natural',
+	'xorjit-avx',
+	'lookup', 'lookup-fat',
+	'shuffle-vec'
+], ['0', '3', '7']);
+// methods with non-temporal paths only use them when the data exceeds the LLC
+addMethodTests(['shuffle-avx512', 'shuffle-vbmi', 'affine-avx512'], ['24', '25']);
+allTests = allTests.concat(methodTests);
+
+// OpenCL tests need a runtime with at least one device (pocl is sufficient); as above, these share the reference of the CPU-only test
+var oclDeviceCount = 0;
+try {
+	require('../lib/par2.js').opencl_devices().forEach(function(platform) {
+		oclDeviceCount += platform.devices.length;
+	});
+} catch(x) {}
+var oclTests = [];
+var addOclTests = function(configs, testKeys) {
+	configs.forEach(function(config) {
+		allTests.forEach(function(test) {
+			// some slices are smaller than the default minimum chunk sizes, which would leave the whole slice to the CPU
+			if(!test.method && testKeys.indexOf(test.cacheKey) > -1)
+				oclTests.push(merge(test, {cpuMinChunk: '2K', oclMinChunk: '2K'}, config));
+		});
+	});
+};
+if(oclDeviceCount) {
+	addOclTests([
+		{oclProcess: '50%'},
+		{oclProcess: '100%'},
+		{oclProcess: '50%', oclZeroCopy: true} // only differs from the default on unified memory devices
+	], ['3', '7']);
+	// limit allocations so that the recovery slices must be split across multiple buffers
+	addOclTests([
+		{oclProcess: '50%', oclMaxAlloc: '128K'},
+		{oclProcess: '50%', oclMaxAlloc: '128K', oclZeroCopy: true}
+	], ['7']);
+	// the device and CPU are given the same range, each input going to whichever is free
+	addOclTests([
+		{oclProcess: 'dynamic'}
+	], ['3', '7']);
+	// the device computes the first recovery slices across the whole slice, the CPU the rest; test 3 computes fewer than this
+	addOclTests([
+		{oclRecovery: 50}
+	], ['3', '7']);
+	// tune the device, then run again with the parameters remembered in the cache directory
+	addOclTests([
+		{oclProcess: '50%', oclTune: 'force', oclCache: tmpDir + 'ocltune'},
+		{oclProcess: '50%', oclTune: 'true', oclCache: tmpDir + 'ocltune'}
+	], ['7']);
+	// the default method is picked by the device, so exercise the wide and async kernel variants explicitly
+	addOclTests([
+		'lookup_wide', 'lookup_half_wide', 'lookup_async', 'lookup_half_async', 'log_wide', 'log_async'
+	].map(function(method) {
+		return {oclProcess: '50%', oclMethod: method};
+	}), ['3', '7']);
+} else
+	console.log('Skipping OpenCL tests: no OpenCL devices found');
+allTests = allTests.concat(oclTests);
+
 
 async.timesSeries(allTests.length, function(testNum, cb) {
 	var test = allTests[testNum];